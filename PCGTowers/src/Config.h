@@ -18,9 +18,49 @@ static constexpr float g_kMaxPrecipitation = 400.0f;
 
 static constexpr size_t g_kWavesPerRound = 5;
 
+/// <summary>
+/// The simulation always advances in steps of this size, Which keeps it deterministic regardless of the frame rate.
+/// </summary>
+static constexpr float g_kFixedTimeStep = 1.0f / 60.0f;
+
+/// <summary>
+/// Longest frame the simulation will catch up on, Prevents spiraling after a long stall.
+/// </summary>
+static constexpr float g_kMaxFrameTime = 0.25f;
+
 static constexpr int g_kMaxTries = 25;
 static constexpr int g_kMinDistanceOfSpawner = 16;
 
+/// <summary>
+/// Times the river cellular automaton is applied after the terrain is generated.
+/// </summary>
+static constexpr size_t g_kRiverGrowthIterations = 3;
+
+/// <summary>
+/// Maps at least this wide or high are pathed through a PathHierarchy, Smaller maps search every tile.
+/// </summary>
+static constexpr unsigned int g_kPathHierarchyMinMapSize = 128;
+
+/// <summary>
+/// Path searches a large map gets before its PathHierarchy is built, Building one for the largest maps costs about this many tile searches.
+/// </summary>
+static constexpr size_t g_kPathHierarchyMinSearches = 256;
+
+/// <summary>
+/// Width and height in tiles of the sectors of a PathHierarchy.
+/// </summary>
+static constexpr int g_kPathSectorSize = 16;
+
+/// <summary>
+/// Tiles of a sector border that share one entrance, The cheapest crossing among them.
+/// </summary>
+static constexpr int g_kPathEntranceWidth = 8;
+
+/// <summary>
+/// Extra cost of walking onto a tile with a turret in mazing mode, A normal tile costs between 100 and 200.
+/// </summary>
+static constexpr float g_kMazingTurretCost = 4000.0f;
+
 /// <summary>
 /// Cost of buying a new turret.
 /// </summary>
@@ -83,4 +123,14 @@ static constexpr float g_kStarterGold[]
 	200.0f,		// Easy
 	150.0f,		// Normal
 	100.0f		// Hard
+};
+
+/// <summary>
+/// Health of the base at the start of every round for difficulty, Enemies that reach it take their damage off.
+/// </summary>
+static constexpr float g_kBaseHealth[]
+{
+	50.0f,		// Easy
+	30.0f,		// Normal
+	20.0f		// Hard
 };
\ No newline at end of file
@@ -0,0 +1,181 @@
+#include "GreedyBot.h"
+
+#include <Config.h>
+
+#include <Game/TowerDefense/World.h>
+#include <Game/TowerDefense/Turret.h>
+#include <Game/Rounds/Round.h>
+#include <Game/Replay/PlayerAction.h>
+
+#include <Utility/Profiler.h>
+
+#include <EASTL/algorithm.h>
+
+/// <summary>
+/// Damage an upgrade adds per upgrade level, As a fraction of the damage. (See Turret::Upgrade)
+/// </summary>
+static constexpr float g_kUpgradeDamageGain = 0.15f;
+
+/// <summary>
+/// Path covered per gold by upgrading [turret] on a tile with [score].
+/// </summary>
+static float GetUpgradeValue(const Turret& turret, uint32_t score)
+{
+	return (float)score * g_kUpgradeDamageGain * (float)(turret.GetUpgradeLevel() + 1) / turret.GetUpgradeCost();
+}
+
+GreedyBot::GreedyBot(uint32_t tileBudget, uint32_t actionBudget)
+	: m_tileBudget(eastl::max(1u, tileBudget))
+	, m_actionBudget(actionBudget)
+	, m_roundCount(0)
+	, m_tick(0)
+{
+	Restart();
+}
+
+void GreedyBot::Tick(World& world)
+{
+	PCG_PROFILE_ZONE("GreedyBot::Tick");
+
+	// The map changed, Or the bot moved on to a new world.
+	if (world.GetRoundCount() != m_roundCount || world.GetTick() < m_tick)
+	{
+		Restart();
+		m_roundCount = world.GetRoundCount();
+	}
+	m_tick = world.GetTick();
+
+	const Round* pRound = world.GetCurrentRound();
+	if (pRound && pRound->IsPaused())
+		world.ApplyAction(PlayerAction(PlayerActionType::kTogglePause, 0));
+
+	Scan(world);
+
+	for (uint32_t action = 0; action < m_actionBudget && Act(world); ++action)
+		;
+}
+
+void GreedyBot::Restart()
+{
+	m_nextTile = 0;
+	m_scanBuyTile = kNoTile;
+	m_scanBuyScore = 0;
+	m_scanUpgradeTile = kNoTile;
+	m_scanUpgradeValue = 0.0f;
+	m_scanSellTile = kNoTile;
+
+	m_buyTile = kNoTile;
+	m_upgradeTile = kNoTile;
+	m_sellTile = kNoTile;
+}
+
+void GreedyBot::Scan(const World& world)
+{
+	const PlacementScorer& scorer = world.GetPlacementScorer();
+	const auto& turrets = world.GetTurrets();
+
+	const dragon::Vector2u kMapSize = world.GetTilemap().GetSize();
+	const size_t kTileCount = (size_t)kMapSize.x * kMapSize.y;
+	const size_t kLast = eastl::min(m_nextTile + m_tileBudget, kTileCount);
+
+	// Lowest tile wins ties, Keeps the choice independent of the order the turrets are stored in.
+	for (size_t tile = m_nextTile; tile < kLast; ++tile)
+	{
+		uint32_t score = scorer.GetScore(tile);
+
+		auto result = turrets.find(tile);
+		if (result == turrets.end())
+		{
+			if (score > m_scanBuyScore)
+			{
+				m_scanBuyTile = tile;
+				m_scanBuyScore = score;
+			}
+		}
+		else if (score == 0)
+		{
+			if (m_scanSellTile == kNoTile)
+				m_scanSellTile = tile;
+		}
+		else
+		{
+			float value = GetUpgradeValue(*result->second, score);
+			if (value > m_scanUpgradeValue)
+			{
+				m_scanUpgradeTile = tile;
+				m_scanUpgradeValue = value;
+			}
+		}
+	}
+
+	m_nextTile = kLast;
+	if (m_nextTile < kTileCount)
+		return;
+
+	// Looked at every tile, Act on these until the next scan completes.
+	m_buyTile = m_scanBuyTile;
+	m_upgradeTile = m_scanUpgradeTile;
+	m_sellTile = m_scanSellTile;
+
+	m_nextTile = 0;
+	m_scanBuyTile = kNoTile;
+	m_scanBuyScore = 0;
+	m_scanUpgradeTile = kNoTile;
+	m_scanUpgradeValue = 0.0f;
+	m_scanSellTile = kNoTile;
+}
+
+bool GreedyBot::Act(World& world)
+{
+	const PlacementScorer& scorer = world.GetPlacementScorer();
+	const auto& turrets = world.GetTurrets();
+
+	// Turrets that cover nothing are only worth their resale value, The paths moved away or the tile stopped being buildable.
+	if (m_sellTile != kNoTile)
+	{
+		size_t tile = m_sellTile;
+		m_sellTile = kNoTile;
+
+		if (turrets.find(tile) != turrets.end() && scorer.GetScore(tile) == 0)
+		{
+			world.ApplyAction(PlayerAction(PlayerActionType::kSellTurret, (uint32_t)tile));
+			return true;
+		}
+	}
+
+	// The tiles might have changed since the scan.
+	float buyValue = 0.0f;
+	if (m_buyTile != kNoTile && turrets.find(m_buyTile) == turrets.end())
+		buyValue = (float)scorer.GetScore(m_buyTile) / g_kTurretCost;
+
+	float upgradeValue = 0.0f;
+	float upgradeCost = 0.0f;
+	if (m_upgradeTile != kNoTile)
+	{
+		if (auto result = turrets.find(m_upgradeTile); result != turrets.end())
+		{
+			upgradeValue = GetUpgradeValue(*result->second, scorer.GetScore(m_upgradeTile));
+			upgradeCost = result->second->GetUpgradeCost();
+		}
+	}
+
+	if (buyValue <= 0.0f && upgradeValue <= 0.0f)
+		return false;
+
+	// Saves up for the better of the two rather than spending on the other.
+	if (buyValue >= upgradeValue)
+	{
+		if (world.GetPlayerGold() < g_kTurretCost)
+			return false;
+
+		world.ApplyAction(PlayerAction(PlayerActionType::kBuyTurret, (uint32_t)m_buyTile));
+		m_buyTile = kNoTile;
+		return true;
+	}
+
+	if (world.GetPlayerGold() < upgradeCost)
+		return false;
+
+	world.ApplyAction(PlayerAction(PlayerActionType::kUpgradeTurret, (uint32_t)m_upgradeTile));
+	return true;
+}
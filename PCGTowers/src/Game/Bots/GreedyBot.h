@@ -0,0 +1,65 @@
+#pragma once
+
+#include <Game/Bots/PlayerBot.h>
+
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// Spends its gold on whatever covers the most path per gold right now, A new turret on the best free tile or an upgrade of the best placed turret.
+/// Sells turrets that no longer cover any path, And starts every round as soon as it can.
+/// The work per tick is capped by a budget of tiles to look at rather than by time, So a seed plays out the same on any machine.
+/// </summary>
+class GreedyBot : public PlayerBot
+{
+	static constexpr size_t kNoTile = ~(size_t)0;
+
+	/// <summary>
+	/// Tiles looked at per tick, A full look over the map is spread over several ticks.
+	/// </summary>
+	uint32_t m_tileBudget;
+
+	/// <summary>
+	/// Most actions per tick.
+	/// </summary>
+	uint32_t m_actionBudget;
+
+	// Scan in progress
+	size_t m_nextTile;
+	size_t m_scanBuyTile;
+	uint32_t m_scanBuyScore;
+	size_t m_scanUpgradeTile;
+	float m_scanUpgradeValue;
+	size_t m_scanSellTile;
+
+	// Results of the last full scan
+	size_t m_buyTile;
+	size_t m_upgradeTile;
+	size_t m_sellTile;
+
+	/// <summary>
+	/// Round and tick of the last call, A new round or world invalidates the scan.
+	/// </summary>
+	unsigned int m_roundCount;
+	uint32_t m_tick;
+
+public:
+
+	GreedyBot(uint32_t tileBudget = 256, uint32_t actionBudget = 1);
+
+	virtual void Tick(class World& world) override;
+
+private:
+
+	void Restart();
+
+	/// <summary>
+	/// Looks at the next [m_tileBudget] tiles, Publishes the best tiles once every tile was looked at.
+	/// </summary>
+	void Scan(const class World& world);
+
+	/// <summary>
+	/// Applies the best action it can afford, False if there was none or it is saving up.
+	/// </summary>
+	bool Act(class World& world);
+};
@@ -0,0 +1,17 @@
+#pragma once
+
+/// <summary>
+/// Plays the game in place of a player, Plugged into a world with World::SetBot.
+/// Bots act through World::ApplyAction only, So the journal replays their games without them.
+/// </summary>
+class PlayerBot
+{
+public:
+
+	virtual ~PlayerBot() = default;
+
+	/// <summary>
+	/// Called at the start of every tick, Before the world simulates it.
+	/// </summary>
+	virtual void Tick(class World& world) = 0;
+};
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <Dragon/Generic/Random.h>
+
+#include <type_traits>
+
+/// <summary>
+/// Independent streams of random numbers, One for every subsystem that needs randomness.
+/// </summary>
+enum struct RandomStream : unsigned int
+{
+	kWorld,			// Seeds of new worlds.
+	kRoundGraph,	// Depth of the round graph.
+	kRoundData,		// Seed, temperature and precipitation of each round.
+	kMapDensity,	// Dense terrain roll for every tile.
+	kMapBase,		// Base position search.
+	kMapSpawner,	// Spawner location roll for every tile.
+	kWaveGroup,		// Stats seeds of the enemy groups.
+	kGrammar,		// Rule picks of the wave grammar.
+
+	kCount
+};
+
+/// <summary>
+/// Counter based random built on SquirrelNoise.
+/// Every draw is a pure function of (seed, stream, index), So draws never depend on what was drawn before by
+/// another subsystem or thread. Which allows generation to run in parallel or out of order with identical results.
+/// </summary>
+class CounterRandom
+{
+	/// <summary>
+	/// Seed of the stream, Derived from the user seed and the stream.
+	/// </summary>
+	unsigned int m_streamSeed;
+
+	/// <summary>
+	/// Index of the next draw.
+	/// </summary>
+	unsigned int m_index;
+
+public:
+
+	CounterRandom()
+		: CounterRandom(0, RandomStream::kWorld)
+	{}
+
+	CounterRandom(unsigned int seed, RandomStream stream)
+		: m_streamSeed(GetStreamSeed(seed, stream))
+		, m_index(0)
+	{}
+
+	static unsigned int GetStreamSeed(unsigned int seed, RandomStream stream)
+	{
+		return dragon::SquirrelNoise::Get1DNoise((int)stream, seed);
+	}
+
+	/// <summary>
+	/// Draws the [index]th number of [stream] without any state.
+	/// </summary>
+	static unsigned int Draw(unsigned int seed, RandomStream stream, unsigned int index)
+	{
+		return dragon::SquirrelNoise::Get1DNoise((int)index, GetStreamSeed(seed, stream));
+	}
+
+	/// <summary>
+	/// Draws the [index]th number of [stream] as a float between [0.0f, 1.0f)
+	/// </summary>
+	static float DrawUniform(unsigned int seed, RandomStream stream, unsigned int index)
+	{
+		return ToUniform(Draw(seed, stream, index));
+	}
+
+	/// <summary>
+	/// Maps the upper 24 bits to [0.0f, 1.0f), Which is exactly representable as a float.
+	/// </summary>
+	static float ToUniform(unsigned int bits)
+	{
+		return (float)(bits >> 8) * (1.0f / 16777216.0f);
+	}
+
+	void Seed(unsigned int seed, RandomStream stream)
+	{
+		m_streamSeed = GetStreamSeed(seed, stream);
+		m_index = 0;
+	}
+
+	unsigned int Next() { return dragon::SquirrelNoise::Get1DNoise((int)m_index++, m_streamSeed); }
+
+	template<typename Type>
+	Type Random() { return (Type)Next(); }
+
+	float RandomUniform() { return ToUniform(Next()); }
+
+	/// <summary>
+	/// Random number in range [min, max)
+	/// </summary>
+	template<typename Type>
+	Type RandomRange(Type min, Type max)
+	{
+		if constexpr (std::is_floating_point_v<Type>)
+		{
+			return min + (max - min) * (Type)RandomUniform();
+		}
+		else
+		{
+			if (max <= min)
+				return min;
+
+			unsigned long long span = (unsigned long long)(max - min);
+			return min + (Type)(((unsigned long long)Next() * span) >> 32);
+		}
+	}
+
+	/// <summary>
+	/// Random index in range [0, count)
+	/// </summary>
+	size_t RandomIndex(size_t count) { return RandomRange<size_t>(0, count); }
+
+	/// <summary>
+	/// Seeds a stateful random from this stream, For API's that require a dragon::Random.
+	/// </summary>
+	void SeedRandom(dragon::Random& random) { random.Seed(Next()); }
+
+	//
+	// State, Two integers is all it takes to continue a stream.
+	//
+
+	unsigned int GetStreamSeed() const { return m_streamSeed; }
+	unsigned int GetIndex() const { return m_index; }
+
+	void SetState(unsigned int streamSeed, unsigned int index)
+	{
+		m_streamSeed = streamSeed;
+		m_index = index;
+	}
+};
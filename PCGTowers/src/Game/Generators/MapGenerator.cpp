@@ -2,14 +2,31 @@
 
 #include <Config.h>
 
+#include <Utility/Profiler.h>
+
 #include <EASTL/set.h>
 #include <EASTL/unordered_set.h>
 #include <EASTL/unordered_map.h>
+#include <EASTL/algorithm.h>
+#include <EASTL/heap.h>
+#include <EASTL/sort.h>
 
 #include <Dragon/Graphics/RenderTarget.h>
 #include <SFML/Graphics.hpp>
 #include <Platform/SFML/SfmlHelpers.h>
 
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define PCG_SSE2 1
+	#include <emmintrin.h>
+#else
+	#define PCG_SSE2 0
+#endif
+
 /// <summary>
 /// Terrain, 
 /// Dense Terrain(Pathing noise ? )
@@ -32,83 +49,82 @@
 	kSavannah = 0x96A527FF,
 	kDesert = 0xC87137FF,
 */
-const eastl::unordered_map<BiomeType, MapGenerator::BiomeInfo> MapGenerator::s_kBiomeInfo = 
-{
-	{ BiomeType::kTundra, { 1 } },
-	{ BiomeType::kTaiga, { 1 } },
-	{ BiomeType::kWoodland, { 0 } },
-	{ BiomeType::kGrassland, { 0 } },
-	{ BiomeType::kSeasonalForest, { 0 } },
-	{ BiomeType::kRainForestTemperate, { 0 } },
-	{ BiomeType::kRainForestTropical, { 0 } },
-	{ BiomeType::kSavannah, { 2 } },
-	{ BiomeType::kDesert, { 2 } },
+const MapGenerator::BiomeInfo MapGenerator::s_kBiomeInfo[] =
+{
+	{ BiomeType::kTundra, 1 },
+	{ BiomeType::kTaiga, 1 },
+	{ BiomeType::kWoodland, 0 },
+	{ BiomeType::kGrassland, 0 },
+	{ BiomeType::kSeasonalForest, 0 },
+	{ BiomeType::kRainForestTemperate, 0 },
+	{ BiomeType::kRainForestTropical, 0 },
+	{ BiomeType::kSavannah, 2 },
+	{ BiomeType::kDesert, 2 },
 };
 
-void MapGenerator::Generate(TDTilemap& tilemap, unsigned int seed)
+const MapGenerator::BiomeInfo* MapGenerator::FindBiomeInfo(BiomeType biome)
+{
+	// Only a handful of biomes, A linear search beats a map.
+	for (const BiomeInfo& info : s_kBiomeInfo)
+	{
+		if (info.biome == biome)
+			return &info;
+	}
+
+	return nullptr;
+}
+
+void MapGenerator::Seed(unsigned int seed)
 {
 	// Seed the randomizer and perlin noise.
 	m_perlinNoise.Seed(seed);
-	m_random.Seed(seed);
+	m_seed = seed;
+}
 
-	dragon::Vector2u size = tilemap.GetSize();
+void MapGenerator::Generate(TDTilemap& tilemap, unsigned int seed)
+{
+	PCG_PROFILE_ZONE("MapGenerator::Generate");
 
-	BiomeType biome = GetBiomeType(m_temperature, m_precipitation);
+	Seed(seed);
 
-	auto calculateBiomeDensity = [](float temp, float precip) -> float
-	{
-		temp /= g_kMaxTemperature;
-		precip /= g_kMaxPrecipitation;
+	dragon::Vector2u size = tilemap.GetSize();
 
-		float temperatureVal = std::sin(temp * 3.14f) * temp;
-		float precipitationVal = std::sin(precip * 3.14f / 2.0f);
-		return precipitationVal * 1.5f * temperatureVal;
-	};
+	float biomeDensity = GetBiomeDensity();
 
-	float biomeDensity = calculateBiomeDensity(m_temperature, m_precipitation);
+	// Climate of the current row, Classified into biomes in one go once the whole row is known.
+	eastl::vector<TileClimate> rowClimate(size.x);
+	eastl::vector<float> rowTemperature(size.x);
+	eastl::vector<float> rowPrecipitation(size.x);
+	eastl::vector<uint8_t> rowBiomes(size.x);
 
-	// Generate noise for tilemap.
-	for (unsigned int x = 0; x < size.x; ++x)
+	// Generate noise for tilemap, Row by row.
+	for (unsigned int y = 0; y < size.y; ++y)
 	{
-		for (unsigned int y = 0; y < size.y; ++y)
+		for (unsigned int x = 0; x < size.x; ++x)
 		{
-			auto& tileData = tilemap.GetTileData(x, y);
-			tileData.m_isTurretPlaceable = true; // Reset Placeable status.
+			rowClimate[x] = SampleClimate(x, y, size);
+			rowTemperature[x] = rowClimate[x].temperature;
+			rowPrecipitation[x] = rowClimate[x].precipitation;
+		}
 
-			// Height Noise [0.0f, 1.0f]
-			float noise = m_perlinNoise.AverageNoise((float)x / (float)size.x, (float)y / (float)size.y, m_zoom, m_octaves, m_persistance, seed);
+		ClassifyBiomes(rowTemperature.data(), rowPrecipitation.data(), size.x, rowBiomes.data());
 
-			// Temperature Noise
-			float tileTemperature = m_perlinNoise.AverageNoise((float)x / (float)size.x, (float)y / (float)size.y, m_zoom * 2.0f, 1, 0.5f, seed);
-			tileTemperature *= m_temperature;
-			tileData.m_temperature = tileTemperature;
+		for (unsigned int x = 0; x < size.x; ++x)
+		{
+			auto& tileData = tilemap.GetTileData(x, y);
+			const TileClimate& climate = rowClimate[x];
 
-			// Precipitation Noise
-			float tileMoisture = m_perlinNoise.AverageNoise((float)x / (float)size.x, (float)y / (float)size.y, 4.0f, 4, 0.4f, seed);
-			float tilePrecipitation = tileMoisture;
-			tilePrecipitation *= m_precipitation;
-			tileData.m_moistureLevel = tilePrecipitation;
+			uint8_t paletteIndex = rowBiomes[x];
+			size_t theme = m_biomePaletteThemes[paletteIndex];
 
-			if (m_random.RandomUniform() < biomeDensity * noise)
-			{
-				tilemap.SetTile(x, y, GetBiomeTile(biome, MapTile::kDense));
-				tileData.m_isTurretPlaceable = false;
-			}
-			else
-			{
-				float totalMoisture = std::abs(std::sin(tilePrecipitation * 3.14f / 2.0f) * tileMoisture);
-				if (totalMoisture > .3f && totalMoisture < .5f)
-					tilemap.SetTile(x, y, GetBiomeTile(biome, MapTile::kMoist));
-				else if (totalMoisture > .7f)
-				{
-					tilemap.SetTile(x, y, GetBiomeTile(biome, MapTile::kVeryMoist));
-					tileData.m_isTurretPlaceable = false;
-				}
-				else
-					tilemap.SetTile(x, y, GetBiomeTile(biome, MapTile::kPlain));
-			}
+			tileData.m_temperature = climate.temperature;
+			tileData.m_moistureLevel = climate.precipitation;
+			tileData.m_biome = m_biomePalette[paletteIndex];
+
+			tilemap.SetTile(x, y, ClassifyTerrain(theme, climate, y * size.x + x, biomeDensity, tileData.m_isTurretPlaceable));
 
 			// Calculate noise for pathing.
+			float noise = climate.noise;
 			noise = dragon::math::SmootherStep(noise);
 			noise = dragon::math::SmootherStep(noise);
 			noise = dragon::math::SmootherStep(noise);
@@ -118,127 +134,378 @@ void MapGenerator::Generate(TDTilemap& tilemap, unsigned int seed)
 	}
 
 	GrowRivers(tilemap);
+
+	// The hierarchy costs hundreds of tile searches to build, GeneratePath builds it once the new map was searched that often.
+	m_pathHierarchy.Clear();
+	m_pathSearchCount = 0;
+}
+
+MapGenerator::TileClimate MapGenerator::SampleClimate(unsigned int x, unsigned int y, dragon::Vector2u size)
+{
+	TileClimate climate;
+
+	// Height Noise [0.0f, 1.0f]
+	climate.noise = m_perlinNoise.AverageNoise((float)x / (float)size.x, (float)y / (float)size.y, m_zoom, m_octaves, m_persistance, m_seed);
+
+	// Temperature Noise
+	climate.temperature = m_perlinNoise.AverageNoise((float)x / (float)size.x, (float)y / (float)size.y, m_zoom * 2.0f, 1, 0.5f, m_seed);
+	climate.temperature *= m_temperature;
+
+	// Precipitation Noise
+	climate.moisture = m_perlinNoise.AverageNoise((float)x / (float)size.x, (float)y / (float)size.y, 4.0f, 4, 0.4f, m_seed);
+	climate.precipitation = climate.moisture;
+	climate.precipitation *= m_precipitation;
+
+	return climate;
+}
+
+float MapGenerator::GetBiomeDensity() const
+{
+	float temp = m_temperature / g_kMaxTemperature;
+	float precip = m_precipitation / g_kMaxPrecipitation;
+
+	float temperatureVal = std::sin(temp * 3.14f) * temp;
+	float precipitationVal = std::sin(precip * 3.14f / 2.0f);
+	return precipitationVal * 1.5f * temperatureVal;
+}
+
+dragon::TileID MapGenerator::ClassifyTerrain(size_t theme, const TileClimate& climate, unsigned int tileIndex, float biomeDensity, bool& isTurretPlaceable) const
+{
+	isTurretPlaceable = true; // Reset Placeable status.
+
+	// Every tile draws from its own index, Independent of the order tiles are visited in.
+	if (CounterRandom::DrawUniform(m_seed, RandomStream::kMapDensity, tileIndex) < biomeDensity * climate.noise)
+	{
+		isTurretPlaceable = false;
+		return GetThemeTile(theme, MapTile::kDense);
+	}
+
+	float totalMoisture = std::abs(std::sin(climate.precipitation * 3.14f / 2.0f) * climate.moisture);
+	if (totalMoisture > .3f && totalMoisture < .5f)
+		return GetThemeTile(theme, MapTile::kMoist);
+
+	if (totalMoisture > .7f)
+	{
+		isTurretPlaceable = false;
+		return GetThemeTile(theme, MapTile::kVeryMoist);
+	}
+
+	return GetThemeTile(theme, MapTile::kPlain);
 }
 
 bool MapGenerator::Init()
 {
-	return m_biomeLookup.loadFromFile("biome_data.png");
+	sf::Image biomeLookup;
+	if (!biomeLookup.loadFromFile("biome_data.png"))
+		return false;
+
+	// Bake the image into palette indices, There are only a handful of biomes so a byte per cell is plenty.
+	sf::Vector2u size = biomeLookup.getSize();
+	m_biomeTableSize = { size.x, size.y };
+	m_biomeTable.resize((size_t)size.x * (size_t)size.y);
+	m_biomePalette.clear();
+	m_biomePaletteThemes.clear();
+
+	for (unsigned int y = 0; y < size.y; ++y)
+	{
+		for (unsigned int x = 0; x < size.x; ++x)
+		{
+			// Image is stored top to bottom, The table bottom to top.
+			BiomeType biome = static_cast<BiomeType>(biomeLookup.getPixel(x, (size.y - 1) - y).toInteger());
+
+			auto it = eastl::find(m_biomePalette.begin(), m_biomePalette.end(), biome);
+			if (it == m_biomePalette.end())
+			{
+				assert(m_biomePalette.size() < 256);
+
+				size_t theme = 0;
+				if (const BiomeInfo* pInfo = FindBiomeInfo(biome))
+					theme = pInfo->themeIndex;
+
+				m_biomePalette.push_back(biome);
+				m_biomePaletteThemes.push_back((uint8_t)theme);
+				it = m_biomePalette.end() - 1;
+			}
+
+			m_biomeTable[(size_t)y * size.x + x] = (uint8_t)(it - m_biomePalette.begin());
+		}
+	}
+
+	return true;
 }
 
 void MapGenerator::SetBaseTile(TDTilemap& tilemap, dragon::Vector2 position)
 {
-	BiomeType biome = GetBiomeType(m_temperature, m_precipitation);
-	tilemap.SetTile(position.x, position.y, GetBiomeTile(biome, MapTile::kBase));
+	// Keep the theme of the tile the base is placed on.
+	size_t theme = (size_t)tilemap.GetTile(position.x, position.y) / (size_t)MapTile::kCount;
+	tilemap.SetTile(position.x, position.y, GetThemeTile(theme, MapTile::kBase));
 }
 
-BiomeType MapGenerator::GetBiomeType(float temp, float precip)
+size_t MapGenerator::GetBiomeTableIndex(float temp, float precip) const
 {
-
 	float x = temp / (float)(g_kMaxTemperature - g_kMinTemperature);
 	float y = precip / (float)(g_kMaxPrecipitation - g_kMinPrecipitation);
 
-	sf::Vector2u size = m_biomeLookup.getSize();
+	int xLookup = eastl::clamp((int)(x * m_biomeTableSize.x), 0, (int)m_biomeTableSize.x - 1);
+	int yLookup = eastl::clamp((int)(y * m_biomeTableSize.y), 0, (int)m_biomeTableSize.y - 1);
+
+	return (size_t)yLookup * m_biomeTableSize.x + (size_t)xLookup;
+}
+
+BiomeType MapGenerator::GetBiomeType(float temp, float precip) const
+{
+	if (m_biomeTable.empty())
+		return BiomeType::kUnknown;
+
+	return m_biomePalette[m_biomeTable[GetBiomeTableIndex(temp, precip)]];
+}
+
+void MapGenerator::ClassifyBiomes(const float* pTemperature, const float* pPrecipitation, size_t count, uint8_t* pPaletteIndices) const
+{
+	PCG_PROFILE_ZONE("MapGenerator::ClassifyBiomes");
+
+	// Unknown biome until Init has baked the table.
+	if (m_biomeTable.empty())
+	{
+		eastl::fill(pPaletteIndices, pPaletteIndices + count, (uint8_t)0);
+		return;
+	}
+
+	size_t i = 0;
 
-	unsigned int xLookup = (unsigned int)(x * size.x);
-	unsigned int yLookup = (unsigned int)(y * size.y);
+#if PCG_SSE2
+	// Same math as GetBiomeTableIndex, Clamped in float before truncating which yields the same cell.
+	const __m128 kTemperatureRange = _mm_set1_ps(g_kMaxTemperature - g_kMinTemperature);
+	const __m128 kPrecipitationRange = _mm_set1_ps(g_kMaxPrecipitation - g_kMinPrecipitation);
+	const __m128 kWidth = _mm_set1_ps((float)m_biomeTableSize.x);
+	const __m128 kHeight = _mm_set1_ps((float)m_biomeTableSize.y);
+	const __m128 kMaxX = _mm_set1_ps((float)(m_biomeTableSize.x - 1));
+	const __m128 kMaxY = _mm_set1_ps((float)(m_biomeTableSize.y - 1));
+	const __m128 kZero = _mm_setzero_ps();
 
-	sf::Color pixelColor = m_biomeLookup.getPixel(xLookup, (size.y - 1) - yLookup);
+	alignas(16) int32_t indices[4];
 
-	return static_cast<BiomeType>(pixelColor.toInteger());
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 x = _mm_mul_ps(_mm_div_ps(_mm_loadu_ps(pTemperature + i), kTemperatureRange), kWidth);
+		__m128 y = _mm_mul_ps(_mm_div_ps(_mm_loadu_ps(pPrecipitation + i), kPrecipitationRange), kHeight);
+
+		// Value first so NaN falls to zero.
+		x = _mm_min_ps(_mm_max_ps(x, kZero), kMaxX);
+		y = _mm_min_ps(_mm_max_ps(y, kZero), kMaxY);
+
+		// Row offset stays exact in float, The table is far smaller than 2^24 cells.
+		__m128i xLookup = _mm_cvttps_epi32(x);
+		__m128 row = _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvttps_epi32(y)), kWidth);
+		_mm_store_si128(reinterpret_cast<__m128i*>(indices), _mm_add_epi32(_mm_cvttps_epi32(row), xLookup));
+
+		// No byte gather in SSE2.
+		pPaletteIndices[i + 0] = m_biomeTable[indices[0]];
+		pPaletteIndices[i + 1] = m_biomeTable[indices[1]];
+		pPaletteIndices[i + 2] = m_biomeTable[indices[2]];
+		pPaletteIndices[i + 3] = m_biomeTable[indices[3]];
+	}
+#endif
+
+	for (; i < count; ++i)
+		pPaletteIndices[i] = m_biomeTable[GetBiomeTableIndex(pTemperature[i], pPrecipitation[i])];
 }
 
-void MapGenerator::FindBestBasePosition(const TDTilemap& tilemap, PossiblePositions& positions)
+dragon::Vector2 MapGenerator::SelectBasePosition(const TDTilemap& tilemap)
 {
-	size_t count = 0;
+	PCG_PROFILE_ZONE("MapGenerator::SelectBasePosition");
 
 	dragon::Vector2u mapSize = tilemap.GetSize();
 
+	CounterRandom random(m_seed, RandomStream::kMapBase);
+
 	// Draws an M on desmos.
 	auto coordWeight = [](float in) -> float
 	{
 		return (std::abs(std::sin(2.0f * 3.14f * in)) + 0.5f - 0.5f * std::abs(std::cos(3.14f * in))) / 1.164f;
 	};
 
-	// If we've reached max amount of tries, and we have atleast found one position.
-	while (count < g_kMaxTries || positions.size() == 0)
+	dragon::Vector2 bestPosition;
+	Candidate best = { -std::numeric_limits<float>::infinity(), std::numeric_limits<int>::max() };
+
+	// Keep the candidate with the highest key, The first candidate wins if none of them has any weight. So a base is always found.
+	for (int i = 0; i < g_kMaxTries; ++i)
 	{
-		int x = m_random.RandomRange<int>(0, (int)mapSize.x);
-		int y = m_random.RandomRange<int>(0, (int)mapSize.y);
+		int x = random.RandomRange<int>(0, (int)mapSize.x);
+		int y = random.RandomRange<int>(0, (int)mapSize.y);
+		float roll = random.RandomUniform();
 
 		float xWeight = coordWeight((float)x / (mapSize.x - 1));
 		float yWeight = coordWeight((float)y / (mapSize.y - 1));
 		float tileWeight = (xWeight + yWeight) / 2.0f;
 
-		tileWeight *= 0.8f; // 80% influence;
+		Candidate candidate = { tileWeight > 0.0f ? std::log(roll) / tileWeight : -std::numeric_limits<float>::infinity(), i };
+		if (IsBetterCandidate(candidate, best))
+		{
+			best = candidate;
+			bestPosition = { x, y };
+		}
+	}
 
-		// Makes sure that we always find a base.
-		tileWeight = (count > g_kMaxTries ? 1.0f : tileWeight);
+	return bestPosition;
+}
+
+void MapGenerator::SelectSpawnerLocations(const TDTilemap& tilemap, dragon::Vector2 position, size_t count, PossiblePositions& positions)
+{
+	PCG_PROFILE_ZONE("MapGenerator::SelectSpawnerLocations");
 
-		if (m_random.RandomUniform() > 1.0f - tileWeight)
+	// Rows a thread scores at least, Smaller maps are scored faster than threads start.
+	static constexpr unsigned int kMinRowsPerThread = 64;
+
+	positions.clear();
+
+	if (count == 0)
+		return;
+
+	const dragon::Vector2u kMapSize = tilemap.GetSize();
+	const unsigned int kThreadCount = eastl::max(eastl::min(GetThreadCount(), kMapSize.y / kMinRowsPerThread), 1u);
+
+	// Every thread keeps its own best candidates, The best of those are the best overall.
+	eastl::vector<eastl::vector<Candidate>> threadBest(kThreadCount);
+	eastl::vector<std::thread> threads;
+	threads.reserve(kThreadCount - 1);
+
+	unsigned int stride = kMapSize.y / kThreadCount;
+	unsigned int firstRow = 0;
+
+	for (unsigned int i = 0; i < kThreadCount - 1; ++i)
+	{
+		threads.emplace_back([this, &threadBest, kMapSize, position, count, firstRow, stride, i]()
 		{
-			positions.emplace_back(x, y);
-		}
+			PCG_PROFILE_THREAD("Spawner Worker");
+			SelectSpawnerRows(kMapSize, position, count, firstRow, firstRow + stride, threadBest[i]);
+		});
 
-		++count;
+		firstRow += stride;
 	}
+	SelectSpawnerRows(kMapSize, position, count, firstRow, kMapSize.y, threadBest.back());
+
+	for (std::thread& thread : threads)
+		thread.join();
+
+	eastl::vector<Candidate> candidates;
+	for (const eastl::vector<Candidate>& best : threadBest)
+		candidates.insert(candidates.end(), best.begin(), best.end());
+
+	// Ties are broken on the tile index, So the picks don't depend on how the rows were split.
+	eastl::sort(candidates.begin(), candidates.end(), IsBetterCandidate);
+
+	for (size_t i = 0; i < candidates.size() && i < count; ++i)
+		positions.emplace_back(tilemap.PositionFromIndex(candidates[i].tileIndex));
 }
 
-void MapGenerator::FindEnemySpawnerLocations(const TDTilemap& tilemap, dragon::Vector2 position, PossiblePositions& positions)
+bool MapGenerator::IsBetterCandidate(const Candidate& left, const Candidate& right)
 {
-	dragon::Vector2u mapSize = tilemap.GetSize();
+	if (left.key != right.key)
+		return left.key > right.key;
 
-	/// <summary>
-	/// Calculates the weight for the given tile.
-	/// </summary>
-	auto tileWeight = [position](size_t x, size_t y) -> float
-	{
-		dragon::Vector2 direction = position - dragon::Vector2((int)x, (int)y);
-		int distance = std::abs(direction.Length());
-		
-		float distanceValue = (float)dragon::math::Max(0, distance - g_kMinDistanceOfSpawner);
-		distanceValue /= (float)((int)g_kMapSize - g_kMinDistanceOfSpawner);
+	return left.tileIndex < right.tileIndex;
+}
 
-		return dragon::math::Sin(distanceValue * 2.3f);
-	};
+void MapGenerator::SelectSpawnerRows(dragon::Vector2u mapSize, dragon::Vector2 position, size_t count, unsigned int firstRow, unsigned int endRow, eastl::vector<Candidate>& best) const
+{
+	best.clear();
+	best.reserve(count);
 
-	// For every tile find a possible location.
-	for(size_t x = 0; x < mapSize.x; ++x)
+	eastl::vector<float> weights(mapSize.x);
+
+	for (unsigned int y = firstRow; y < endRow; ++y)
 	{
-		for (size_t y = 0; y < mapSize.y; ++y)
+		// Score the whole row first, Straight float math the compiler can vectorize.
+		float dy = (float)(position.y - (int)y);
+		for (unsigned int x = 0; x < mapSize.x; ++x)
+		{
+			float dx = (float)(position.x - (int)x);
+			float distance = (float)(int)std::sqrt(dx * dx + dy * dy);
+
+			float distanceValue = eastl::max(0.0f, distance - (float)g_kMinDistanceOfSpawner);
+			distanceValue /= (float)((int)g_kMapSize - g_kMinDistanceOfSpawner);
+
+			weights[x] = dragon::math::Sin(distanceValue * 2.3f);
+		}
+
+		for (unsigned int x = 0; x < mapSize.x; ++x)
 		{
+			// Never picked, Just like the roll could never beat a weight of zero.
+			if (weights[x] <= 0.0f)
+				continue;
 
-			float weight = tileWeight(x, y);
+			unsigned int tileIndex = y * mapSize.x + x;
+			float roll = CounterRandom::DrawUniform(m_seed, RandomStream::kMapSpawner, tileIndex);
 
-			if (m_random.RandomUniform() > 1.0f - weight)
+			Candidate candidate = { std::log(roll) / weights[x], (int)tileIndex };
+
+			if (best.size() < count)
 			{
-				positions.emplace_back(x, y);
+				best.push_back(candidate);
+				eastl::push_heap(best.begin(), best.end(), IsBetterCandidate);
+			}
+			else if (IsBetterCandidate(candidate, best.front()))
+			{
+				eastl::pop_heap(best.begin(), best.end(), IsBetterCandidate);
+				best.back() = candidate;
+				eastl::push_heap(best.begin(), best.end(), IsBetterCandidate);
 			}
-
 		}
 	}
 }
 
 Path MapGenerator::CarvePath(TDTilemap& tilemap, dragon::Vector2 from, dragon::Vector2 to)
 {
+	PCG_PROFILE_ZONE("MapGenerator::CarvePath");
+
 	int fromIndex = tilemap.IndexFromPosition(from);
 	int toIndex = tilemap.IndexFromPosition(to);
 
 	TilePath tilePath = GeneratePath(tilemap, fromIndex, toIndex);
 
-	BiomeType biome = GetBiomeType(m_temperature, m_precipitation);
+	TileRect dirty;
+	return CarveTilePath(tilemap, tilePath, dirty);
+}
+
+void MapGenerator::StampPath(TDTilemap& tilemap, const Path& path, TileRect& dirty)
+{
+	CarveTilePath(tilemap, ToTilePath(tilemap, path), dirty);
+}
 
+void MapGenerator::ClearPath(TDTilemap& tilemap, const Path& path, TileRect& dirty)
+{
+	for (int tileIndex : ToTilePath(tilemap, path))
+	{
+		if (RestoreTerrain(tilemap, tileIndex))
+			dirty.Merge(tilemap.PositionFromIndex(tileIndex));
+	}
+}
+
+Path MapGenerator::CarveTilePath(TDTilemap& tilemap, const TilePath& tilePath, TileRect& dirty)
+{
 	Path path;
 	path.reserve(tilePath.size());
 
 	for (int tileIndex : tilePath)
 	{
-		tilemap.GetTileDataAtIndex(tileIndex).m_isTurretPlaceable = false;
+		dragon::TileID tileId = tilemap.GetTileAtIndex(tileIndex);
+		dragon::Vector2 tilePos = tilemap.PositionFromIndex(tileIndex);
+
+		// The base is only placed once every path is carved, Paths carved afterwards must leave it be.
+		if ((MapTile)(tileId % (size_t)MapTile::kCount) != MapTile::kBase)
+		{
+			tilemap.GetTileDataAtIndex(tileIndex).m_isTurretPlaceable = false;
 
-		dragon::TileID tilePathId = GetPathTile(biome, tilemap.GetTileAtIndex(tileIndex));
-		tilemap.SetTileAtIndex(tileIndex, tilePathId);
+			dragon::TileID tilePathId = GetPathTile(tileId);
+			if (tilePathId != tileId)
+			{
+				tilemap.SetTileAtIndex(tileIndex, tilePathId);
+				dirty.Merge(tilePos);
+			}
+		}
 
 		// Find centroid of tile.
-		dragon::Vector2 tilePos = tilemap.PositionFromIndex(tileIndex);
 		dragon::Vector2f centroidPos =
 		{
 			(float)tilePos.x * g_kTileSize + (g_kTileSize / 2.0f),
@@ -251,8 +518,62 @@ Path MapGenerator::CarvePath(TDTilemap& tilemap, dragon::Vector2 from, dragon::V
 	return path;
 }
 
+bool MapGenerator::RestoreTerrain(TDTilemap& tilemap, int tileIndex)
+{
+	dragon::TileID tileId = tilemap.GetTileAtIndex(tileIndex);
+	MapTile tileType = (MapTile)(tileId % (size_t)MapTile::kCount);
+	size_t theme = (size_t)tileId / (size_t)MapTile::kCount;
+
+	TDTileData& tileData = tilemap.GetTileDataAtIndex(tileIndex);
+
+	if (tileType == MapTile::kPathVeryMoist)
+	{
+		// Generated and grown rivers look the same, Neither can hold a turret.
+		tilemap.SetTileAtIndex(tileIndex, GetThemeTile(theme, MapTile::kVeryMoist));
+		tileData.m_isTurretPlaceable = false;
+		return true;
+	}
+
+	if (tileType == MapTile::kPath)
+	{
+		// Rivers never turn into plain paths, So the tile was generated terrain.
+		dragon::Vector2 tilePos = tilemap.PositionFromIndex(tileIndex);
+		TileClimate climate = SampleClimate((unsigned int)tilePos.x, (unsigned int)tilePos.y, tilemap.GetSize());
+
+		tilemap.SetTileAtIndex(tileIndex, ClassifyTerrain(theme, climate, (unsigned int)tileIndex, GetBiomeDensity(), tileData.m_isTurretPlaceable));
+		return true;
+	}
+
+	return false;
+}
+
+TilePath MapGenerator::ToTilePath(const TDTilemap& tilemap, const Path& path)
+{
+	TilePath tilePath;
+	tilePath.reserve(path.size());
+
+	for (const dragon::Vector2f& centroid : path)
+		tilePath.emplace_back(tilemap.IndexFromPosition((int)(centroid.x / g_kTileSize), (int)(centroid.y / g_kTileSize)));
+
+	return tilePath;
+}
+
 TilePath MapGenerator::GeneratePath(const TDTilemap& tilemap, int from, int to)
 {
+	PCG_PROFILE_ZONE("MapGenerator::GeneratePath");
+
+	// Large maps search from sector to sector first, Once enough searches were made to pay for the sectors.
+	const dragon::Vector2u kMapSize = tilemap.GetSize();
+	if (kMapSize.x >= g_kPathHierarchyMinMapSize || kMapSize.y >= g_kPathHierarchyMinMapSize)
+	{
+		// The path weights never change after Generate, So the map can be split into sectors at any point.
+		if (!m_pathHierarchy.IsBuiltFor(tilemap) && ++m_pathSearchCount > g_kPathHierarchyMinSearches)
+			m_pathHierarchy.Build(tilemap);
+
+		if (m_pathHierarchy.IsBuiltFor(tilemap))
+			return m_pathHierarchy.FindPath(from, to);
+	}
+
 	// Note: EASTL has no constexpr infinity...
 	constexpr float kInf = std::numeric_limits<float>::infinity();
 
@@ -319,6 +640,9 @@ TilePath MapGenerator::GeneratePath(const TDTilemap& tilemap, int from, int to)
 				path.emplace_back(pNode->tileIndex);
 				pNode = pNode->pPrevious;
 			}
+
+			// Nodes are only ever opened once, Nothing left in the open set can change the path.
+			break;
 		}
 
 		// Find current node path score.
@@ -331,8 +655,7 @@ TilePath MapGenerator::GeneratePath(const TDTilemap& tilemap, int from, int to)
 			if (neighbor == dragon::kInvalidTile)
 				continue;
 
-			float edgeWeight = 2.0f - tilemap.GetTileDataAtIndex(neighbor).m_noise;
-			edgeWeight *= 100.0f;
+			float edgeWeight = GetTileWeight(tilemap.GetTileDataAtIndex(neighbor));
 
 			float newPathScore = pCurrentNode->local + edgeWeight;
 
@@ -389,13 +712,13 @@ float MapGenerator::GetDistanceToTile(const TDTilemap& tilemap, int from, int to
 	return (float)dragon::Vector2::DistanceSquared(posFrom, posTo);
 }
 
-dragon::TileID MapGenerator::GetPathTile(BiomeType biomeType, dragon::TileID tileId)
+dragon::TileID MapGenerator::GetPathTile(dragon::TileID tileId) const
 {
 	// Get base type of tile.
 	MapTile tileType = (MapTile)(tileId % (size_t)MapTile::kCount);
 
 	// Determine what type of path the tile must become.
-	if (tileType == MapTile::kVeryMoist)
+	if (tileType == MapTile::kVeryMoist || tileType == MapTile::kPathVeryMoist)
 	{
 		tileType = MapTile::kPathVeryMoist;
 	}
@@ -404,28 +727,120 @@ dragon::TileID MapGenerator::GetPathTile(BiomeType biomeType, dragon::TileID til
 		tileType = MapTile::kPath;
 	}
 
-	return GetBiomeTile(biomeType, tileType);
+	return GetThemeTile((size_t)tileId / (size_t)MapTile::kCount, tileType);
+}
+
+unsigned int MapGenerator::GetThreadCount() const
+{
+	// hardware_concurrency may not know, Which it reports as 0.
+	unsigned int threadCount = m_threadCount > 0 ? m_threadCount : std::thread::hardware_concurrency();
+	return eastl::max(threadCount, 1u);
 }
 
 void MapGenerator::GrowRivers(TDTilemap& tilemap)
 {
+	PCG_PROFILE_ZONE("MapGenerator::GrowRivers");
 
-	for (size_t i = 0; i < 3; ++i)
+	for (size_t i = 0; i < g_kRiverGrowthIterations; ++i)
 	{
 		GrowRiversIteration(tilemap);
 	}
 
 }
 
+TileRect MapGenerator::GrowRivers(TDTilemap& tilemap, const TileRect& region)
+{
+	PCG_PROFILE_ZONE("MapGenerator::GrowRivers");
+
+	const dragon::Vector2u kMapSize = tilemap.GetSize();
+	const int kIterations = (int)g_kRiverGrowthIterations;
+
+	// Rivers spread a tile per iteration, So tiles further from the region than that keep their rivers.
+	// Those tiles depend on the terrain as far out again, Errors along the edges of the area don't reach them.
+	const TileRect kRegrown = region.Expanded(kIterations).Clipped(kMapSize);
+	const TileRect kArea = kRegrown.Expanded(kIterations).Clipped(kMapSize);
+
+	TileRect changed;
+	if (kArea.IsEmpty())
+		return changed;
+
+	const size_t kWidth = (size_t)kArea.GetWidth();
+	const float kBiomeDensity = GetBiomeDensity();
+
+	// Start over from the terrain before any river grew, Growing on top of grown rivers would keep widening them.
+	eastl::vector<dragon::TileID> state(kArea.GetArea());
+	eastl::vector<dragon::TileID> newState(kArea.GetArea());
+	eastl::vector<uint8_t> placeable(kArea.GetArea());
+
+	for (int y = kArea.m_top; y < kArea.m_bottom; ++y)
+	{
+		for (int x = kArea.m_left; x < kArea.m_right; ++x)
+		{
+			const size_t kTile = (size_t)(y - kArea.m_top) * kWidth + (size_t)(x - kArea.m_left);
+			const unsigned int kTileIndex = (unsigned int)y * kMapSize.x + (unsigned int)x;
+
+			// Neither rivers nor paths change the theme of a tile.
+			size_t theme = (size_t)tilemap.GetTileAtIndex(kTileIndex) / (size_t)MapTile::kCount;
+			TileClimate climate = SampleClimate((unsigned int)x, (unsigned int)y, kMapSize);
+
+			bool isTurretPlaceable;
+			state[kTile] = ClassifyTerrain(theme, climate, kTileIndex, kBiomeDensity, isTurretPlaceable);
+			placeable[kTile] = isTurretPlaceable ? 1 : 0;
+		}
+	}
+
+	for (int i = 0; i < kIterations; ++i)
+	{
+		GrowRiversIteration(kArea, state.data(), newState.data());
+		state.swap(newState);
+	}
+
+	for (int y = kRegrown.m_top; y < kRegrown.m_bottom; ++y)
+	{
+		for (int x = kRegrown.m_left; x < kRegrown.m_right; ++x)
+		{
+			const size_t kTile = (size_t)(y - kArea.m_top) * kWidth + (size_t)(x - kArea.m_left);
+			const size_t kTileIndex = (size_t)y * kMapSize.x + (size_t)x;
+
+			dragon::TileID tileId = tilemap.GetTileAtIndex(kTileIndex);
+			MapTile tileType = (MapTile)(tileId % (size_t)MapTile::kCount);
+			TDTileData& tileData = tilemap.GetTileDataAtIndex(kTileIndex);
+
+			// Paths are carved after the rivers grew, So they are carved into the new terrain again.
+			dragon::TileID newTileId = state[kTile];
+			if (tileType == MapTile::kBase)
+			{
+				continue;
+			}
+			else if (IsPathTile(tileId))
+			{
+				newTileId = GetPathTile(newTileId);
+				tileData.m_isTurretPlaceable = false;
+			}
+			else
+			{
+				tileData.m_isTurretPlaceable = placeable[kTile] && !IsRiverTile(newTileId);
+			}
+
+			if (newTileId == tileId)
+				continue;
+
+			tilemap.SetTileAtIndex(kTileIndex, newTileId);
+			changed.Merge(dragon::Vector2(x, y));
+		}
+	}
+
+	return changed;
+}
+
 void MapGenerator::GrowRiversIteration(TDTilemap& tilemap)
 {
-	const size_t kThreadCount = std::thread::hardware_concurrency();
+	PCG_PROFILE_ZONE("MapGenerator::GrowRiversIteration");
+
+	const size_t kThreadCount = GetThreadCount();
 	const dragon::Vector2u kMapSize = tilemap.GetSize();
 	const size_t kTileCount = (size_t)kMapSize.x * (size_t)kMapSize.y;
 
-	BiomeType biome = GetBiomeType(m_temperature, m_precipitation);
-	dragon::TileID riverTile = GetBiomeTile(biome, MapTile::kVeryMoist);
-
 	// Spawn threads
 	std::thread* pThreads = new std::thread[kThreadCount];
 
@@ -439,12 +854,16 @@ void MapGenerator::GrowRiversIteration(TDTilemap& tilemap)
 
 	for (size_t i = 0; i < kThreadCount - 1; ++i)
 	{
-		pThreads[i] = std::thread(&MapGenerator::ApplyGrowRiversRule, this, std::cref(tilemap), riverTile, startIndex, endIndex, pNewState);
+		pThreads[i] = std::thread([this, &tilemap, startIndex, endIndex, pNewState]()
+		{
+			PCG_PROFILE_THREAD("River Worker");
+			ApplyGrowRiversRule(tilemap, startIndex, endIndex, pNewState);
+		});
 
 		startIndex += stride;
 		endIndex += stride;
 	}
-	ApplyGrowRiversRule(tilemap, riverTile, startIndex, kTileCount, pNewState);
+	ApplyGrowRiversRule(tilemap, startIndex, kTileCount, pNewState);
 
 	// Wait for threads to finish.
 	for (size_t i = 0; i < kThreadCount - 1; ++i)
@@ -459,7 +878,7 @@ void MapGenerator::GrowRiversIteration(TDTilemap& tilemap)
 		tilemap.SetTileAtIndex(i, pNewState[i]);
 		
 		// Recheck if the tile is now unplaceable.
-		if (pNewState[i] == riverTile)
+		if (IsRiverTile(pNewState[i]))
 		{
 			// Can no longer place turrets at this tile.
 			tilemap.GetTileDataAtIndex(i).m_isTurretPlaceable = false;
@@ -471,48 +890,103 @@ void MapGenerator::GrowRiversIteration(TDTilemap& tilemap)
 	delete[] pNewState;
 }
 
-void MapGenerator::ApplyGrowRiversRule(const dragon::Tilemap& tilemap, dragon::TileID riverTile, size_t start, size_t end, dragon::TileID* pNewState)
+void MapGenerator::GrowRiversIteration(const TileRect& area, const dragon::TileID* pState, dragon::TileID* pNewState) const
 {
-	auto mooreNeighborhood = [&tilemap](size_t index, dragon::TileID id) -> size_t
+	PCG_PROFILE_ZONE("MapGenerator::GrowRiversIteration");
+
+	const int kWidth = area.GetWidth();
+	const int kHeight = area.GetHeight();
+
+	auto isRiver = [pState, kWidth, kHeight](int x, int y)
+	{
+		return x >= 0 && y >= 0 && x < kWidth && y < kHeight && IsRiverTile(pState[y * kWidth + x]);
+	};
+
+	// Same rule as ApplyGrowRiversRule.
+	for (int y = 0; y < kHeight; ++y)
+	{
+		for (int x = 0; x < kWidth; ++x)
+		{
+			size_t count = 0;
+			for (int offsetY = -1; offsetY <= 1; ++offsetY)
+			{
+				for (int offsetX = -1; offsetX <= 1; ++offsetX)
+				{
+					if ((offsetX != 0 || offsetY != 0) && isRiver(x + offsetX, y + offsetY))
+						++count;
+				}
+			}
+
+			dragon::TileID tileId = pState[y * kWidth + x];
+			pNewState[y * kWidth + x] = count > 1 ? GetThemeTile((size_t)tileId / (size_t)MapTile::kCount, MapTile::kVeryMoist) : tileId;
+		}
+	}
+}
+
+void MapGenerator::ApplyGrowRiversRule(const dragon::Tilemap& tilemap, size_t start, size_t end, dragon::TileID* pNewState)
+{
+	PCG_PROFILE_ZONE("MapGenerator::ApplyGrowRiversRule");
+
+	// Rivers flow across biome borders, A neighbor of any theme counts.
+	auto mooreNeighborhood = [&tilemap](size_t index) -> size_t
 	{
 		dragon::Vector2 pos = tilemap.PositionFromIndex((int)index);
 
 		size_t count = 0;
-		if (tilemap.GetTile(pos.x - 1, pos.y - 1) == id) ++count;
-		if (tilemap.GetTile(pos.x, pos.y - 1) == id) ++count;
-		if (tilemap.GetTile(pos.x + 1, pos.y - 1) == id) ++count;
+		if (IsRiverTile(tilemap.GetTile(pos.x - 1, pos.y - 1))) ++count;
+		if (IsRiverTile(tilemap.GetTile(pos.x, pos.y - 1))) ++count;
+		if (IsRiverTile(tilemap.GetTile(pos.x + 1, pos.y - 1))) ++count;
 
-		if (tilemap.GetTile(pos.x - 1, pos.y) == id) ++count;
-		if (tilemap.GetTile(pos.x + 1, pos.y) == id) ++count;
+		if (IsRiverTile(tilemap.GetTile(pos.x - 1, pos.y))) ++count;
+		if (IsRiverTile(tilemap.GetTile(pos.x + 1, pos.y))) ++count;
 
-		if (tilemap.GetTile(pos.x - 1, pos.y + 1) == id) ++count;
-		if (tilemap.GetTile(pos.x, pos.y + 1) == id) ++count;
-		if (tilemap.GetTile(pos.x + 1, pos.y + 1) == id) ++count;
+		if (IsRiverTile(tilemap.GetTile(pos.x - 1, pos.y + 1))) ++count;
+		if (IsRiverTile(tilemap.GetTile(pos.x, pos.y + 1))) ++count;
+		if (IsRiverTile(tilemap.GetTile(pos.x + 1, pos.y + 1))) ++count;
 		return count;
 	};
 
 	for (size_t i = start; i < end; ++i)
 	{
-		// More than 0 tiles around then grow. 
-		if (mooreNeighborhood(i, riverTile) > 1)
+		dragon::TileID tileId = tilemap.GetTileAtIndex(i);
+
+		// More than 0 tiles around then grow, In the theme of this tile.
+		if (mooreNeighborhood(i) > 1)
 		{
-			pNewState[i] = riverTile;
+			pNewState[i] = GetThemeTile((size_t)tileId / (size_t)MapTile::kCount, MapTile::kVeryMoist);
 		}
 		else
 		{
-			pNewState[i] = tilemap.GetTileAtIndex(i);
+			pNewState[i] = tileId;
 		}
 	}
 }
 
-dragon::TileID MapGenerator::GetBiomeTile(BiomeType biomeType, MapTile tile)
+bool MapGenerator::IsPathTile(dragon::TileID tileId)
+{
+	if (tileId == dragon::kInvalidTile)
+		return false;
+
+	MapTile tileType = (MapTile)((size_t)tileId % (size_t)MapTile::kCount);
+	return tileType == MapTile::kPath || tileType == MapTile::kPathVeryMoist;
+}
+
+bool MapGenerator::IsRiverTile(dragon::TileID tileId)
+{
+	if (tileId == dragon::kInvalidTile)
+		return false;
+
+	return (MapTile)((size_t)tileId % (size_t)MapTile::kCount) == MapTile::kVeryMoist;
+}
+
+dragon::TileID MapGenerator::GetBiomeTile(BiomeType biomeType, MapTile tile) const
 {
 	size_t theme = 0;
 
-	if (auto it = s_kBiomeInfo.find(biomeType); it != s_kBiomeInfo.end())
+	if (const BiomeInfo* pInfo = FindBiomeInfo(biomeType))
 	{
-		theme = it->second.themeIndex;
+		theme = pInfo->themeIndex;
 	}
 
-	return (dragon::TileID)((size_t)MapTile::kCount * theme) + (size_t)tile;
+	return GetThemeTile(theme, tile);
 }
\ No newline at end of file
@@ -3,15 +3,19 @@
 #include <Game/Biome.h>
 #include <Game/TowerDefense/TDTilemap.h>
 #include <Game/Path.h>
+#include <Game/TileRect.h>
+#include <Game/Generators/CounterRandom.h>
+#include <Game/Generators/PathHierarchy.h>
 
 #include <Dragon/Generic/Random/Range.h>
 #include <Dragon/Generic/Random/PerlinNoise.h>
 #include <Dragon/Generic/Random.h>
 
 #include <EASTL/array.h>
+#include <EASTL/vector.h>
 #include <EASTL/unordered_map.h>
 
-#include <SFML/Graphics/Image.hpp>
+#include <cstdint>
 
 /// <summary>
 /// Generates tile information onto the tilemap.
@@ -19,7 +23,11 @@
 class MapGenerator
 {
 	dragon::PerlinNoise m_perlinNoise;
-	dragon::Random m_random;
+
+	/// <summary>
+	/// Seed of the map that is being generated, All random draws are made from counter based streams of this seed.
+	/// </summary>
+	unsigned int m_seed;
 
 	// Temperature Info
 	float m_temperature;
@@ -30,7 +38,35 @@ class MapGenerator
 	float m_persistance;
 	int m_octaves;
 
-	sf::Image m_biomeLookup;
+	/// <summary>
+	/// Most threads a map is generated on, 0 uses every core.
+	/// </summary>
+	unsigned int m_threadCount;
+
+	//
+	// Biome Lookup, Baked from biome_data.png by Init.
+	//
+
+	/// <summary>
+	/// Palette index per cell of the lookup image, Rows are stored bottom to top (precipitation increases with y).
+	/// </summary>
+	eastl::vector<uint8_t> m_biomeTable;
+	dragon::Vector2u m_biomeTableSize;
+
+	/// <summary>
+	/// Distinct biomes found in the lookup image and their tile theme, Index 0 is unknown until Init has run.
+	/// </summary>
+	eastl::vector<BiomeType> m_biomePalette;
+	eastl::vector<uint8_t> m_biomePaletteThemes;
+
+protected:
+
+	/// <summary>
+	/// Sectors of the last generated map, Only built for maps of at least g_kPathHierarchyMinMapSize.
+	/// Built by GeneratePath once the map was searched [g_kPathHierarchyMinSearches] times, The few paths of a round search the tiles faster.
+	/// </summary>
+	PathHierarchy m_pathHierarchy;
+	size_t m_pathSearchCount;
 	
 public:
 
@@ -52,50 +88,90 @@ public:
 
 	struct BiomeInfo
 	{
+		BiomeType biome;
 		size_t themeIndex;
 	};
 
-	static const eastl::unordered_map<BiomeType, BiomeInfo> s_kBiomeInfo;
+	/// <summary>
+	/// Read-only, Shared by every generator on every thread.
+	/// </summary>
+	static const BiomeInfo s_kBiomeInfo[];
+
+	/// <summary>
+	/// Info of [biome], nullptr for biomes without any.
+	/// </summary>
+	static const BiomeInfo* FindBiomeInfo(BiomeType biome);
 
 	using PossiblePositions = eastl::vector<dragon::Vector2>;
 
 	MapGenerator()
-		: m_zoom(10.0f)
+		: m_seed(0)
+		, m_biomeTableSize(0, 0)
+		, m_biomePalette(1, BiomeType::kUnknown)
+		, m_biomePaletteThemes(1, 0)
+		, m_zoom(10.0f)
 		, m_persistance(0.5f)
 		, m_octaves(2)
 
 		, m_temperature(10.0f)
 		, m_precipitation(100.0f)
+		, m_threadCount(0)
+		, m_pathSearchCount(0)
 	{}
 
 	bool Init();
 
+	/// <summary>
+	/// Seeds the generator without generating, Region scoped edits need the seed the tilemap was generated with.
+	/// </summary>
+	void Seed(unsigned int seed);
+
 	void Generate(TDTilemap& tilemap, unsigned int seed);
 
 	void SetPrecipitation(float precip) { m_precipitation = precip; }
 	void SetTemperature(float temp) { m_temperature = temp; }
 
+	/// <summary>
+	/// Most threads rivers and spawners are generated on, 0 uses every core. The map comes out the same for any count.
+	/// </summary>
+	void SetThreadCount(unsigned int threadCount) { m_threadCount = threadCount; }
+
 	void SetBaseTile(TDTilemap& tilemap, dragon::Vector2 position);
 
-	BiomeType GetBiomeType(float temp, float precip);
+	BiomeType GetBiomeType(float temp, float precip) const;
+
+	dragon::TileID GetBiomeTile(BiomeType biomeType, MapTile tile) const;
+
+	/// <summary>
+	/// The tile for [tile] in the [theme]th tileset theme.
+	/// </summary>
+	static dragon::TileID GetThemeTile(size_t theme, MapTile tile) { return (dragon::TileID)(((size_t)MapTile::kCount * theme) + (size_t)tile); }
+
+	/// <summary>
+	/// Wether or not [tileId] is a carved path tile of any theme.
+	/// </summary>
+	static bool IsPathTile(dragon::TileID tileId);
 
-	dragon::TileID GetBiomeTile(BiomeType biomeType, MapTile tile);
+	/// <summary>
+	/// Cost of walking onto a tile, Paths prefer high noise.
+	/// </summary>
+	static float GetTileWeight(const TDTileData& tileData) { return (2.0f - tileData.m_noise) * 100.0f; }
 
 	/// <summary>
-	/// Finds random positions on the map to place the base.
+	/// Picks the position of the base out of [g_kMaxTries] random tiles.
 	/// Scoring is higher in the center of the map.
 	/// </summary>
 	/// <param name="map"></param>
-	virtual void FindBestBasePosition(const TDTilemap& tilemap, PossiblePositions& positions);
+	virtual dragon::Vector2 SelectBasePosition(const TDTilemap& tilemap);
 
 	/// <summary>
-	/// Finds best possible positions for enemy spawners.
-	/// Scoring is higher farther away of given position.
+	/// Picks [count] distinct tiles for enemy spawners, Every tile is picked with a chance proportional to its score.
+	/// Scoring is higher farther away of given position. Fewer positions are picked if not enough tiles score above zero.
 	/// </summary>
 	/// <param name="map"></param>
 	/// <param name="position"></param>
-	/// <param name="positions"></param>
-	virtual void FindEnemySpawnerLocations(const TDTilemap& tilemap, dragon::Vector2 position, PossiblePositions& positions);
+	/// <param name="positions">Replaced by the picked positions, In the order they were picked.</param>
+	virtual void SelectSpawnerLocations(const TDTilemap& tilemap, dragon::Vector2 position, size_t count, PossiblePositions& positions);
 
 	/// <summary>
 	/// Carves a path into the map and returns the Path centers.
@@ -103,12 +179,33 @@ public:
 	/// <param name="path">Centroid oriented Path</param>
 	virtual Path CarvePath(TDTilemap& tilemap, dragon::Vector2 from, dragon::Vector2 to);
 
+	/// <summary>
+	/// Carves an already generated path into the map again.
+	/// </summary>
+	/// <param name="dirty">Grows by every tile that changed.</param>
+	void StampPath(TDTilemap& tilemap, const Path& path, TileRect& dirty);
+
+	/// <summary>
+	/// Restores the tiles of [path] to their terrain, Tiles it shared with other paths must be stamped again by the caller.
+	/// The tilemap must have been generated by this generator with its current seed and climate.
+	/// </summary>
+	/// <param name="dirty">Grows by every tile that changed.</param>
+	void ClearPath(TDTilemap& tilemap, const Path& path, TileRect& dirty);
+
+	/// <summary>
+	/// Regenerates the terrain and rivers around [region] the way a full generation would have, For tiles that were edited.
+	/// Only [region] plus a halo of one tile per river iteration can change, Carved paths and the base are kept.
+	/// Same requirements as ClearPath. Returns the tiles that changed.
+	/// </summary>
+	TileRect GrowRivers(TDTilemap& tilemap, const TileRect& region);
+
 protected:
 
 	using Neighborhood = eastl::array<int, 4>;
 
 	/// <summary>
 	/// A* search a path between [from] and [to] in the tilemap using noise weight of the tiles.
+	/// Large maps that were searched often enough go through the path hierarchy instead.
 	/// </summary>
 	/// <param name="tilemap"></param>
 	/// <param name="from"></param>
@@ -121,14 +218,91 @@ protected:
 	float GetDistanceToTile(const TDTilemap& tilemap, int from, int to);
 
 	/// <summary>
-	/// Determines which pathing tile this tile should become.
+	/// Determines which pathing tile this tile should become, In the theme of the tile itself.
 	/// </summary>
-	/// <param name="biomeType">Determines the biome tileset.</param>
 	/// <param name="tileIndex">Determines which tile to return.</param>
 	/// <returns></returns>
-	dragon::TileID GetPathTile(BiomeType biomeType, dragon::TileID tileIndex);
+	dragon::TileID GetPathTile(dragon::TileID tileIndex) const;
+
+	/// <summary>
+	/// Threads to split work over, [m_threadCount] or every core.
+	/// </summary>
+	unsigned int GetThreadCount() const;
 
 	void GrowRivers(TDTilemap& tilemap);
 	void GrowRiversIteration(TDTilemap& tilemap);
-	void ApplyGrowRiversRule(const dragon::Tilemap& map, dragon::TileID riverTile, size_t start, size_t end, dragon::TileID* pNewState);
+
+	/// <summary>
+	/// Grows the rivers of [area] once, [pState] and [pNewState] hold the tiles of [area] in row order.
+	/// Tiles outside of [area] count as dry, So tiles along its inner edges are only right where [area] ends at the map edge.
+	/// </summary>
+	void GrowRiversIteration(const TileRect& area, const dragon::TileID* pState, dragon::TileID* pNewState) const;
+	void ApplyGrowRiversRule(const dragon::Tilemap& map, size_t start, size_t end, dragon::TileID* pNewState);
+
+	/// <summary>
+	/// Wether or not [tileId] is a river tile of any theme.
+	/// </summary>
+	static bool IsRiverTile(dragon::TileID tileId);
+
+	/// <summary>
+	/// Index into the biome table for the climate, Clamped to the table.
+	/// </summary>
+	size_t GetBiomeTableIndex(float temp, float precip) const;
+
+	/// <summary>
+	/// Classifies [count] tiles into palette indices, Four tiles at a time where SSE2 is available.
+	/// </summary>
+	void ClassifyBiomes(const float* pTemperature, const float* pPrecipitation, size_t count, uint8_t* pPaletteIndices) const;
+
+private:
+
+	/// <summary>
+	/// Tile competing to be picked, The highest keys are picked. (Weighted reservoir sampling)
+	/// A key of log(roll) / weight picks every tile with a chance proportional to its weight.
+	/// </summary>
+	struct Candidate
+	{
+		float key;
+		int tileIndex;
+	};
+
+	/// <summary>
+	/// Orders candidates by key, Ties are broken on the tile index to keep the picks deterministic.
+	/// </summary>
+	static bool IsBetterCandidate(const Candidate& left, const Candidate& right);
+
+	/// <summary>
+	/// Keeps the best [count] spawner candidates in the rows [firstRow, endRow), Safe to run in parallel for other rows.
+	/// </summary>
+	/// <param name="best">Heap with the worst kept candidate on top.</param>
+	void SelectSpawnerRows(dragon::Vector2u mapSize, dragon::Vector2 position, size_t count, unsigned int firstRow, unsigned int endRow, eastl::vector<Candidate>& best) const;
+
+	/// <summary>
+	/// Noise fields of a single tile.
+	/// </summary>
+	struct TileClimate
+	{
+		float noise;			// Height noise [0.0f, 1.0f] before smoothing.
+		float temperature;
+		float moisture;			// Moisture noise [0.0f, 1.0f].
+		float precipitation;
+	};
+
+	TileClimate SampleClimate(unsigned int x, unsigned int y, dragon::Vector2u size);
+
+	float GetBiomeDensity() const;
+
+	/// <summary>
+	/// Terrain tile before rivers are grown and paths carved.
+	/// </summary>
+	dragon::TileID ClassifyTerrain(size_t theme, const TileClimate& climate, unsigned int tileIndex, float biomeDensity, bool& isTurretPlaceable) const;
+
+	/// <summary>
+	/// Turns a carved path tile back into the terrain it was carved from, Returns false if the tile was not a path.
+	/// </summary>
+	bool RestoreTerrain(TDTilemap& tilemap, int tileIndex);
+
+	Path CarveTilePath(TDTilemap& tilemap, const TilePath& tilePath, TileRect& dirty);
+
+	static TilePath ToTilePath(const TDTilemap& tilemap, const Path& path);
 };
\ No newline at end of file
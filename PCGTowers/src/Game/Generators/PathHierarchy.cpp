@@ -0,0 +1,450 @@
+#include "PathHierarchy.h"
+
+#include <Config.h>
+
+#include <Game/Generators/MapGenerator.h>
+
+#include <Utility/Profiler.h>
+
+#include <EASTL/heap.h>
+#include <EASTL/sort.h>
+#include <EASTL/algorithm.h>
+
+#include <cstdlib>
+#include <limits>
+
+static constexpr float kInf = std::numeric_limits<float>::infinity();
+
+/// <summary>
+/// Orders the queues as min heaps, Ties are broken on the index to keep paths deterministic.
+/// </summary>
+template<typename Entry>
+static bool IsLaterEntry(const Entry& left, const Entry& right)
+{
+	if (left.key != right.key)
+		return left.key > right.key;
+
+	return left.index > right.index;
+}
+
+void PathHierarchy::Build(const TDTilemap& tilemap)
+{
+	PCG_PROFILE_ZONE("PathHierarchy::Build");
+
+	m_pTilemap = &tilemap;
+	m_mapSize = tilemap.GetSize();
+
+	const int kWidth = (int)m_mapSize.x;
+	const int kHeight = (int)m_mapSize.y;
+	const size_t kTileCount = (size_t)kWidth * (size_t)kHeight;
+
+	m_sectorsX = (kWidth + g_kPathSectorSize - 1) / g_kPathSectorSize;
+	m_sectorsY = (kHeight + g_kPathSectorSize - 1) / g_kPathSectorSize;
+
+	m_weights.resize(kTileCount);
+	m_minWeight = kInf;
+	for (size_t i = 0; i < kTileCount; ++i)
+	{
+		m_weights[i] = MapGenerator::GetTileWeight(tilemap.GetTileDataAtIndex(i));
+		m_minWeight = eastl::min(m_minWeight, m_weights[i]);
+	}
+
+	// Crossings between neighboring sectors, As pairs of tiles on either side of the border.
+	eastl::vector<eastl::pair<int, int>> crossings;
+
+	for (int sectorY = 0; sectorY < m_sectorsY; ++sectorY)
+	{
+		for (int sectorX = 0; sectorX < m_sectorsX; ++sectorX)
+		{
+			TileRect rect = GetSectorRect(sectorY * m_sectorsX + sectorX);
+
+			if (rect.m_right < kWidth)
+				AddEntrances(rect.m_right - 1, rect.m_top, rect.GetHeight(), true, crossings);
+
+			if (rect.m_bottom < kHeight)
+				AddEntrances(rect.m_left, rect.m_bottom - 1, rect.GetWidth(), false, crossings);
+		}
+	}
+
+	// Every tile of a crossing becomes a node, Ordered by sector so the nodes of a sector are next to each other.
+	eastl::vector<int> entranceTiles;
+	entranceTiles.reserve(crossings.size() * 2);
+	for (const auto& crossing : crossings)
+	{
+		entranceTiles.push_back(crossing.first);
+		entranceTiles.push_back(crossing.second);
+	}
+
+	eastl::sort(entranceTiles.begin(), entranceTiles.end(), [this](int left, int right)
+	{
+		int leftSector = GetSector(left);
+		int rightSector = GetSector(right);
+		return leftSector != rightSector ? leftSector < rightSector : left < right;
+	});
+	entranceTiles.erase(eastl::unique(entranceTiles.begin(), entranceTiles.end()), entranceTiles.end());
+
+	auto findNode = [&entranceTiles, this](int tileIndex) -> int
+	{
+		auto it = eastl::lower_bound(entranceTiles.begin(), entranceTiles.end(), tileIndex, [this](int entrance, int tile)
+		{
+			int entranceSector = GetSector(entrance);
+			int tileSector = GetSector(tile);
+			return entranceSector != tileSector ? entranceSector < tileSector : entrance < tile;
+		});
+
+		return (int)(it - entranceTiles.begin());
+	};
+
+	// Edges into the neighboring sectors, Ordered by the node they leave from.
+	eastl::vector<eastl::pair<int, Edge>> crossingEdges;
+	crossingEdges.reserve(crossings.size() * 2);
+	for (const auto& crossing : crossings)
+	{
+		int first = findNode(crossing.first);
+		int second = findNode(crossing.second);
+
+		crossingEdges.push_back({ first, Edge{ second, m_weights[crossing.second] } });
+		crossingEdges.push_back({ second, Edge{ first, m_weights[crossing.first] } });
+	}
+
+	eastl::sort(crossingEdges.begin(), crossingEdges.end(), [](const eastl::pair<int, Edge>& left, const eastl::pair<int, Edge>& right)
+	{
+		return left.first != right.first ? left.first < right.first : left.second.node < right.second.node;
+	});
+
+	m_nodes.resize(entranceTiles.size());
+	m_sectorFirstNode.assign((size_t)(m_sectorsX * m_sectorsY) + 1, 0);
+
+	for (size_t i = 0; i < entranceTiles.size(); ++i)
+	{
+		m_nodes[i].tileIndex = entranceTiles[i];
+		m_nodes[i].sector = GetSector(entranceTiles[i]);
+		++m_sectorFirstNode[m_nodes[i].sector + 1];
+	}
+
+	for (size_t i = 1; i < m_sectorFirstNode.size(); ++i)
+		m_sectorFirstNode[i] += m_sectorFirstNode[i - 1];
+
+	// Every node has its crossings first, Followed by an edge to every other entrance of its sector.
+	m_edges.clear();
+
+	size_t nextCrossingEdge = 0;
+	for (size_t i = 0; i < m_nodes.size(); ++i)
+	{
+		Node& node = m_nodes[i];
+		node.firstEdge = (uint32_t)m_edges.size();
+
+		for (; nextCrossingEdge < crossingEdges.size() && crossingEdges[nextCrossingEdge].first == (int)i; ++nextCrossingEdge)
+			m_edges.push_back(crossingEdges[nextCrossingEdge].second);
+
+		uint32_t sectorNodeCount = m_sectorFirstNode[node.sector + 1] - m_sectorFirstNode[node.sector];
+		m_edges.resize(m_edges.size() + sectorNodeCount - 1);
+
+		node.edgeCount = (uint32_t)m_edges.size() - node.firstEdge;
+	}
+
+	// Searching every sector costs far more than the few paths of a round, They are searched once a path reaches them.
+	m_isSectorBuilt.assign((size_t)(m_sectorsX * m_sectorsY), 0);
+	m_builtSectorCount = 0;
+
+	m_nodeCosts.resize(m_nodes.size());
+	m_nodePrevious.resize(m_nodes.size());
+}
+
+void PathHierarchy::Clear()
+{
+	m_pTilemap = nullptr;
+	m_mapSize = { 0, 0 };
+
+	m_weights.clear();
+	m_nodes.clear();
+	m_edges.clear();
+	m_sectorFirstNode.clear();
+	m_isSectorBuilt.clear();
+	m_builtSectorCount = 0;
+}
+
+TilePath PathHierarchy::FindPath(int from, int to)
+{
+	PCG_PROFILE_ZONE("PathHierarchy::FindPath");
+
+	TilePath path;
+	m_expansions = 0;
+
+	if (from == to)
+		return path;
+
+	int fromSector = GetSector(from);
+	int toSector = GetSector(to);
+
+	// Connect the start to the entrances of its sector, And the entrances of the goal's sector to the goal.
+	SearchSector(m_startSearch, GetSectorRect(fromSector), from, false);
+	SearchSector(m_goalSearch, GetSectorRect(toSector), to, true);
+
+	float bestCost = kInf;
+	int bestNode = dragon::kInvalidTile;
+
+	// The path may never have to leave the sector.
+	if (fromSector == toSector)
+		bestCost = m_startSearch.costs[GetLocalIndex(m_startSearch.rect, to)];
+
+	eastl::fill(m_nodeCosts.begin(), m_nodeCosts.end(), kInf);
+	m_queue.clear();
+
+	for (uint32_t i = m_sectorFirstNode[fromSector]; i < m_sectorFirstNode[fromSector + 1]; ++i)
+	{
+		float cost = m_startSearch.costs[GetLocalIndex(m_startSearch.rect, m_nodes[i].tileIndex)];
+
+		m_nodeCosts[i] = cost;
+		m_nodePrevious[i] = dragon::kInvalidTile;
+		m_queue.push_back({ cost + GetHeuristic(m_nodes[i].tileIndex, to), (int)i });
+		eastl::push_heap(m_queue.begin(), m_queue.end(), IsLaterEntry<QueueEntry>);
+	}
+
+	// A* over the entrances, The heuristic never overestimates so the first goal found cheaper than the queue is the best.
+	while (!m_queue.empty())
+	{
+		eastl::pop_heap(m_queue.begin(), m_queue.end(), IsLaterEntry<QueueEntry>);
+		QueueEntry entry = m_queue.back();
+		m_queue.pop_back();
+
+		if (entry.key >= bestCost)
+			break;
+
+		const Node& node = m_nodes[entry.index];
+		float cost = m_nodeCosts[entry.index];
+
+		// Outdated, The node was pushed again with a lower cost.
+		if (entry.key != cost + GetHeuristic(node.tileIndex, to))
+			continue;
+
+		++m_expansions;
+
+		if (!m_isSectorBuilt[node.sector])
+			BuildSector(node.sector);
+
+		if (node.sector == toSector)
+		{
+			float goalCost = cost + m_goalSearch.costs[GetLocalIndex(m_goalSearch.rect, node.tileIndex)];
+			if (goalCost < bestCost)
+			{
+				bestCost = goalCost;
+				bestNode = entry.index;
+			}
+		}
+
+		for (uint32_t i = node.firstEdge; i < node.firstEdge + node.edgeCount; ++i)
+		{
+			const Edge& edge = m_edges[i];
+
+			float newCost = cost + edge.cost;
+			if (newCost < m_nodeCosts[edge.node])
+			{
+				m_nodeCosts[edge.node] = newCost;
+				m_nodePrevious[edge.node] = entry.index;
+				m_queue.push_back({ newCost + GetHeuristic(m_nodes[edge.node].tileIndex, to), edge.node });
+				eastl::push_heap(m_queue.begin(), m_queue.end(), IsLaterEntry<QueueEntry>);
+			}
+		}
+	}
+
+	if (bestCost == kInf)
+		return path;
+
+	if (bestNode == dragon::kInvalidTile)
+	{
+		AppendSearchPath(m_startSearch, to, path);
+		return path;
+	}
+
+	// Entrances the path passes through, In order.
+	eastl::vector<int> nodes;
+	for (int node = bestNode; node != dragon::kInvalidTile; node = m_nodePrevious[node])
+		nodes.push_back(node);
+
+	eastl::reverse(nodes.begin(), nodes.end());
+
+	// Refine, From the start to the first entrance.
+	AppendSearchPath(m_startSearch, m_nodes[nodes.front()].tileIndex, path);
+
+	for (size_t i = 1; i < nodes.size(); ++i)
+	{
+		const Node& previous = m_nodes[nodes[i - 1]];
+		const Node& next = m_nodes[nodes[i]];
+
+		// Crossings are a single step, Everything else stays within a sector.
+		if (previous.sector != next.sector)
+		{
+			path.push_back(next.tileIndex);
+			continue;
+		}
+
+		SearchSector(m_refineSearch, GetSectorRect(next.sector), previous.tileIndex, false, next.tileIndex);
+		AppendSearchPath(m_refineSearch, next.tileIndex, path);
+	}
+
+	// The reversed search already points every tile towards the goal.
+	for (int tileIndex = m_nodes[nodes.back()].tileIndex; tileIndex != to;)
+	{
+		tileIndex = m_goalSearch.previous[GetLocalIndex(m_goalSearch.rect, tileIndex)];
+		path.push_back(tileIndex);
+	}
+
+	return path;
+}
+
+int PathHierarchy::GetSector(int tileIndex) const
+{
+	int x = tileIndex % (int)m_mapSize.x;
+	int y = tileIndex / (int)m_mapSize.x;
+
+	return (y / g_kPathSectorSize) * m_sectorsX + (x / g_kPathSectorSize);
+}
+
+TileRect PathHierarchy::GetSectorRect(int sector) const
+{
+	int left = (sector % m_sectorsX) * g_kPathSectorSize;
+	int top = (sector / m_sectorsX) * g_kPathSectorSize;
+
+	return TileRect(left, top, left + g_kPathSectorSize, top + g_kPathSectorSize).Clipped(m_mapSize);
+}
+
+void PathHierarchy::AddEntrances(int x, int y, int length, bool isVertical, eastl::vector<eastl::pair<int, int>>& crossings) const
+{
+	const int kWidth = (int)m_mapSize.x;
+
+	// Step along the border, And across it.
+	const int kAlong = isVertical ? kWidth : 1;
+	const int kAcross = isVertical ? 1 : kWidth;
+
+	int first = y * kWidth + x;
+
+	for (int start = 0; start < length; start += g_kPathEntranceWidth)
+	{
+		int end = eastl::min(start + g_kPathEntranceWidth, length);
+
+		int best = first + start * kAlong;
+		for (int i = start + 1; i < end; ++i)
+		{
+			int tileIndex = first + i * kAlong;
+			if (m_weights[tileIndex] + m_weights[tileIndex + kAcross] < m_weights[best] + m_weights[best + kAcross])
+				best = tileIndex;
+		}
+
+		crossings.push_back({ best, best + kAcross });
+	}
+}
+
+void PathHierarchy::BuildSector(int sector)
+{
+	PCG_PROFILE_ZONE("PathHierarchy::BuildSector");
+
+	const uint32_t kFirstNode = m_sectorFirstNode[sector];
+	const uint32_t kEndNode = m_sectorFirstNode[sector + 1];
+
+	for (uint32_t i = kFirstNode; i < kEndNode; ++i)
+	{
+		const Node& node = m_nodes[i];
+		SearchSector(m_sectorSearch, GetSectorRect(sector), node.tileIndex, false);
+
+		// The edges within the sector come after the crossings.
+		Edge* pEdge = &m_edges[node.firstEdge + node.edgeCount - (kEndNode - kFirstNode - 1)];
+		for (uint32_t other = kFirstNode; other < kEndNode; ++other)
+		{
+			if (other != i)
+				*pEdge++ = { (int)other, m_sectorSearch.costs[GetLocalIndex(m_sectorSearch.rect, m_nodes[other].tileIndex)] };
+		}
+	}
+
+	m_isSectorBuilt[sector] = 1;
+	++m_builtSectorCount;
+}
+
+void PathHierarchy::SearchSector(SectorSearch& search, const TileRect& rect, int source, bool isReversed, int target) const
+{
+	const int kMapWidth = (int)m_mapSize.x;
+	const int kWidth = rect.GetWidth();
+	const int kHeight = rect.GetHeight();
+
+	search.rect = rect;
+	search.costs.assign(rect.GetArea(), kInf);
+	search.previous.assign(rect.GetArea(), dragon::kInvalidTile);
+
+	// The queue holds indices within the sector, Which saves converting every neighbor.
+	int localSource = GetLocalIndex(rect, source);
+	int localTarget = target != dragon::kInvalidTile ? GetLocalIndex(rect, target) : dragon::kInvalidTile;
+
+	search.costs[localSource] = 0.0f;
+
+	search.queue.clear();
+	search.queue.push_back({ 0.0f, localSource });
+
+	while (!search.queue.empty())
+	{
+		eastl::pop_heap(search.queue.begin(), search.queue.end(), IsLaterEntry<QueueEntry>);
+		QueueEntry entry = search.queue.back();
+		search.queue.pop_back();
+
+		int localIndex = entry.index;
+		if (entry.key != search.costs[localIndex])
+			continue;
+
+		if (localIndex == localTarget)
+			break;
+
+		int x = localIndex % kWidth;
+		int y = localIndex / kWidth;
+		int tileIndex = (rect.m_top + y) * kMapWidth + rect.m_left + x;
+
+		auto relax = [&](int localNeighbor, int neighbor)
+		{
+			// Walking onto the neighbor, Or from the neighbor onto this tile when reversed.
+			float cost = entry.key + (isReversed ? m_weights[tileIndex] : m_weights[neighbor]);
+
+			if (cost < search.costs[localNeighbor])
+			{
+				search.costs[localNeighbor] = cost;
+				search.previous[localNeighbor] = tileIndex;
+				search.queue.push_back({ cost, localNeighbor });
+				eastl::push_heap(search.queue.begin(), search.queue.end(), IsLaterEntry<QueueEntry>);
+			}
+		};
+
+		if (x > 0) relax(localIndex - 1, tileIndex - 1);
+		if (x < kWidth - 1) relax(localIndex + 1, tileIndex + 1);
+		if (y > 0) relax(localIndex - kWidth, tileIndex - kMapWidth);
+		if (y < kHeight - 1) relax(localIndex + kWidth, tileIndex + kMapWidth);
+	}
+}
+
+void PathHierarchy::AppendSearchPath(const SectorSearch& search, int target, TilePath& path) const
+{
+	size_t first = path.size();
+
+	for (int tileIndex = target; search.previous[GetLocalIndex(search.rect, tileIndex)] != dragon::kInvalidTile;)
+	{
+		path.push_back(tileIndex);
+		tileIndex = search.previous[GetLocalIndex(search.rect, tileIndex)];
+	}
+
+	eastl::reverse(path.begin() + first, path.end());
+}
+
+int PathHierarchy::GetLocalIndex(const TileRect& rect, int tileIndex) const
+{
+	int x = tileIndex % (int)m_mapSize.x;
+	int y = tileIndex / (int)m_mapSize.x;
+
+	return (y - rect.m_top) * rect.GetWidth() + (x - rect.m_left);
+}
+
+float PathHierarchy::GetHeuristic(int tileIndex, int to) const
+{
+	int x = tileIndex % (int)m_mapSize.x;
+	int y = tileIndex / (int)m_mapSize.x;
+	int toX = to % (int)m_mapSize.x;
+	int toY = to / (int)m_mapSize.x;
+
+	// Every step costs at least the cheapest tile.
+	return (float)(std::abs(x - toX) + std::abs(y - toY)) * m_minWeight;
+}
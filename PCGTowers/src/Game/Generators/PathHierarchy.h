@@ -0,0 +1,160 @@
+#pragma once
+
+#include <Game/Path.h>
+#include <Game/TileRect.h>
+#include <Game/TowerDefense/TDTilemap.h>
+
+#include <EASTL/vector.h>
+#include <EASTL/utility.h>
+
+#include <cstdint>
+
+/// <summary>
+/// Abstraction of a tilemap that finds paths on large maps without searching every tile. (Hierarchical Path-Finding A*)
+/// The map is split into sectors connected through entrances on their shared borders, The cost between the entrances of a sector is computed once a path first reaches it.
+/// Paths are searched from entrance to entrance first and then refined tile by tile within the sectors they pass through.
+/// </summary>
+class PathHierarchy
+{
+	struct Edge
+	{
+		int node;
+		float cost;
+	};
+
+	/// <summary>
+	/// Entrance tile, Paths can only leave a sector through its entrances.
+	/// </summary>
+	struct Node
+	{
+		int tileIndex;
+		int sector;
+		uint32_t firstEdge;
+		uint32_t edgeCount;
+	};
+
+	struct QueueEntry
+	{
+		float key;
+		int index;
+	};
+
+	/// <summary>
+	/// Search limited to a single sector, Indexed by the position of the tile within the sector.
+	/// </summary>
+	struct SectorSearch
+	{
+		TileRect rect;
+		eastl::vector<float> costs;
+		eastl::vector<int> previous;	// Tile the search came from, Towards the source.
+		eastl::vector<QueueEntry> queue;
+	};
+
+	const TDTilemap* m_pTilemap;
+	dragon::Vector2u m_mapSize;
+
+	int m_sectorsX;
+	int m_sectorsY;
+
+	/// <summary>
+	/// Cost of walking onto every tile, Copied from the tilemap by Build.
+	/// </summary>
+	eastl::vector<float> m_weights;
+	float m_minWeight;
+
+	/// <summary>
+	/// Entrances ordered by sector, Every node has its edges in one run of m_edges.
+	/// </summary>
+	eastl::vector<Node> m_nodes;
+	eastl::vector<Edge> m_edges;
+
+	/// <summary>
+	/// The nodes of sector s are [m_sectorFirstNode[s], m_sectorFirstNode[s + 1]).
+	/// </summary>
+	eastl::vector<uint32_t> m_sectorFirstNode;
+
+	/// <summary>
+	/// Wether the edges between the entrances of a sector were computed, A few paths only cross a small part of a large map.
+	/// </summary>
+	eastl::vector<uint8_t> m_isSectorBuilt;
+	size_t m_builtSectorCount;
+
+	// Query scratch, Kept so queries don't allocate.
+	SectorSearch m_startSearch;
+	SectorSearch m_goalSearch;
+	SectorSearch m_refineSearch;
+	SectorSearch m_sectorSearch;
+	eastl::vector<float> m_nodeCosts;
+	eastl::vector<int> m_nodePrevious;
+	eastl::vector<QueueEntry> m_queue;
+
+	/// <summary>
+	/// Entrances expanded by the last FindPath.
+	/// </summary>
+	size_t m_expansions;
+
+public:
+
+	PathHierarchy()
+		: m_pTilemap(nullptr)
+		, m_mapSize(0, 0)
+		, m_sectorsX(0)
+		, m_sectorsY(0)
+		, m_minWeight(0.0f)
+		, m_builtSectorCount(0)
+		, m_expansions(0)
+	{}
+
+	/// <summary>
+	/// Builds the sectors and entrances from the tile weights of [tilemap], The weights must not change until the next Build.
+	/// The costs within a sector are left to the first FindPath that expands one of its entrances.
+	/// </summary>
+	void Build(const TDTilemap& tilemap);
+	void Clear();
+
+	/// <summary>
+	/// Wether or not the hierarchy was last built from [tilemap].
+	/// </summary>
+	bool IsBuiltFor(const TDTilemap& tilemap) const { return m_pTilemap == &tilemap && m_mapSize.x == tilemap.GetSize().x && m_mapSize.y == tilemap.GetSize().y; }
+
+	/// <summary>
+	/// Path from [from] to [to], Excluding [from] itself just like MapGenerator::GeneratePath.
+	/// Optimal within the sectors it passes through, Crossing between sectors is limited to the entrances.
+	/// </summary>
+	TilePath FindPath(int from, int to);
+
+	size_t GetNodeCount() const { return m_nodes.size(); }
+	size_t GetEdgeCount() const { return m_edges.size(); }
+	size_t GetExpansions() const { return m_expansions; }
+	size_t GetBuiltSectorCount() const { return m_builtSectorCount; }
+
+private:
+
+	int GetSector(int tileIndex) const;
+	TileRect GetSectorRect(int sector) const;
+
+	/// <summary>
+	/// Picks the cheapest crossing in every [g_kPathEntranceWidth] tiles of the border between two sectors.
+	/// </summary>
+	/// <param name="isVertical">Wether the border runs along a column, Between a sector and the one to its right.</param>
+	void AddEntrances(int x, int y, int length, bool isVertical, eastl::vector<eastl::pair<int, int>>& crossings) const;
+
+	/// <summary>
+	/// Fills in the edges between the entrances of [sector].
+	/// </summary>
+	void BuildSector(int sector);
+
+	/// <summary>
+	/// Dijkstra from [source] over the tiles of [rect], Stops early once [target] is settled.
+	/// </summary>
+	/// <param name="isReversed">Computes the cost of walking from every tile to [source] instead.</param>
+	void SearchSector(SectorSearch& search, const TileRect& rect, int source, bool isReversed, int target = dragon::kInvalidTile) const;
+
+	/// <summary>
+	/// Appends the tiles a forward search walked to reach [target], Excluding its source.
+	/// </summary>
+	void AppendSearchPath(const SectorSearch& search, int target, TilePath& path) const;
+
+	int GetLocalIndex(const TileRect& rect, int tileIndex) const;
+	float GetHeuristic(int tileIndex, int to) const;
+};
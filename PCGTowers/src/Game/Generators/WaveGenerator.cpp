@@ -33,11 +33,15 @@ void WaveGenerator::GenerateWaves(Spawners& spawners, unsigned int seed, unsigne
 {
 	unsigned int waveSeed = seed + (currentWave * 2361103u);
 
-	m_random.Seed(waveSeed);
-	m_waveGrammarSystem.SetSeed(waveSeed);
-
-	for (auto& spawner : spawners)
+	for (size_t i = 0; i < spawners.size(); ++i)
 	{
+		Spawner& spawner = spawners[i];
+		spawner.SetWaveGenerator(this);
+
+		// Each spawner has its own streams, So the waves of a spawner don't depend on the other spawners.
+		m_groupRandom.Seed(CounterRandom::Draw(waveSeed, RandomStream::kWaveGroup, (unsigned int)i), RandomStream::kWaveGroup);
+		m_waveGrammarSystem.SetSeed(CounterRandom::Draw(waveSeed, RandomStream::kGrammar, (unsigned int)i));
+
 		auto pRoot = m_waveGrammarSystem.RunGrammar('S');
 
 		// Process Nodes
@@ -50,15 +54,9 @@ void WaveGenerator::ProcessNode(WeightedGrammarSystem::RuleNode* pNode, Spawner&
 	// Group of Enemies
 	if (pNode->m_symbol == 'G')
 	{
-		eastl::queue<Enemy*> enemyGroup;
-
-		for (auto pChild : pNode->m_children)
-		{
-			Enemy* pEnemy = CreateEnemy(m_enemyType);
-			enemyGroup.emplace_back(pEnemy);
-		}
-
-		pSpawner.EmplaceEnemyGroup(eastl::move(enemyGroup));
+		// Only describe the group, The spawner creates the enemies once they are released.
+		unsigned int statsSeed = m_groupRandom.Next();
+		pSpawner.EmplaceEnemyGroup(SpawnDescriptor(m_enemyType, (unsigned int)pNode->m_children.size(), statsSeed));
 	}
 	else if (pNode->m_symbol == 'T')
 	{
@@ -74,26 +72,29 @@ void WaveGenerator::ProcessNode(WeightedGrammarSystem::RuleNode* pNode, Spawner&
 	}
 }
 
-Enemy* WaveGenerator::CreateEnemy(char enemyType)
+Enemy* WaveGenerator::CreateEnemy(const SpawnDescriptor& group, unsigned int index) const
 {
 	Enemy* pEnemy = new Enemy();
 
-	switch (enemyType)
+	// Each enemy gets its own stream, Independent of the order enemies are created in.
+	dragon::Random random(dragon::SquirrelNoise::Get1DNoise((int)index, group.m_statsSeed));
+
+	switch (group.m_enemyType)
 	{
 	case 't':
 		// Tank
-		CreateTank(pEnemy);
+		CreateTank(pEnemy, random);
 		break;
 	case 's':
 		// Speedy
-		CreateSpeedy(pEnemy);
+		CreateSpeedy(pEnemy, random);
 		break;
 		// Generic
 	case 'g':
-		CreateGeneric(pEnemy);
+		CreateGeneric(pEnemy, random);
 		break;
 	case 'r':
-		CreateRandom(pEnemy);
+		CreateRandom(pEnemy, random);
 		break;
 		// Randomized Attributes.
 	}
@@ -101,12 +102,12 @@ Enemy* WaveGenerator::CreateEnemy(char enemyType)
 	return pEnemy;
 }
 
-void WaveGenerator::CreateTank(Enemy* pEnemy)
+void WaveGenerator::CreateTank(Enemy* pEnemy, dragon::Random& random) const
 {
 	static constexpr dragon::Range<float> kTankHealthRange(100.0f, 200.0f);
 
 	Enemy::Stats stats;
-	stats.m_maxHealth = kTankHealthRange.GetRandom(m_random);
+	stats.m_maxHealth = kTankHealthRange.GetRandom(random);
 	stats.m_speed = g_kTileSize / 2.0f; // 4x Slower than generic.
 	stats.m_damage = 2.0f; // 2x Damage than generic.
 
@@ -115,13 +116,13 @@ void WaveGenerator::CreateTank(Enemy* pEnemy)
 	pEnemy->SetColor(dragon::Colors::Cyan);
 }
 
-void WaveGenerator::CreateSpeedy(Enemy* pEnemy)
+void WaveGenerator::CreateSpeedy(Enemy* pEnemy, dragon::Random& random) const
 {
 	static constexpr dragon::Range<float> kSpeedRange(g_kTileSize, g_kTileSize * 2.0f);
 
 	Enemy::Stats stats;
 	stats.m_maxHealth = 20.0f; // Very Low health.
-	stats.m_speed = kSpeedRange.GetRandom(m_random);
+	stats.m_speed = kSpeedRange.GetRandom(random);
 	stats.m_damage = 0.5f; // Low damage.
 
 	pEnemy->SetStats(stats);
@@ -129,12 +130,12 @@ void WaveGenerator::CreateSpeedy(Enemy* pEnemy)
 	pEnemy->SetColor(dragon::Colors::LightYellow);
 }
 
-void WaveGenerator::CreateGeneric(Enemy* pEnemy)
+void WaveGenerator::CreateGeneric(Enemy* pEnemy, dragon::Random& random) const
 {
 	static constexpr dragon::Range<float> kHealthRange(60.0f, 100.0f);
 
 	Enemy::Stats stats;
-	stats.m_maxHealth = kHealthRange.GetRandom(m_random);
+	stats.m_maxHealth = kHealthRange.GetRandom(random);
 	stats.m_speed = g_kTileSize;
 	stats.m_damage = 1.0f;
 
@@ -143,21 +144,21 @@ void WaveGenerator::CreateGeneric(Enemy* pEnemy)
 	pEnemy->SetColor(dragon::Colors::Red);
 }
 
-void WaveGenerator::CreateRandom(Enemy* pEnemy)
+void WaveGenerator::CreateRandom(Enemy* pEnemy, dragon::Random& random) const
 {
 	static constexpr dragon::Range<float> kHealthRange(10.0f, 160.0f);
 	static constexpr dragon::Range<float> kSpeedRange(g_kTileSize / 4.0f, g_kTileSize * 1.5f);
 	static constexpr dragon::Range<float> kDamageRange(0.5f, 3.0f);
 
 	Enemy::Stats stats;
-	stats.m_maxHealth = kHealthRange.GetRandom(m_random);
-	stats.m_speed = kSpeedRange.GetRandom(m_random);
-	stats.m_damage = kDamageRange.GetRandom(m_random);
+	stats.m_maxHealth = kHealthRange.GetRandom(random);
+	stats.m_speed = kSpeedRange.GetRandom(random);
+	stats.m_damage = kDamageRange.GetRandom(random);
 
 	pEnemy->SetStats(stats);
-	pEnemy->SetShape((Enemy::Shape)m_random.RandomRange<size_t>((size_t)Enemy::Shape::kCircle, (size_t)Enemy::Shape::kTriangle));
+	pEnemy->SetShape((Enemy::Shape)random.RandomRange<size_t>((size_t)Enemy::Shape::kCircle, (size_t)Enemy::Shape::kTriangle));
 
 	// Get a reasonable color using HSV
-	dragon::Color randomColor = dragon::Color::FromHSV(m_random.RandomRange(0.0f, 360.0f), .5f, 1.0f);
+	dragon::Color randomColor = dragon::Color::FromHSV(random.RandomRange(0.0f, 360.0f), .5f, 1.0f);
 	pEnemy->SetColor(randomColor);
 }
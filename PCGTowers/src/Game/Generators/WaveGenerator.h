@@ -1,10 +1,12 @@
 #pragma once
 
 #include <Game/WeightedGrammarSystem.h>
+#include <Game/Generators/CounterRandom.h>
 #include <EASTL/vector.h>
 #include <EASTL/stack.h>
 
 class Enemy;
+struct SpawnDescriptor;
 
 /// <summary>
 /// Generate waves using a Grammar System.
@@ -48,7 +50,10 @@ class WaveGenerator
 
 	char m_enemyType;
 
-	dragon::Random m_random;
+	/// <summary>
+	/// Draws the stats seeds of the groups for the spawner that is being processed.
+	/// </summary>
+	CounterRandom m_groupRandom;
 
 public:
 
@@ -65,14 +70,22 @@ public:
 	// Add a rule to the system.
 	void AddRule(char symbol, const WeightedGrammarSystem::Rule& rule) { m_waveGrammarSystem.AddRule(symbol, rule); }
 
+	WeightedGrammarSystem& GetGrammarSystem() { return m_waveGrammarSystem; }
+
+	/// <summary>
+	/// Creates the [index]th enemy of the group.
+	/// Stats only depend on the group's seed and the index, So enemies can be created at any time and from any thread.
+	/// </summary>
+	/// <param name="group"></param>
+	/// <param name="index"></param>
+	virtual Enemy* CreateEnemy(const SpawnDescriptor& group, unsigned int index) const;
+
 private:
 
 	virtual void ProcessNode(WeightedGrammarSystem::RuleNode* pNode, Spawner& pSpawner);
 
-	virtual Enemy* CreateEnemy(char enemyType);
-
-	virtual void CreateTank(Enemy* pEnemy);
-	virtual void CreateSpeedy(Enemy* pEnemy);
-	virtual void CreateGeneric(Enemy* pEnemy);
-	virtual void CreateRandom(Enemy* pEnemy);
+	virtual void CreateTank(Enemy* pEnemy, dragon::Random& random) const;
+	virtual void CreateSpeedy(Enemy* pEnemy, dragon::Random& random) const;
+	virtual void CreateGeneric(Enemy* pEnemy, dragon::Random& random) const;
+	virtual void CreateRandom(Enemy* pEnemy, dragon::Random& random) const;
 };
\ No newline at end of file
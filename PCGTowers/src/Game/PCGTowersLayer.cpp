@@ -1,5 +1,7 @@
 #include "PCGTowersLayer.h"
 
+#include <Utility/Profiler.h>
+
 #include <SFML/Graphics.hpp>
 
 PCGTowersLayer::~PCGTowersLayer()
@@ -8,6 +10,8 @@ PCGTowersLayer::~PCGTowersLayer()
 
 void PCGTowersLayer::OnAttach()
 {
+	PCG_PROFILE_THREAD("Main");
+
 	m_font.loadFromFile("retro_gaming.ttf");
 
 	m_world.Init();
@@ -0,0 +1,219 @@
+#include "InputJournal.h"
+
+#include <EASTL/algorithm.h>
+
+#include <cstring>
+#include <fstream>
+
+static constexpr char g_kJournalMagic[4] = { 'P', 'C', 'G', 'R' };
+
+using JournalBuffer = eastl::vector<uint8_t>;
+
+template<typename Type>
+static void WriteRaw(JournalBuffer& buffer, Type value)
+{
+	const uint8_t* pBytes = reinterpret_cast<const uint8_t*>(&value);
+	buffer.insert(buffer.end(), pBytes, pBytes + sizeof(Type));
+}
+
+static void WriteVarint(JournalBuffer& buffer, uint32_t value)
+{
+	while (value >= 0x80)
+	{
+		buffer.push_back((uint8_t)(value | 0x80));
+		value >>= 7;
+	}
+	buffer.push_back((uint8_t)value);
+}
+
+/// <summary>
+/// Reads from a buffer, Fails once reading past the end.
+/// </summary>
+struct JournalReader
+{
+	const JournalBuffer& m_buffer;
+	size_t m_offset;
+	bool m_isValid;
+
+	JournalReader(const JournalBuffer& buffer)
+		: m_buffer(buffer)
+		, m_offset(0)
+		, m_isValid(true)
+	{}
+
+	template<typename Type>
+	Type ReadRaw()
+	{
+		Type value{};
+		if (m_offset + sizeof(Type) > m_buffer.size())
+		{
+			m_isValid = false;
+			return value;
+		}
+
+		std::memcpy(&value, m_buffer.data() + m_offset, sizeof(Type));
+		m_offset += sizeof(Type);
+		return value;
+	}
+
+	uint32_t ReadVarint()
+	{
+		uint32_t value = 0;
+		for (uint32_t shift = 0; shift < 35; shift += 7)
+		{
+			uint8_t byte = ReadRaw<uint8_t>();
+			if (!m_isValid)
+				break;
+
+			value |= (uint32_t)(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0)
+				return value;
+		}
+
+		m_isValid = false;
+		return 0;
+	}
+};
+
+void InputJournal::Begin(unsigned int seed, GameDifficulty difficulty, float timeStep)
+{
+	m_seed = seed;
+	m_difficulty = difficulty;
+	m_timeStep = timeStep;
+
+	m_actions.clear();
+	m_stateHashes.clear();
+
+	m_isRecording = true;
+}
+
+void InputJournal::RecordAction(const PlayerAction& action)
+{
+	if (!m_isRecording)
+		return;
+
+	m_actions.emplace_back(action);
+}
+
+void InputJournal::RecordStateHash(uint32_t tick, uint64_t hash)
+{
+	if (!m_isRecording)
+		return;
+
+	// Ticks are recorded in order, Pad in case a tick was skipped.
+	if (m_stateHashes.size() <= tick)
+		m_stateHashes.resize(tick + 1, 0);
+
+	m_stateHashes[tick] = hash;
+}
+
+bool InputJournal::Save(const char* pPath) const
+{
+	JournalBuffer buffer;
+	buffer.reserve(32 + m_actions.size() * 4 + m_stateHashes.size() * sizeof(uint64_t));
+
+	// Header
+	buffer.insert(buffer.end(), g_kJournalMagic, g_kJournalMagic + sizeof(g_kJournalMagic));
+	WriteRaw<uint16_t>(buffer, kVersion);
+	WriteRaw<uint16_t>(buffer, (uint16_t)m_difficulty);
+	WriteRaw<uint32_t>(buffer, m_seed);
+	WriteRaw<float>(buffer, m_timeStep);
+	WriteRaw<uint32_t>(buffer, (uint32_t)m_actions.size());
+	WriteRaw<uint32_t>(buffer, (uint32_t)m_stateHashes.size());
+
+	// Actions, Ticks are stored as the delta to the previous action.
+	uint32_t lastTick = 0;
+	for (const PlayerAction& action : m_actions)
+	{
+		WriteVarint(buffer, action.m_tick - lastTick);
+		WriteRaw<uint8_t>(buffer, (uint8_t)action.m_type);
+		WriteVarint(buffer, action.m_tileIndex);
+
+		lastTick = action.m_tick;
+	}
+
+	// Hashes
+	for (uint64_t hash : m_stateHashes)
+		WriteRaw<uint64_t>(buffer, hash);
+
+	std::ofstream file(pPath, std::ios::binary | std::ios::trunc);
+	if (!file)
+		return false;
+
+	file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+	return (bool)file;
+}
+
+bool InputJournal::Load(const char* pPath)
+{
+	std::ifstream file(pPath, std::ios::binary | std::ios::ate);
+	if (!file)
+		return false;
+
+	JournalBuffer buffer((size_t)file.tellg());
+	file.seekg(0);
+	file.read(reinterpret_cast<char*>(buffer.data()), buffer.size());
+	if (!file)
+		return false;
+
+	JournalReader reader(buffer);
+
+	char magic[sizeof(g_kJournalMagic)];
+	for (char& c : magic)
+		c = reader.ReadRaw<char>();
+
+	if (!reader.m_isValid || std::memcmp(magic, g_kJournalMagic, sizeof(magic)) != 0)
+		return false;
+
+	if (reader.ReadRaw<uint16_t>() != kVersion)
+		return false;
+
+	m_difficulty = (GameDifficulty)reader.ReadRaw<uint16_t>();
+	m_seed = reader.ReadRaw<uint32_t>();
+	m_timeStep = reader.ReadRaw<float>();
+
+	uint32_t actionCount = reader.ReadRaw<uint32_t>();
+	uint32_t hashCount = reader.ReadRaw<uint32_t>();
+
+	if (!reader.m_isValid)
+		return false;
+
+	m_actions.clear();
+	m_actions.reserve(actionCount);
+
+	uint32_t tick = 0;
+	for (uint32_t i = 0; i < actionCount && reader.m_isValid; ++i)
+	{
+		tick += reader.ReadVarint();
+
+		PlayerAction action;
+		action.m_tick = tick;
+		action.m_type = (PlayerActionType)reader.ReadRaw<uint8_t>();
+		action.m_tileIndex = reader.ReadVarint();
+
+		if (action.m_type >= PlayerActionType::kCount)
+			return false;
+
+		m_actions.emplace_back(action);
+	}
+
+	m_stateHashes.clear();
+	m_stateHashes.reserve(hashCount);
+
+	for (uint32_t i = 0; i < hashCount && reader.m_isValid; ++i)
+		m_stateHashes.emplace_back(reader.ReadRaw<uint64_t>());
+
+	m_isRecording = false;
+
+	return reader.m_isValid;
+}
+
+uint32_t InputJournal::GetTickCount() const
+{
+	uint32_t tickCount = (uint32_t)m_stateHashes.size();
+
+	if (!m_actions.empty())
+		tickCount = eastl::max(tickCount, m_actions.back().m_tick + 1);
+
+	return tickCount;
+}
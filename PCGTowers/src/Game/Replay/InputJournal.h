@@ -0,0 +1,77 @@
+#pragma once
+
+#include <Game/Replay/PlayerAction.h>
+#include <Game/GameDifficulty.h>
+
+#include <EASTL/vector.h>
+
+#include <cstdint>
+
+/// <summary>
+/// Records the player actions and the state hash of every tick of a game.
+/// Together with the world seed and difficulty that is enough to replay the game bit for bit.
+/// </summary>
+/// <format>
+/// Header	: "PCGR", version (u16), difficulty (u16), seed (u32), time step (f32), action count (u32), hash count (u32)
+/// Actions : tick delta (varint), type (u8), tile index (varint)
+/// Hashes	: state hash after every tick (u64)
+/// </format>
+class InputJournal
+{
+public:
+
+	static constexpr uint16_t kVersion = 1;
+
+	using Actions = eastl::vector<PlayerAction>;
+	using StateHashes = eastl::vector<uint64_t>;
+
+private:
+
+	unsigned int m_seed;
+	GameDifficulty m_difficulty;
+	float m_timeStep;
+
+	Actions m_actions;
+
+	/// <summary>
+	/// State hash after each tick, Indexed by tick.
+	/// </summary>
+	StateHashes m_stateHashes;
+
+	bool m_isRecording;
+
+public:
+
+	InputJournal()
+		: m_seed(0)
+		, m_difficulty(GameDifficulty::kNormal)
+		, m_timeStep(0.0f)
+		, m_isRecording(false)
+	{}
+
+	/// <summary>
+	/// Clears the journal and starts recording a new game.
+	/// </summary>
+	void Begin(unsigned int seed, GameDifficulty difficulty, float timeStep);
+
+	void Stop() { m_isRecording = false; }
+	bool IsRecording() const { return m_isRecording; }
+
+	void RecordAction(const PlayerAction& action);
+	void RecordStateHash(uint32_t tick, uint64_t hash);
+
+	bool Save(const char* pPath) const;
+	bool Load(const char* pPath);
+
+	unsigned int GetSeed() const { return m_seed; }
+	GameDifficulty GetDifficulty() const { return m_difficulty; }
+	float GetTimeStep() const { return m_timeStep; }
+
+	const Actions& GetActions() const { return m_actions; }
+	const StateHashes& GetStateHashes() const { return m_stateHashes; }
+
+	/// <summary>
+	/// Amount of ticks covered by the journal.
+	/// </summary>
+	uint32_t GetTickCount() const;
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+
+/// <summary>
+/// Everything the player can do that changes the simulation.
+/// </summary>
+enum struct PlayerActionType : uint8_t
+{
+	kBuyTurret,
+	kSellTurret,
+	kUpgradeTurret,
+	kPickUpTurret,	// Start dragging the turret on the tile.
+	kPlaceTurret,	// Drop the dragged turret on the tile.
+	kTogglePause,
+
+	// Cheats
+	kGiveGold,
+	kNextRound,
+	kKillEnemies,
+
+	// Appended so older journals keep their meaning.
+	kToggleMazing,	// Turrets can be built on paths and spawner paths route around them.
+	kCycleTargeting,	// Switch the turret on the tile to its next targeting mode.
+
+	kCount
+};
+
+/// <summary>
+/// A player action, Stamped with the tick it was applied before.
+/// </summary>
+struct PlayerAction
+{
+	uint32_t m_tick;
+	uint32_t m_tileIndex;
+	PlayerActionType m_type;
+
+	PlayerAction()
+		: PlayerAction(PlayerActionType::kCount, 0)
+	{}
+
+	PlayerAction(PlayerActionType type, uint32_t tileIndex)
+		: m_tick(0)
+		, m_tileIndex(tileIndex)
+		, m_type(type)
+	{}
+};
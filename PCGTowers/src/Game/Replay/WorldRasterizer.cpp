@@ -0,0 +1,310 @@
+#include "WorldRasterizer.h"
+
+#include <Config.h>
+
+#include <Game/TowerDefense/World.h>
+#include <Game/TowerDefense/Turret.h>
+#include <Game/TowerDefense/Enemy.h>
+
+#include <Utility/Profiler.h>
+
+#include <EASTL/algorithm.h>
+
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define PCG_SSE2 1
+	#include <emmintrin.h>
+#else
+	#define PCG_SSE2 0
+#endif
+
+static constexpr char g_kRasterMagic[4] = { 'P', 'C', 'G', 'X' };
+
+/// <summary>
+/// Offset of the frame count in the header, Written last since it is only known once the stream closes.
+/// </summary>
+static constexpr long g_kFrameCountOffset = 4 + 2 + 2 + 4 + 4 + 4;
+
+/// <summary>
+/// Channels that are averaged over the tiles of a cell, The others are summed.
+/// </summary>
+static bool IsAveragedChannel(RasterChannel channel)
+{
+	return channel == RasterChannel::kTurretCoverage || channel == RasterChannel::kPathCost || channel == RasterChannel::kMoisture;
+}
+
+void WorldRasterizer::SetScale(uint32_t scale)
+{
+	if (m_pFile)
+		return;
+
+	m_scale = eastl::max(1u, scale);
+
+	// Recomputed on the next raster.
+	m_mapWidth = 0;
+	m_mapHeight = 0;
+}
+
+void WorldRasterizer::Rasterize(const World& world)
+{
+	PCG_PROFILE_ZONE("WorldRasterizer::Rasterize");
+
+	const dragon::Vector2u kMapSize = world.GetTilemap().GetSize();
+	Resize(kMapSize.x, kMapSize.y);
+
+	eastl::fill(m_tiles.begin(), m_tiles.end(), 0.0f);
+
+	RasterizeTiles(world);
+	RasterizeTurrets(world);
+	RasterizeEnemies(world);
+
+	Downsample();
+
+	if (m_pFile)
+		WriteFrame(world.GetTick());
+}
+
+bool WorldRasterizer::OpenStream(const char* pPath)
+{
+	CloseStream();
+
+	m_pFile = std::fopen(pPath, "wb");
+	m_frameCount = 0;
+
+	return m_pFile != nullptr;
+}
+
+void WorldRasterizer::CloseStream()
+{
+	if (!m_pFile)
+		return;
+
+	if (m_frameCount > 0)
+	{
+		std::fseek(m_pFile, g_kFrameCountOffset, SEEK_SET);
+		std::fwrite(&m_frameCount, sizeof(m_frameCount), 1, m_pFile);
+	}
+
+	std::fclose(m_pFile);
+	m_pFile = nullptr;
+}
+
+void WorldRasterizer::Resize(uint32_t width, uint32_t height)
+{
+	if (width == m_mapWidth && height == m_mapHeight)
+		return;
+
+	m_mapWidth = width;
+	m_mapHeight = height;
+	m_tileStride = (width + 3) & ~3u;
+
+	m_width = (width + m_scale - 1) / m_scale;
+	m_height = (height + m_scale - 1) / m_scale;
+
+	m_tiles.resize(kChannelCount * m_mapHeight * m_tileStride);
+	m_rowSums.resize(m_tileStride);
+	m_cells.resize(kChannelCount * GetCellCount());
+	m_cellWeights.resize(GetCellCount());
+
+	for (uint32_t y = 0; y < m_height; ++y)
+	{
+		for (uint32_t x = 0; x < m_width; ++x)
+		{
+			uint32_t tilesX = eastl::min(m_scale, width - x * m_scale);
+			uint32_t tilesY = eastl::min(m_scale, height - y * m_scale);
+			m_cellWeights[(size_t)y * m_width + x] = 1.0f / (float)(tilesX * tilesY);
+		}
+	}
+}
+
+void WorldRasterizer::RasterizeTiles(const World& world)
+{
+	PCG_PROFILE_ZONE("WorldRasterizer::RasterizeTiles");
+
+	const TDTilemap& tilemap = world.GetTilemap();
+
+	float* pPathCost = GetTileChannel(RasterChannel::kPathCost);
+	float* pMoisture = GetTileChannel(RasterChannel::kMoisture);
+
+	for (uint32_t y = 0; y < m_mapHeight; ++y)
+	{
+		const size_t kRow = (size_t)y * m_tileStride;
+		for (uint32_t x = 0; x < m_mapWidth; ++x)
+		{
+			const TDTileData& tileData = tilemap.GetTileDataAtIndex((size_t)y * m_mapWidth + x);
+			pPathCost[kRow + x] = tileData.m_noise;
+			pMoisture[kRow + x] = tileData.m_moistureLevel;
+		}
+	}
+}
+
+void WorldRasterizer::RasterizeTurrets(const World& world)
+{
+	PCG_PROFILE_ZONE("WorldRasterizer::RasterizeTurrets");
+
+	float* pCoverage = GetTileChannel(RasterChannel::kTurretCoverage);
+
+	for (const auto& pair : world.GetTurrets())
+	{
+		const Turret* pTurret = pair.second;
+		const dragon::Vector2f kPosition = pTurret->GetPosition();
+		const float kRange = pTurret->GetRange();
+		const float kRangeSqrd = kRange * kRange;
+
+		// Tiles whose center can be in range, Clamped to the map.
+		int left = eastl::max(0, (int)std::floor((kPosition.x - kRange) / g_kTileSize));
+		int right = eastl::min((int)m_mapWidth - 1, (int)std::floor((kPosition.x + kRange) / g_kTileSize));
+		int top = eastl::max(0, (int)std::floor((kPosition.y - kRange) / g_kTileSize));
+		int bottom = eastl::min((int)m_mapHeight - 1, (int)std::floor((kPosition.y + kRange) / g_kTileSize));
+
+		if (left > right || top > bottom)
+			continue;
+
+		// Starts on a multiple of 4 so the rows are stamped 4 tiles at a time, The padding absorbs the overshoot on the right.
+		left &= ~3;
+
+		for (int y = top; y <= bottom; ++y)
+		{
+			float* pRow = pCoverage + (size_t)y * m_tileStride;
+			const float kDy = ((float)y + 0.5f) * g_kTileSize - kPosition.y;
+			int x = left;
+
+#if PCG_SSE2
+			const __m128 kDySqrd = _mm_set1_ps(kDy * kDy);
+			const __m128 kRangeSqrdWide = _mm_set1_ps(kRangeSqrd);
+			const __m128 kOne = _mm_set1_ps(1.0f);
+			const __m128 kStep = _mm_set1_ps(4.0f * g_kTileSize);
+			__m128 dx = _mm_sub_ps(_mm_setr_ps(
+				((float)x + 0.5f) * g_kTileSize,
+				((float)x + 1.5f) * g_kTileSize,
+				((float)x + 2.5f) * g_kTileSize,
+				((float)x + 3.5f) * g_kTileSize), _mm_set1_ps(kPosition.x));
+
+			for (; x <= right; x += 4)
+			{
+				__m128 distanceSqrd = _mm_add_ps(_mm_mul_ps(dx, dx), kDySqrd);
+				__m128 inRange = _mm_and_ps(_mm_cmplt_ps(distanceSqrd, kRangeSqrdWide), kOne);
+				_mm_storeu_ps(pRow + x, _mm_add_ps(_mm_loadu_ps(pRow + x), inRange));
+
+				dx = _mm_add_ps(dx, kStep);
+			}
+#endif
+
+			for (; x <= right; ++x)
+			{
+				const float kDx = ((float)x + 0.5f) * g_kTileSize - kPosition.x;
+				if (kDx * kDx + kDy * kDy < kRangeSqrd)
+					pRow[x] += 1.0f;
+			}
+		}
+	}
+}
+
+void WorldRasterizer::RasterizeEnemies(const World& world)
+{
+	PCG_PROFILE_ZONE("WorldRasterizer::RasterizeEnemies");
+
+	const TDTilemap& tilemap = world.GetTilemap();
+
+	float* pDensity = GetTileChannel(RasterChannel::kEnemyDensity);
+	float* pHealth = GetTileChannel(RasterChannel::kEnemyHealth);
+
+	for (const Enemy* pEnemy : world.GetEnemies())
+	{
+		dragon::Vector2 tilePosition = tilemap.WorldToMapCoordinates(pEnemy->GetPosition());
+		if (!tilemap.WithinBounds(tilePosition))
+			continue;
+
+		const size_t kTile = (size_t)tilePosition.y * m_tileStride + (size_t)tilePosition.x;
+		pDensity[kTile] += 1.0f;
+		pHealth[kTile] += pEnemy->GetHealth();
+	}
+}
+
+void WorldRasterizer::Downsample()
+{
+	PCG_PROFILE_ZONE("WorldRasterizer::Downsample");
+
+	const size_t kCellCount = GetCellCount();
+	float* pSums = m_rowSums.data();
+
+	for (size_t channel = 0; channel < kChannelCount; ++channel)
+	{
+		const float* pTiles = GetTileChannel((RasterChannel)channel);
+		float* pCells = m_cells.data() + channel * kCellCount;
+
+		for (uint32_t cellY = 0; cellY < m_height; ++cellY)
+		{
+			const uint32_t kTop = cellY * m_scale;
+			const uint32_t kBottom = eastl::min(kTop + m_scale, m_mapHeight);
+
+			// Add the tile rows of the cell row together, The stride is a multiple of 4.
+			std::memcpy(pSums, pTiles + (size_t)kTop * m_tileStride, m_tileStride * sizeof(float));
+			for (uint32_t y = kTop + 1; y < kBottom; ++y)
+			{
+				const float* pRow = pTiles + (size_t)y * m_tileStride;
+				uint32_t x = 0;
+#if PCG_SSE2
+				for (; x < m_tileStride; x += 4)
+					_mm_storeu_ps(pSums + x, _mm_add_ps(_mm_loadu_ps(pSums + x), _mm_loadu_ps(pRow + x)));
+#endif
+				for (; x < m_tileStride; ++x)
+					pSums[x] += pRow[x];
+			}
+
+			// Then the columns of every cell.
+			for (uint32_t cellX = 0; cellX < m_width; ++cellX)
+			{
+				const uint32_t kLeft = cellX * m_scale;
+				const uint32_t kRight = eastl::min(kLeft + m_scale, m_mapWidth);
+
+				float sum = 0.0f;
+				for (uint32_t x = kLeft; x < kRight; ++x)
+					sum += pSums[x];
+
+				pCells[(size_t)cellY * m_width + cellX] = sum;
+			}
+		}
+
+		if (!IsAveragedChannel((RasterChannel)channel))
+			continue;
+
+		size_t i = 0;
+#if PCG_SSE2
+		for (; i + 4 <= kCellCount; i += 4)
+			_mm_storeu_ps(pCells + i, _mm_mul_ps(_mm_loadu_ps(pCells + i), _mm_loadu_ps(m_cellWeights.data() + i)));
+#endif
+		for (; i < kCellCount; ++i)
+			pCells[i] *= m_cellWeights[i];
+	}
+}
+
+void WorldRasterizer::WriteHeader()
+{
+	const uint16_t kChannels = (uint16_t)kChannelCount;
+	const uint32_t kFrameCount = 0;
+
+	std::fwrite(g_kRasterMagic, sizeof(g_kRasterMagic), 1, m_pFile);
+	std::fwrite(&kVersion, sizeof(kVersion), 1, m_pFile);
+	std::fwrite(&kChannels, sizeof(kChannels), 1, m_pFile);
+	std::fwrite(&m_width, sizeof(m_width), 1, m_pFile);
+	std::fwrite(&m_height, sizeof(m_height), 1, m_pFile);
+	std::fwrite(&m_scale, sizeof(m_scale), 1, m_pFile);
+	std::fwrite(&kFrameCount, sizeof(kFrameCount), 1, m_pFile);
+}
+
+void WorldRasterizer::WriteFrame(uint32_t tick)
+{
+	PCG_PROFILE_ZONE("WorldRasterizer::WriteFrame");
+
+	// The first frame decides the size of the raster.
+	if (m_frameCount == 0)
+		WriteHeader();
+
+	std::fwrite(&tick, sizeof(tick), 1, m_pFile);
+	std::fwrite(m_cells.data(), sizeof(float), m_cells.size(), m_pFile);
+
+	++m_frameCount;
+}
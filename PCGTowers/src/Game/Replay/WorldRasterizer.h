@@ -0,0 +1,142 @@
+#pragma once
+
+#include <EASTL/vector.h>
+
+#include <cstdint>
+#include <cstdio>
+
+/// <summary>
+/// Layers of a raster, One float per cell.
+/// </summary>
+enum class RasterChannel : uint8_t
+{
+	kEnemyDensity,		// Enemies in the cell.
+	kEnemyHealth,		// Health of the enemies in the cell, Summed.
+	kTurretCoverage,	// Turrets in range of the tile centers, Averaged over the tiles of the cell.
+	kPathCost,			// Noise of the tiles, Which paths try to follow. Averaged.
+	kMoisture,			// Moisture level of the tiles, Averaged.
+
+	kCount
+};
+
+/// <summary>
+/// Turns the state of a world into a stack of grids for analysis, Without going through the renderer.
+/// Every cell covers [scale] by [scale] tiles, A scale of 1 gives one cell per tile.
+/// Rasters stay in memory until the next call to Rasterize and can be streamed to a file, One frame per call.
+/// </summary>
+/// <format>
+/// Header	: "PCGX", version (u16), channel count (u16), width (u32), height (u32), scale (u32), frame count (u32)
+/// Frames	: tick (u32), channel count * width * height cells (f32), One channel after another in row order
+/// </format>
+class WorldRasterizer
+{
+public:
+
+	static constexpr uint16_t kVersion = 1;
+	static constexpr size_t kChannelCount = (size_t)RasterChannel::kCount;
+
+private:
+
+	uint32_t m_scale;
+
+	// Size of the map in tiles, The tile rows are padded to a multiple of 4 floats.
+	uint32_t m_mapWidth;
+	uint32_t m_mapHeight;
+	uint32_t m_tileStride;
+
+	// Size of the raster in cells.
+	uint32_t m_width;
+	uint32_t m_height;
+
+	/// <summary>
+	/// Every channel at tile resolution, [channel][tile row][tile stride]. Reduced into the cells afterwards.
+	/// </summary>
+	eastl::vector<float> m_tiles;
+
+	/// <summary>
+	/// Tile rows of the cell row being reduced, Added up.
+	/// </summary>
+	eastl::vector<float> m_rowSums;
+
+	/// <summary>
+	/// [channel][cell]
+	/// </summary>
+	eastl::vector<float> m_cells;
+
+	/// <summary>
+	/// 1 / tiles in the cell, Cells along the far edges cover fewer tiles when the map isn't a multiple of the scale.
+	/// </summary>
+	eastl::vector<float> m_cellWeights;
+
+	std::FILE* m_pFile;
+	uint32_t m_frameCount;
+
+public:
+
+	WorldRasterizer()
+		: m_scale(1)
+		, m_mapWidth(0)
+		, m_mapHeight(0)
+		, m_tileStride(0)
+		, m_width(0)
+		, m_height(0)
+		, m_pFile(nullptr)
+		, m_frameCount(0)
+	{}
+
+	~WorldRasterizer() { CloseStream(); }
+
+	WorldRasterizer(const WorldRasterizer&) = delete;
+	WorldRasterizer& operator=(const WorldRasterizer&) = delete;
+
+	/// <summary>
+	/// Tiles along each edge of a cell, Can't change whilst streaming.
+	/// </summary>
+	void SetScale(uint32_t scale);
+
+	/// <summary>
+	/// Rasterizes [world] and appends it to the stream, If one is open.
+	/// </summary>
+	void Rasterize(const class World& world);
+
+	/// <summary>
+	/// Starts writing every raster to [pPath], The size of the raster is fixed by the first frame.
+	/// </summary>
+	bool OpenStream(const char* pPath);
+
+	/// <summary>
+	/// Writes the frame count and closes the file.
+	/// </summary>
+	void CloseStream();
+
+	/// <summary>
+	/// Cells of [channel] in row order, Valid until the next call to Rasterize.
+	/// </summary>
+	const float* GetChannel(RasterChannel channel) const { return m_cells.data() + (size_t)channel * GetCellCount(); }
+
+	uint32_t GetWidth() const { return m_width; }
+	uint32_t GetHeight() const { return m_height; }
+	size_t GetCellCount() const { return (size_t)m_width * m_height; }
+	uint32_t GetFrameCount() const { return m_frameCount; }
+
+private:
+
+	/// <summary>
+	/// Sizes the buffers for a map of [width] by [height] tiles, Only allocates when the size changed.
+	/// </summary>
+	void Resize(uint32_t width, uint32_t height);
+
+	float* GetTileChannel(RasterChannel channel) { return m_tiles.data() + (size_t)channel * m_mapHeight * m_tileStride; }
+
+	void RasterizeTiles(const class World& world);
+	void RasterizeTurrets(const class World& world);
+	void RasterizeEnemies(const class World& world);
+
+	/// <summary>
+	/// Sums the tiles of every cell, Then averages the channels that describe the terrain rather than count things.
+	/// </summary>
+	void Downsample();
+
+	void WriteHeader();
+	void WriteFrame(uint32_t tick);
+};
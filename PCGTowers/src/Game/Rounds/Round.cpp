@@ -5,6 +5,13 @@
 #include <Game/TowerDefense/World.h>
 #include <Game/TowerDefense/Spawner.h>
 
+#include <Game/Snapshot/SnapshotFormat.h>
+
+#include <Utility/StateHasher.h>
+#include <Utility/Profiler.h>
+
+#include <EASTL/algorithm.h>
+
 void Round::NextWave()
 {
 	if (m_currentWave + 1 > g_kWavesPerRound)
@@ -24,14 +31,19 @@ void Round::NextWave()
 	// Increase Wave Count
 	++m_currentWave;
 
-	WaveGenerator* pWaveGenerator = m_pWorld->GetDefaultWaveGenerator();
-	if (m_roundData.m_pWaveGenerator)
+	// Generate enemies on the spawners, unless they were staged already.
+	if (!m_isNextWavePrepared)
 	{
-		pWaveGenerator = m_roundData.m_pWaveGenerator;
+		WaveGenerator* pWaveGenerator = m_pWorld->GetDefaultWaveGenerator();
+		if (m_roundData.m_pWaveGenerator)
+		{
+			pWaveGenerator = m_roundData.m_pWaveGenerator;
+		}
+
+		pWaveGenerator->GenerateWaves(m_spawners, m_roundData.m_seed, (unsigned int)m_currentWave);
 	}
 
-	// Generate enemies on the spawners.
-	pWaveGenerator->GenerateWaves(m_spawners, m_roundData.m_seed, (unsigned int)m_currentWave);
+	m_isNextWavePrepared = false;
 
 	for (Spawner& spawner : m_spawners)
 	{
@@ -39,6 +51,33 @@ void Round::NextWave()
 	}
 }
 
+void Round::PrepareNextWave(WaveGenerator* pWaveGenerator)
+{
+	if (m_isNextWavePrepared || m_currentWave + 1 > g_kWavesPerRound)
+		return;
+
+	if (m_roundData.m_pWaveGenerator)
+	{
+		pWaveGenerator = m_roundData.m_pWaveGenerator;
+	}
+
+	pWaveGenerator->GenerateWaves(m_spawners, m_roundData.m_seed, (unsigned int)m_currentWave + 1);
+	m_isNextWavePrepared = true;
+}
+
+void Round::SetDifficulty(GameDifficulty difficulty)
+{
+	m_difficulty = difficulty;
+
+	if (difficulty != GameDifficulty::kNone)
+		m_base.m_health = g_kBaseHealth[(size_t)difficulty];
+}
+
+void Round::DamageBase(float damage)
+{
+	m_base.m_health = eastl::max(m_base.m_health - damage, 0.0f);
+}
+
 void Round::EndRound()
 {
 	Pause();
@@ -51,6 +90,7 @@ bool Round::HasFinished() const
 
 void Round::Update(float dt)
 {
+	PCG_PROFILE_ZONE("Round::Update");
 
 	if (!m_isPaused && m_currentWave < g_kWavesPerRound)
 	{
@@ -72,6 +112,32 @@ void Round::Update(float dt)
 	}
 }
 
+uint32_t Round::GetLiveEnemyCount() const
+{
+	uint32_t count = 0;
+	for (const Spawner& spawner : m_spawners)
+		count += spawner.GetLiveEnemyCount();
+
+	return count;
+}
+
+void Round::OnEnemyEvents(const EnemyEvents& events)
+{
+	for (Spawner& spawner : m_spawners)
+		spawner.OnEnemyEvents(events);
+
+	// Everything that got through this tick hits the base at once.
+	float damage = 0.0f;
+	for (const EnemyEvent& event : events)
+	{
+		if (event.m_type == EnemyEventType::kReachedGoal)
+			damage += event.m_damage;
+	}
+
+	if (damage > 0.0f)
+		DamageBase(damage);
+}
+
 void Round::Render(dragon::RenderTarget& target)
 {
 	// Update Spawners
@@ -81,6 +147,65 @@ void Round::Render(dragon::RenderTarget& target)
 	}
 }
 
+void Round::Hash(StateHasher& hasher) const
+{
+	hasher.Add(m_roundData.m_seed);
+	hasher.Add(m_roundData.m_temperature);
+	hasher.Add(m_roundData.m_precipitation);
+
+	hasher.Add(m_base.m_health);
+	hasher.Add(m_base.m_tilePosition.x);
+	hasher.Add(m_base.m_tilePosition.y);
+
+	hasher.Add(m_currentWave);
+	hasher.Add(m_waveTimer);
+	hasher.Add(m_isPaused);
+	hasher.Add(m_roundScore);
+	hasher.Add(m_waveScore);
+
+	for (const Spawner& spawner : m_spawners)
+		spawner.Hash(hasher);
+}
+
+void Round::Save(RoundRecord& record) const
+{
+	record.m_seed = m_roundData.m_seed;
+	record.m_temperature = m_roundData.m_temperature;
+	record.m_precipitation = m_roundData.m_precipitation;
+	record.m_difficulty = (uint32_t)m_difficulty;
+
+	record.m_currentWave = (uint32_t)m_currentWave;
+	record.m_waveTimer = m_waveTimer;
+	record.m_roundScore = m_roundScore;
+	record.m_waveScore = m_waveScore;
+
+	record.m_baseHealth = m_base.m_health;
+	record.m_baseX = m_base.m_tilePosition.x;
+	record.m_baseY = m_base.m_tilePosition.y;
+
+	record.m_isPaused = m_isPaused ? 1 : 0;
+	record.m_isNextWavePrepared = m_isNextWavePrepared ? 1 : 0;
+}
+
+void Round::Load(const RoundRecord& record)
+{
+	m_roundData.m_seed = record.m_seed;
+	m_roundData.m_temperature = record.m_temperature;
+	m_roundData.m_precipitation = record.m_precipitation;
+	m_difficulty = (GameDifficulty)record.m_difficulty;
+
+	m_currentWave = record.m_currentWave;
+	m_waveTimer = record.m_waveTimer;
+	m_roundScore = record.m_roundScore;
+	m_waveScore = record.m_waveScore;
+
+	m_base.m_health = record.m_baseHealth;
+	m_base.m_tilePosition = { record.m_baseX, record.m_baseY };
+
+	m_isPaused = record.m_isPaused != 0;
+	m_isNextWavePrepared = record.m_isNextWavePrepared != 0;
+}
+
 float Round::CalculateWaveScore(float time) const
 {
 	float difficultyTime = g_kWaveTimes[(size_t)m_difficulty];
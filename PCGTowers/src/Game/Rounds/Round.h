@@ -12,6 +12,9 @@ namespace dragon
 	class RenderTarget;
 }
 
+class StateHasher;
+struct RoundRecord;
+
 /// <summary>
 /// Round holds the map and state information for the round.
 /// </summary>
@@ -42,6 +45,11 @@ public:
 		/// </summary>
 		unsigned int m_seed;
 
+		/// <summary>
+		/// Difficulty of the world when the round was drawn, Carried along so staging doesn't read the world from its thread.
+		/// </summary>
+		GameDifficulty m_difficulty;
+
 		/// <summary>
 		/// The wave generator for this node.
 		/// </summary>
@@ -52,16 +60,18 @@ public:
 			, m_precipitation(0.0f)
 			, m_temperature(0.0f)
 			, m_seed(0)
+			, m_difficulty(GameDifficulty::kNone)
 		{}
 	};
 
+	using Spawners = eastl::vector<Spawner>;
+
 private:
 
 	RoundData m_roundData;
 
 	class World* m_pWorld;
 
-	using Spawners = eastl::vector<Spawner>;
 	Spawners m_spawners;
 
 	struct Base
@@ -86,6 +96,11 @@ private:
 	GameDifficulty m_difficulty;
 	bool m_isPaused;
 
+	/// <summary>
+	/// Wether the enemies of the next wave have already been generated. (See PrepareNextWave)
+	/// </summary>
+	bool m_isNextWavePrepared;
+
 	float m_roundScore;
 	float m_waveScore;
 
@@ -109,6 +124,7 @@ public:
 		, m_waveTimer(0.0f)
 		, m_difficulty(GameDifficulty::kNone)
 		, m_isPaused(true) // Round starts of paused.
+		, m_isNextWavePrepared(false)
 		, m_roundScore(0.0f)
 		, m_waveScore(0.0f)
 	{}
@@ -116,13 +132,23 @@ public:
 	template<typename... Args>
 	void EmplaceSpawner(Args... args) { m_spawners.emplace_back(eastl::forward<Args>(args)...); }
 
-	void SetDifficulty(GameDifficulty difficulty) { m_difficulty = difficulty; }
+	/// <summary>
+	/// Also gives the base the health it starts with on [difficulty].
+	/// </summary>
+	void SetDifficulty(GameDifficulty difficulty);
 
 	/// <summary>
 	/// Starts the next wave.
 	/// </summary>
 	void NextWave();
 
+	/// <summary>
+	/// Generates the enemies of the next wave ahead of time, NextWave will then only reset the timers.
+	/// Used to stage the first wave on the round staging thread.
+	/// </summary>
+	/// <param name="pWaveGenerator"></param>
+	void PrepareNextWave(class WaveGenerator* pWaveGenerator);
+
 	/// <summary>
 	/// Pauses the current round.
 	/// </summary>
@@ -153,6 +179,30 @@ public:
 	void AddWaveScore(float add) { m_waveScore += add; }
 
 	void SetBaseHealth(float health) { m_base.m_health = health; }
+	float GetBaseHealth() const { return m_base.m_health; }
+
+	/// <summary>
+	/// Takes [damage] off the base health, Which stops at 0.
+	/// </summary>
+	void DamageBase(float damage);
+
+	void SetBasePosition(dragon::Vector2 tilePosition) { m_base.m_tilePosition = tilePosition; }
+	dragon::Vector2 GetBasePosition() const { return m_base.m_tilePosition; }
+
+	const RoundData& GetRoundData() const { return m_roundData; }
+
+	Spawners& GetSpawners() { return m_spawners; }
+	const Spawners& GetSpawners() const { return m_spawners; }
+
+	/// <summary>
+	/// Enemies released by the spawners of this round that are still in the world.
+	/// </summary>
+	uint32_t GetLiveEnemyCount() const;
+
+	/// <summary>
+	/// Passes the enemies that died or despawned on to the spawners, Enemies that reached the goal damage the base.
+	/// </summary>
+	void OnEnemyEvents(const EnemyEvents& events);
 
 	void Update(float dt);
 
@@ -162,6 +212,14 @@ public:
 	/// <param name="target"></param>
 	void Render(dragon::RenderTarget& target);
 
+	void Hash(StateHasher& hasher) const;
+
+	/// <summary>
+	/// Saves the round state, Spawners are saved separately.
+	/// </summary>
+	void Save(RoundRecord& record) const;
+	void Load(const RoundRecord& record);
+
 private:
 
 	/// <summary>
@@ -0,0 +1,93 @@
+#include "RoundStager.h"
+
+#include <Config.h>
+
+#include <Utility/Profiler.h>
+
+#include <chrono>
+
+RoundStager::~RoundStager()
+{
+	Cancel();
+}
+
+bool RoundStager::Init()
+{
+	m_tilemap.Init({ g_kMapSize, g_kMapSize }, { g_kTileSize, g_kTileSize });
+
+	m_waveGenerator.InitDefaults();
+
+	return m_mapGenerator.Init();
+}
+
+void RoundStager::Stage(const Round::RoundData& data, StageJob&& job)
+{
+	// Only one round can be staged at a time.
+	Cancel();
+
+	m_stagedData = data;
+	m_isReady.store(false, std::memory_order_release);
+
+	m_worker = std::thread([this, job = eastl::move(job)]()
+	{
+		PCG_PROFILE_THREAD("Round Stager");
+		PCG_PROFILE_ZONE("RoundStager::Stage");
+
+		auto start = std::chrono::steady_clock::now();
+
+		m_pStagedRound = job(m_stagedData, m_mapGenerator, m_waveGenerator, m_tilemap);
+
+		std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+		m_stagingTime = elapsed.count();
+
+		m_isReady.store(true, std::memory_order_release);
+	});
+}
+
+Round* RoundStager::Acquire(TDTilemap& tilemap)
+{
+	if (!IsStaged())
+		return nullptr;
+
+	auto start = std::chrono::steady_clock::now();
+
+	// Worst case the game thread waits for the remainder of the generation.
+	Wait();
+
+	std::chrono::duration<float, std::milli> waited = std::chrono::steady_clock::now() - start;
+	m_waitTime = waited.count();
+
+	const dragon::Vector2u kMapSize = tilemap.GetSize();
+	const size_t kTileCount = (size_t)kMapSize.x * (size_t)kMapSize.y;
+
+	// Copy the staged buffers over.
+	for (size_t i = 0; i < kTileCount; ++i)
+	{
+		tilemap.SetTileAtIndex(i, m_tilemap.GetTileAtIndex(i));
+		tilemap.GetTileDataAtIndex(i) = m_tilemap.GetTileDataAtIndex(i);
+	}
+
+	Round* pRound = m_pStagedRound;
+	m_pStagedRound = nullptr;
+	m_isReady.store(false, std::memory_order_release);
+
+	std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	m_swapTime = elapsed.count();
+
+	return pRound;
+}
+
+void RoundStager::Cancel()
+{
+	Wait();
+
+	delete m_pStagedRound;
+	m_pStagedRound = nullptr;
+	m_isReady.store(false, std::memory_order_release);
+}
+
+void RoundStager::Wait()
+{
+	if (m_worker.joinable())
+		m_worker.join();
+}
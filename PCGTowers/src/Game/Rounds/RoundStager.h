@@ -0,0 +1,114 @@
+#pragma once
+
+#include <Game/Generators/MapGenerator.h>
+#include <Game/Generators/WaveGenerator.h>
+#include <Game/TowerDefense/TDTilemap.h>
+#include <Game/Rounds/Round.h>
+
+#include <EASTL/functional.h>
+
+#include <atomic>
+#include <thread>
+
+/// <summary>
+/// Speculatively generates the next round on a worker thread whilst the current round is being played.
+/// The worker owns its own generators and tilemap so it never touches the state of the playing round.
+/// </summary>
+class RoundStager
+{
+public:
+
+	/// <summary>
+	/// Generates a round into the given generators and tilemap, Must not touch any state shared with the game thread.
+	/// </summary>
+	using StageJob = eastl::function<Round*(const Round::RoundData&, MapGenerator&, WaveGenerator&, TDTilemap&)>;
+
+private:
+
+	// Staging buffers, Only touched by the worker while a job is in flight.
+	MapGenerator m_mapGenerator;
+	WaveGenerator m_waveGenerator;
+	TDTilemap m_tilemap;
+
+	std::thread m_worker;
+
+	/// <summary>
+	/// Data the staged round was generated with.
+	/// </summary>
+	Round::RoundData m_stagedData;
+
+	/// <summary>
+	/// The round generated by the worker, nullptr until the worker has finished.
+	/// </summary>
+	Round* m_pStagedRound;
+
+	/// <summary>
+	/// Time in milliseconds the worker spent generating the staged round.
+	/// </summary>
+	float m_stagingTime;
+
+	/// <summary>
+	/// Time in milliseconds it took to swap the last staged round in.
+	/// </summary>
+	float m_swapTime;
+
+	/// <summary>
+	/// Part of [m_swapTime] spent waiting for the worker to finish, 0 if it was done before the swap.
+	/// </summary>
+	float m_waitTime;
+
+	std::atomic<bool> m_isReady;
+
+public:
+
+	RoundStager()
+		: m_pStagedRound(nullptr)
+		, m_stagingTime(0.0f)
+		, m_swapTime(0.0f)
+		, m_waitTime(0.0f)
+		, m_isReady(false)
+	{}
+
+	~RoundStager();
+
+	RoundStager(const RoundStager&) = delete;
+	RoundStager& operator=(const RoundStager&) = delete;
+
+	bool Init();
+
+	/// <summary>
+	/// Starts generating a round on the worker thread. Discards any previously staged round.
+	/// </summary>
+	void Stage(const Round::RoundData& data, StageJob&& job);
+
+	/// <summary>
+	/// Wether or not a round has been staged (it may still be generating).
+	/// </summary>
+	bool IsStaged() const { return m_worker.joinable() || m_pStagedRound; }
+
+	/// <summary>
+	/// Wether or not the worker has finished generating the staged round.
+	/// </summary>
+	bool IsReady() const { return m_isReady.load(std::memory_order_acquire); }
+
+	/// <summary>
+	/// Waits for the staged round, copies the staged tiles into [tilemap] and hands over ownership of the round.
+	/// Returns nullptr if nothing was staged.
+	/// </summary>
+	Round* Acquire(TDTilemap& tilemap);
+
+	/// <summary>
+	/// Waits for the worker and throws away the staged round.
+	/// </summary>
+	void Cancel();
+
+	const Round::RoundData& GetStagedData() const { return m_stagedData; }
+
+	float GetStagingTime() const { return m_stagingTime; }
+	float GetSwapTime() const { return m_swapTime; }
+	float GetWaitTime() const { return m_waitTime; }
+
+private:
+
+	void Wait();
+};
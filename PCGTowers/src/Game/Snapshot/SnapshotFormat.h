@@ -0,0 +1,175 @@
+#pragma once
+
+#include <cstdint>
+
+/// <summary>
+/// Binary layout of a World snapshot.
+/// 
+/// A snapshot is a header followed by sections of fixed size records, Every section starts 16 byte aligned.
+/// The whole file can be memory mapped and validated from the header alone (sizes, bounds and a checksum),
+/// After which every section is a plain array that is read in place without parsing individual objects.
+/// </summary>
+/// <notes>
+/// Records are written in the native byte order, Snapshots are meant for the machine (or build farm) that wrote them.
+/// Bump g_kSnapshotVersion whenever a record changes.
+/// </notes>
+
+static constexpr char g_kSnapshotMagic[4] = { 'P', 'C', 'G', 'S' };
+static constexpr uint32_t g_kSnapshotVersion = 3;
+static constexpr uint64_t g_kSnapshotAlignment = 16;
+
+enum struct SnapshotSectionType : uint32_t
+{
+	kWorld,			// WorldRecord, Exactly one.
+	kTiles,			// dragon::TileID per tile.
+	kTileData,		// TileDataRecord per tile.
+	kRound,			// RoundRecord, Zero or one.
+	kSpawners,		// SpawnerRecord per spawner of the round.
+	kPathPoints,	// PathPointRecord, The paths of all spawners back to back.
+	kSpawnGroups,	// SpawnGroupRecord, The queued groups of all spawners back to back.
+	kEnemies,		// EnemyRecord per enemy.
+	kTurrets,		// TurretRecord per turret.
+
+	kCount
+};
+
+struct SnapshotSection
+{
+	uint64_t m_offset;		// Offset from the start of the file.
+	uint32_t m_count;		// Amount of records.
+	uint32_t m_recordSize;	// Size of a single record, Must match the reader's record.
+};
+
+struct SnapshotHeader
+{
+	char m_magic[4];
+	uint32_t m_version;
+	uint64_t m_fileSize;
+	uint64_t m_checksum;	// FNV-1a of everything after the header.
+	uint32_t m_sectionCount;
+	uint32_t m_padding;
+
+	SnapshotSection m_sections[(size_t)SnapshotSectionType::kCount];
+};
+
+struct WorldRecord
+{
+	uint32_t m_worldSeed;
+	uint32_t m_roundCount;
+	uint32_t m_tick;
+	uint32_t m_difficulty;
+
+	// World random state.
+	uint32_t m_randomStreamSeed;
+	uint32_t m_randomIndex;
+
+	uint32_t m_mapWidth;
+	uint32_t m_mapHeight;
+
+	float m_playerGold;
+	float m_score;
+	float m_tickAccumulator;
+	uint32_t m_isMazingEnabled;
+};
+
+/// <summary>
+/// TDTileData without the padding after its bool, So the same state always writes the same bytes.
+/// </summary>
+struct TileDataRecord
+{
+	float m_noise;
+	float m_temperature;
+	float m_moistureLevel;
+	uint32_t m_biome;
+	uint32_t m_isTurretPlaceable;
+};
+
+struct RoundRecord
+{
+	uint32_t m_seed;
+	float m_temperature;
+	float m_precipitation;
+	uint32_t m_difficulty;
+
+	uint32_t m_currentWave;
+	float m_waveTimer;
+	float m_roundScore;
+	float m_waveScore;
+
+	float m_baseHealth;
+	int32_t m_baseX;
+	int32_t m_baseY;
+
+	uint32_t m_isPaused;
+	uint32_t m_isNextWavePrepared;
+	uint32_t m_padding[3];
+};
+
+struct SpawnerRecord
+{
+	int32_t m_x;
+	int32_t m_y;
+
+	float m_timeBetweenGroups;
+	float m_timeBetweenEnemiesForGroup;
+	float m_currentGroupTime;
+	float m_currentEnemyTime;
+
+	uint32_t m_firstPathPoint;
+	uint32_t m_pathPointCount;
+	uint32_t m_firstGroup;
+	uint32_t m_groupCount;
+};
+
+struct PathPointRecord
+{
+	float m_x;
+	float m_y;
+};
+
+/// <summary>
+/// SpawnDescriptor without the padding after its char.
+/// </summary>
+struct SpawnGroupRecord
+{
+	uint32_t m_enemyType;
+	uint32_t m_count;
+	uint32_t m_spawned;
+	uint32_t m_statsSeed;
+};
+
+struct EnemyRecord
+{
+	float m_x;
+	float m_y;
+	float m_health;
+
+	float m_speed;
+	float m_damage;
+	float m_maxHealth;
+
+	float m_color[4];
+
+	uint32_t m_nextTile;
+	int32_t m_spawnerIndex;	// Spawner whose path the enemy follows, -1 if none.
+	uint32_t m_shape;
+	uint32_t m_isPending;	// Spawned this tick, But not yet added to the world.
+};
+
+struct TurretRecord
+{
+	uint32_t m_tileIndex;
+
+	float m_x;
+	float m_y;
+	float m_damage;
+	float m_range;
+	float m_cooldown;
+	float m_lastDamageTime;
+
+	uint32_t m_upgradeLevel;
+	uint32_t m_isEnabled;
+	uint32_t m_isMoving;	// Turret was being dragged by the player.
+	int32_t m_targetEnemy;	// Index into the enemy section, -1 if none.
+	uint32_t m_targetingMode;	// Was padding, Older snapshots load as kClosest.
+};
@@ -0,0 +1,492 @@
+#include "WorldSnapshot.h"
+
+#include <Game/TowerDefense/World.h>
+#include <Game/TowerDefense/Turret.h>
+#include <Game/TowerDefense/Enemy.h>
+#include <Game/TowerDefense/Spawner.h>
+#include <Game/Rounds/Round.h>
+
+#include <Utility/MappedFile.h>
+#include <Utility/StateHasher.h>
+
+#include <EASTL/vector.h>
+#include <EASTL/unordered_map.h>
+#include <EASTL/sort.h>
+
+#include <cstring>
+#include <fstream>
+
+/// <summary>
+/// Record size of every section, A snapshot written by a build with different records is rejected.
+/// </summary>
+static constexpr uint32_t g_kRecordSizes[] =
+{
+	sizeof(WorldRecord),
+	sizeof(dragon::TileID),
+	sizeof(TileDataRecord),
+	sizeof(RoundRecord),
+	sizeof(SpawnerRecord),
+	sizeof(PathPointRecord),
+	sizeof(SpawnGroupRecord),
+	sizeof(EnemyRecord),
+	sizeof(TurretRecord),
+};
+
+static_assert(sizeof(g_kRecordSizes) / sizeof(g_kRecordSizes[0]) == (size_t)SnapshotSectionType::kCount, "Every section needs a record size.");
+
+using SnapshotBuffer = eastl::vector<uint8_t>;
+
+/// <summary>
+/// Appends a section to the snapshot, Aligned to g_kSnapshotAlignment.
+/// </summary>
+template<typename Record>
+static void WriteSection(SnapshotBuffer& buffer, SnapshotHeader& header, SnapshotSectionType type, const eastl::vector<Record>& records)
+{
+	size_t alignedSize = (buffer.size() + g_kSnapshotAlignment - 1) & ~(size_t)(g_kSnapshotAlignment - 1);
+	buffer.resize(alignedSize, 0);
+
+	SnapshotSection& section = header.m_sections[(size_t)type];
+	section.m_offset = buffer.size();
+	section.m_count = (uint32_t)records.size();
+	section.m_recordSize = (uint32_t)sizeof(Record);
+
+	const uint8_t* pBytes = reinterpret_cast<const uint8_t*>(records.data());
+	buffer.insert(buffer.end(), pBytes, pBytes + records.size() * sizeof(Record));
+}
+
+/// <summary>
+/// Gets a section of a validated snapshot.
+/// </summary>
+template<typename Record>
+static const Record* GetSection(const uint8_t* pData, const SnapshotHeader& header, SnapshotSectionType type, uint32_t& count)
+{
+	const SnapshotSection& section = header.m_sections[(size_t)type];
+	count = section.m_count;
+	return reinterpret_cast<const Record*>(pData + section.m_offset);
+}
+
+static uint64_t ComputeChecksum(const uint8_t* pData, size_t size)
+{
+	StateHasher hasher;
+	hasher.AddBytes(pData + sizeof(SnapshotHeader), size - sizeof(SnapshotHeader));
+	return hasher.GetHash();
+}
+
+bool WorldSnapshot::Save(const World& world, const char* pPath)
+{
+	SnapshotHeader header;
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.m_magic, g_kSnapshotMagic, sizeof(header.m_magic));
+	header.m_version = g_kSnapshotVersion;
+	header.m_sectionCount = (uint32_t)SnapshotSectionType::kCount;
+
+	const dragon::Vector2u kMapSize = world.m_tilemap.GetSize();
+	const size_t kTileCount = (size_t)kMapSize.x * (size_t)kMapSize.y;
+
+	// World
+	eastl::vector<WorldRecord> worldRecords(1);
+	{
+		WorldRecord& record = worldRecords[0];
+		std::memset(&record, 0, sizeof(record));
+
+		record.m_worldSeed = world.m_worldSeed;
+		record.m_roundCount = world.m_roundCount;
+		record.m_tick = world.m_tick;
+		record.m_difficulty = (uint32_t)world.m_difficulty;
+		record.m_randomStreamSeed = world.m_random.GetStreamSeed();
+		record.m_randomIndex = world.m_random.GetIndex();
+		record.m_mapWidth = kMapSize.x;
+		record.m_mapHeight = kMapSize.y;
+		record.m_playerGold = world.m_playerGold;
+		record.m_score = world.m_score;
+		record.m_isMazingEnabled = world.m_isMazingEnabled ? 1 : 0;
+		record.m_tickAccumulator = world.m_tickAccumulator;
+	}
+
+	// Tilemap
+	eastl::vector<dragon::TileID> tiles(kTileCount);
+	eastl::vector<TileDataRecord> tileData(kTileCount);
+	for (size_t i = 0; i < kTileCount; ++i)
+	{
+		tiles[i] = world.m_tilemap.GetTileAtIndex(i);
+
+		const TDTileData& data = world.m_tilemap.GetTileDataAtIndex(i);
+		TileDataRecord& record = tileData[i];
+		std::memset(&record, 0, sizeof(record));
+		record.m_noise = data.m_noise;
+		record.m_temperature = data.m_temperature;
+		record.m_moistureLevel = data.m_moistureLevel;
+		record.m_biome = (uint32_t)data.m_biome;
+		record.m_isTurretPlaceable = data.m_isTurretPlaceable ? 1 : 0;
+	}
+
+	// Round and spawners
+	eastl::vector<RoundRecord> roundRecords;
+	eastl::vector<SpawnerRecord> spawnerRecords;
+	eastl::vector<PathPointRecord> pathPoints;
+	eastl::vector<SpawnGroupRecord> spawnGroups;
+
+	// Enemies refer to the spawner whose path they follow.
+	eastl::unordered_map<const Path*, int32_t> spawnerOfPath;
+
+	if (const Round* pRound = world.m_pCurrentRound)
+	{
+		roundRecords.resize(1);
+		std::memset(&roundRecords[0], 0, sizeof(RoundRecord));
+		pRound->Save(roundRecords[0]);
+
+		const Round::Spawners& spawners = pRound->GetSpawners();
+		for (size_t i = 0; i < spawners.size(); ++i)
+		{
+			const Spawner& spawner = spawners[i];
+
+			SpawnerRecord record;
+			std::memset(&record, 0, sizeof(record));
+			spawner.Save(record);
+
+			record.m_firstPathPoint = (uint32_t)pathPoints.size();
+			record.m_pathPointCount = (uint32_t)spawner.GetPath().size();
+			for (const dragon::Vector2f& point : spawner.GetPath())
+				pathPoints.push_back({ point.x, point.y });
+
+			record.m_firstGroup = (uint32_t)spawnGroups.size();
+			record.m_groupCount = (uint32_t)spawner.GetGroups().size();
+			for (const SpawnDescriptor& group : spawner.GetGroups().get_container())
+			{
+				SpawnGroupRecord groupRecord;
+				std::memset(&groupRecord, 0, sizeof(groupRecord));
+				groupRecord.m_enemyType = (uint32_t)(uint8_t)group.m_enemyType;
+				groupRecord.m_count = group.m_count;
+				groupRecord.m_spawned = group.m_spawned;
+				groupRecord.m_statsSeed = group.m_statsSeed;
+				spawnGroups.push_back(groupRecord);
+			}
+
+			spawnerRecords.push_back(record);
+			spawnerOfPath[&spawner.GetPath()] = (int32_t)i;
+		}
+	}
+
+	// Enemies, Pending enemies are stored after the active ones.
+	eastl::vector<EnemyRecord> enemyRecords;
+	eastl::unordered_map<const Enemy*, int32_t> enemyIndices;
+
+	auto saveEnemies = [&](const World::Enemies& enemies, bool isPending)
+	{
+		for (const Enemy* pEnemy : enemies)
+		{
+			EnemyRecord record;
+			std::memset(&record, 0, sizeof(record));
+			pEnemy->Save(record);
+
+			auto it = spawnerOfPath.find(pEnemy->GetPath());
+			record.m_spawnerIndex = it != spawnerOfPath.end() ? it->second : -1;
+			record.m_isPending = isPending ? 1 : 0;
+
+			enemyIndices[pEnemy] = (int32_t)enemyRecords.size();
+			enemyRecords.push_back(record);
+		}
+	};
+
+	saveEnemies(world.m_enemies, false);
+	saveEnemies(world.m_enemiesToAdd, true);
+
+	// Turrets, Stored in tile order.
+	eastl::vector<TurretRecord> turretRecords;
+
+	auto saveTurret = [&](const Turret* pTurret, uint32_t tileIndex, bool isMoving)
+	{
+		TurretRecord record;
+		std::memset(&record, 0, sizeof(record));
+		pTurret->Save(record, world.m_tick, g_kFixedTimeStep);
+
+		record.m_tileIndex = tileIndex;
+		record.m_isMoving = isMoving ? 1 : 0;
+
+		auto it = enemyIndices.find(world.m_enemyRegistry.Resolve(pTurret->GetTarget()));
+		record.m_targetEnemy = it != enemyIndices.end() ? it->second : -1;
+
+		turretRecords.push_back(record);
+	};
+
+	for (const auto& pair : world.m_turrets)
+		saveTurret(pair.second, (uint32_t)pair.first, false);
+
+	eastl::sort(turretRecords.begin(), turretRecords.end(), [](const TurretRecord& left, const TurretRecord& right)
+	{
+		return left.m_tileIndex < right.m_tileIndex;
+	});
+
+	if (world.m_pMovingTurret)
+		saveTurret(world.m_pMovingTurret, 0, true);
+
+	// Write out the sections.
+	SnapshotBuffer buffer(sizeof(SnapshotHeader), 0);
+	WriteSection(buffer, header, SnapshotSectionType::kWorld, worldRecords);
+	WriteSection(buffer, header, SnapshotSectionType::kTiles, tiles);
+	WriteSection(buffer, header, SnapshotSectionType::kTileData, tileData);
+	WriteSection(buffer, header, SnapshotSectionType::kRound, roundRecords);
+	WriteSection(buffer, header, SnapshotSectionType::kSpawners, spawnerRecords);
+	WriteSection(buffer, header, SnapshotSectionType::kPathPoints, pathPoints);
+	WriteSection(buffer, header, SnapshotSectionType::kSpawnGroups, spawnGroups);
+	WriteSection(buffer, header, SnapshotSectionType::kEnemies, enemyRecords);
+	WriteSection(buffer, header, SnapshotSectionType::kTurrets, turretRecords);
+
+	header.m_fileSize = buffer.size();
+	header.m_checksum = ComputeChecksum(buffer.data(), buffer.size());
+	std::memcpy(buffer.data(), &header, sizeof(header));
+
+	std::ofstream file(pPath, std::ios::binary | std::ios::trunc);
+	if (!file)
+		return false;
+
+	file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+	return (bool)file;
+}
+
+const SnapshotHeader* WorldSnapshot::Validate(const uint8_t* pData, size_t size)
+{
+	if (!pData || size < sizeof(SnapshotHeader))
+		return nullptr;
+
+	const SnapshotHeader* pHeader = reinterpret_cast<const SnapshotHeader*>(pData);
+
+	if (std::memcmp(pHeader->m_magic, g_kSnapshotMagic, sizeof(g_kSnapshotMagic)) != 0)
+		return nullptr;
+
+	if (pHeader->m_version != g_kSnapshotVersion || pHeader->m_fileSize != size)
+		return nullptr;
+
+	if (pHeader->m_sectionCount != (uint32_t)SnapshotSectionType::kCount)
+		return nullptr;
+
+	for (size_t i = 0; i < (size_t)SnapshotSectionType::kCount; ++i)
+	{
+		const SnapshotSection& section = pHeader->m_sections[i];
+
+		if (section.m_recordSize != g_kRecordSizes[i])
+			return nullptr;
+
+		if (section.m_offset % g_kSnapshotAlignment != 0 || section.m_offset < sizeof(SnapshotHeader))
+			return nullptr;
+
+		// Checked without adding to the offset, Which comes from the file and could wrap around.
+		if (section.m_offset > size || section.m_count > (size - section.m_offset) / section.m_recordSize)
+			return nullptr;
+	}
+
+	// Exactly one world.
+	if (pHeader->m_sections[(size_t)SnapshotSectionType::kWorld].m_count != 1)
+		return nullptr;
+
+	if (pHeader->m_sections[(size_t)SnapshotSectionType::kRound].m_count > 1)
+		return nullptr;
+
+	if (ComputeChecksum(pData, size) != pHeader->m_checksum)
+		return nullptr;
+
+	return pHeader;
+}
+
+bool WorldSnapshot::Load(World& world, const char* pPath)
+{
+	MappedFile file;
+	if (!file.Open(pPath))
+		return false;
+
+	const uint8_t* pData = file.GetData();
+	const SnapshotHeader* pHeader = Validate(pData, file.GetSize());
+	if (!pHeader)
+		return false;
+
+	uint32_t count = 0;
+
+	const WorldRecord& worldRecord = *GetSection<WorldRecord>(pData, *pHeader, SnapshotSectionType::kWorld, count);
+
+	const dragon::Vector2u kMapSize = world.m_tilemap.GetSize();
+	if (worldRecord.m_mapWidth != kMapSize.x || worldRecord.m_mapHeight != kMapSize.y)
+		return false;
+
+	const size_t kTileCount = (size_t)kMapSize.x * (size_t)kMapSize.y;
+
+	uint32_t tileCount = 0;
+	uint32_t tileDataCount = 0;
+	const dragon::TileID* pTiles = GetSection<dragon::TileID>(pData, *pHeader, SnapshotSectionType::kTiles, tileCount);
+	const TileDataRecord* pTileData = GetSection<TileDataRecord>(pData, *pHeader, SnapshotSectionType::kTileData, tileDataCount);
+	if (tileCount != kTileCount || tileDataCount != kTileCount)
+		return false;
+
+	uint32_t roundCount = 0;
+	uint32_t spawnerCount = 0;
+	uint32_t pathPointCount = 0;
+	uint32_t groupCount = 0;
+	const RoundRecord* pRoundRecord = GetSection<RoundRecord>(pData, *pHeader, SnapshotSectionType::kRound, roundCount);
+	const SpawnerRecord* pSpawners = GetSection<SpawnerRecord>(pData, *pHeader, SnapshotSectionType::kSpawners, spawnerCount);
+	const PathPointRecord* pPathPoints = GetSection<PathPointRecord>(pData, *pHeader, SnapshotSectionType::kPathPoints, pathPointCount);
+	const SpawnGroupRecord* pGroups = GetSection<SpawnGroupRecord>(pData, *pHeader, SnapshotSectionType::kSpawnGroups, groupCount);
+
+	uint32_t enemyCount = 0;
+	uint32_t turretCount = 0;
+	const EnemyRecord* pEnemies = GetSection<EnemyRecord>(pData, *pHeader, SnapshotSectionType::kEnemies, enemyCount);
+	const TurretRecord* pTurrets = GetSection<TurretRecord>(pData, *pHeader, SnapshotSectionType::kTurrets, turretCount);
+
+	// Cross section references must be in range before anything is touched.
+	for (uint32_t i = 0; i < spawnerCount; ++i)
+	{
+		if ((uint64_t)pSpawners[i].m_firstPathPoint + pSpawners[i].m_pathPointCount > pathPointCount ||
+			(uint64_t)pSpawners[i].m_firstGroup + pSpawners[i].m_groupCount > groupCount)
+			return false;
+	}
+
+	for (uint32_t i = 0; i < enemyCount; ++i)
+	{
+		if (pEnemies[i].m_spawnerIndex >= (int32_t)spawnerCount)
+			return false;
+	}
+
+	for (uint32_t i = 0; i < turretCount; ++i)
+	{
+		if (pTurrets[i].m_targetEnemy >= (int32_t)enemyCount || (!pTurrets[i].m_isMoving && pTurrets[i].m_tileIndex >= kTileCount))
+			return false;
+	}
+
+	//
+	// Tear down the current game.
+	//
+
+	world.m_roundStager.Cancel();
+	world.ClearEnemies();
+
+	// Nothing left to score, The spawners they came from are torn down as well.
+	world.m_enemyEvents.Discard();
+
+	for (auto& pair : world.m_turrets)
+		delete pair.second;
+	world.m_turrets.clear();
+	world.m_awakeTurrets.clear();
+
+	delete world.m_pMovingTurret;
+	world.m_pMovingTurret = nullptr;
+
+	delete world.m_pCurrentRound;
+	world.m_pCurrentRound = nullptr;
+
+	//
+	// Restore
+	//
+
+	world.m_worldSeed = worldRecord.m_worldSeed;
+	world.m_roundCount = worldRecord.m_roundCount;
+	world.m_tick = worldRecord.m_tick;
+	world.m_difficulty = (GameDifficulty)worldRecord.m_difficulty;
+	world.m_random.SetState(worldRecord.m_randomStreamSeed, worldRecord.m_randomIndex);
+	world.m_playerGold = worldRecord.m_playerGold;
+	world.m_score = worldRecord.m_score;
+	world.m_isMazingEnabled = worldRecord.m_isMazingEnabled != 0;
+	world.m_tickAccumulator = worldRecord.m_tickAccumulator;
+
+	for (size_t i = 0; i < kTileCount; ++i)
+	{
+		world.m_tilemap.SetTileAtIndex(i, pTiles[i]);
+
+		TDTileData& data = world.m_tilemap.GetTileDataAtIndex(i);
+		data.m_noise = pTileData[i].m_noise;
+		data.m_temperature = pTileData[i].m_temperature;
+		data.m_moistureLevel = pTileData[i].m_moistureLevel;
+		data.m_biome = (BiomeType)pTileData[i].m_biome;
+		data.m_isTurretPlaceable = pTileData[i].m_isTurretPlaceable != 0;
+	}
+
+	if (roundCount == 1)
+	{
+		Round::RoundData roundData;
+		Round* pRound = new Round(roundData, &world);
+		pRound->Load(*pRoundRecord);
+
+		for (uint32_t i = 0; i < spawnerCount; ++i)
+		{
+			const SpawnerRecord& record = pSpawners[i];
+
+			Path path;
+			path.reserve(record.m_pathPointCount);
+			for (uint32_t point = 0; point < record.m_pathPointCount; ++point)
+			{
+				const PathPointRecord& pathPoint = pPathPoints[record.m_firstPathPoint + point];
+				path.emplace_back(pathPoint.m_x, pathPoint.m_y);
+			}
+
+			pRound->EmplaceSpawner(&world, dragon::Vector2(record.m_x, record.m_y), eastl::move(path));
+
+			Spawner& spawner = pRound->GetSpawners().back();
+			spawner.Load(record);
+			spawner.SetWaveGenerator(world.m_pDefaultWaveGenerator);
+
+			for (uint32_t group = 0; group < record.m_groupCount; ++group)
+			{
+				const SpawnGroupRecord& groupRecord = pGroups[record.m_firstGroup + group];
+
+				SpawnDescriptor descriptor((char)groupRecord.m_enemyType, groupRecord.m_count, groupRecord.m_statsSeed);
+				descriptor.m_spawned = groupRecord.m_spawned;
+				spawner.EmplaceEnemyGroup(descriptor);
+			}
+		}
+
+		world.m_pCurrentRound = pRound;
+	}
+
+	// Enemies, After all spawners exist so their paths no longer move.
+	eastl::vector<Enemy*> enemies;
+	enemies.reserve(enemyCount);
+
+	for (uint32_t i = 0; i < enemyCount; ++i)
+	{
+		const EnemyRecord& record = pEnemies[i];
+
+		const Path* pPath = nullptr;
+		if (record.m_spawnerIndex >= 0 && world.m_pCurrentRound)
+			pPath = &world.m_pCurrentRound->GetSpawners()[record.m_spawnerIndex].GetPath();
+
+		Enemy* pEnemy = new Enemy();
+		pEnemy->Load(record, pPath);
+		world.m_enemyRegistry.Register(pEnemy);
+		enemies.emplace_back(pEnemy);
+
+		if (pPath)
+			world.m_pCurrentRound->GetSpawners()[record.m_spawnerIndex].AddLiveEnemy();
+
+		if (record.m_isPending)
+			world.m_enemiesToAdd.emplace_back(pEnemy);
+		else
+			world.m_enemies.emplace_back(pEnemy);
+	}
+
+	for (uint32_t i = 0; i < turretCount; ++i)
+	{
+		const TurretRecord& record = pTurrets[i];
+
+		Turret* pTurret = new Turret();
+		pTurret->Load(record);
+
+		if (record.m_targetEnemy >= 0)
+			pTurret->SetTarget(enemies[record.m_targetEnemy]->GetHandle());
+
+		if (record.m_isMoving)
+			world.m_pMovingTurret = pTurret;
+		else
+			world.m_turrets[record.m_tileIndex] = pTurret;
+	}
+
+	// The journal can't reproduce a game that started from a snapshot.
+	world.m_journal.Stop();
+
+	// The planner is derived from the tiles and turrets, The stored paths already route around the turrets.
+	world.UpdatePlacementScores();
+	world.RebuildMazePlanner();
+	world.RefreshPathCoverage();
+
+	// Rounds only depend on the world seed and round index, So the next round can be staged as usual.
+	if (world.m_pCurrentRound)
+		world.StageNextRound();
+
+	return true;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <Game/Snapshot/SnapshotFormat.h>
+
+#include <cstddef>
+#include <cstdint>
+
+class World;
+
+/// <summary>
+/// Saves and loads the full state of a World. (See SnapshotFormat.h for the layout)
+/// </summary>
+class WorldSnapshot
+{
+public:
+
+	static bool Save(const World& world, const char* pPath);
+
+	/// <summary>
+	/// Maps the snapshot into memory, Validates it and restores [world] from it.
+	/// The world is left untouched if the snapshot is invalid.
+	/// </summary>
+	static bool Load(World& world, const char* pPath);
+
+	/// <summary>
+	/// Validates a snapshot using only its header, Returns nullptr if it can't be loaded.
+	/// </summary>
+	static const SnapshotHeader* Validate(const uint8_t* pData, size_t size);
+};
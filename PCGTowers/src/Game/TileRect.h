@@ -0,0 +1,86 @@
+#pragma once
+
+#include <Dragon/Generic/Math.h>
+
+#include <EASTL/algorithm.h>
+
+#include <cstddef>
+
+/// <summary>
+/// Half open rectangle of tiles, [left, right) by [top, bottom). Used to track which part of a tilemap changed.
+/// </summary>
+struct TileRect
+{
+	int m_left;
+	int m_top;
+	int m_right;
+	int m_bottom;
+
+	TileRect()
+		: TileRect(0, 0, 0, 0)
+	{}
+
+	TileRect(int left, int top, int right, int bottom)
+		: m_left(left)
+		, m_top(top)
+		, m_right(right)
+		, m_bottom(bottom)
+	{}
+
+	static TileRect FromTile(dragon::Vector2 position) { return TileRect(position.x, position.y, position.x + 1, position.y + 1); }
+	static TileRect FromSize(dragon::Vector2u size) { return TileRect(0, 0, (int)size.x, (int)size.y); }
+
+	bool IsEmpty() const { return m_right <= m_left || m_bottom <= m_top; }
+
+	int GetWidth() const { return IsEmpty() ? 0 : m_right - m_left; }
+	int GetHeight() const { return IsEmpty() ? 0 : m_bottom - m_top; }
+	size_t GetArea() const { return (size_t)GetWidth() * (size_t)GetHeight(); }
+
+	bool Contains(int x, int y) const { return x >= m_left && x < m_right && y >= m_top && y < m_bottom; }
+	bool Contains(dragon::Vector2 position) const { return Contains(position.x, position.y); }
+
+	/// <summary>
+	/// Grows this rect to also cover [other], Empty rects are ignored.
+	/// </summary>
+	void Merge(const TileRect& other)
+	{
+		if (other.IsEmpty())
+			return;
+
+		if (IsEmpty())
+		{
+			*this = other;
+			return;
+		}
+
+		m_left = eastl::min(m_left, other.m_left);
+		m_top = eastl::min(m_top, other.m_top);
+		m_right = eastl::max(m_right, other.m_right);
+		m_bottom = eastl::max(m_bottom, other.m_bottom);
+	}
+
+	void Merge(dragon::Vector2 position) { Merge(FromTile(position)); }
+
+	/// <summary>
+	/// This rect grown by [halo] tiles on every side.
+	/// </summary>
+	TileRect Expanded(int halo) const
+	{
+		if (IsEmpty())
+			return *this;
+
+		return TileRect(m_left - halo, m_top - halo, m_right + halo, m_bottom + halo);
+	}
+
+	/// <summary>
+	/// This rect limited to a map of [size].
+	/// </summary>
+	TileRect Clipped(dragon::Vector2u size) const
+	{
+		return TileRect(
+			eastl::max(m_left, 0),
+			eastl::max(m_top, 0),
+			eastl::min(m_right, (int)size.x),
+			eastl::min(m_bottom, (int)size.y));
+	}
+};
@@ -2,10 +2,16 @@
 
 #include <Config.h>
 
+#include <Game/Snapshot/SnapshotFormat.h>
+
+#include <Utility/StateHasher.h>
+
 #include <Dragon/Graphics/RenderTarget.h>
 #include <Platform/SFML/SfmlHelpers.h>
 #include <SFML/Graphics.hpp>
 
+#include <limits>
+
 Enemy::~Enemy()
 {
 	m_pPath = nullptr;
@@ -20,6 +26,27 @@ void Enemy::SetPath(const Path* pPath)
 	m_nextTile = 1;
 }
 
+void Enemy::RejoinPath()
+{
+	if (!m_pPath || m_pPath->empty())
+		return;
+
+	size_t closest = 0;
+	float closestDistance = std::numeric_limits<float>::max();
+
+	for (size_t i = 0; i < m_pPath->size(); ++i)
+	{
+		float distance = (m_pPath->at(i) - m_position).LengthSquared();
+		if (distance < closestDistance)
+		{
+			closest = i;
+			closestDistance = distance;
+		}
+	}
+
+	m_nextTile = closest;
+}
+
 void Enemy::Update(float dt)
 {
 	if (!m_pPath)
@@ -81,3 +108,50 @@ void Enemy::Render(dragon::RenderTarget& target)
 
 	pSfTarget->draw(healthbar);
 }
+
+void Enemy::Hash(StateHasher& hasher) const
+{
+	hasher.Add(m_position.x);
+	hasher.Add(m_position.y);
+	hasher.Add(m_health);
+	hasher.Add(m_nextTile);
+	hasher.Add(m_stats.m_speed);
+	hasher.Add(m_stats.m_damage);
+	hasher.Add(m_stats.m_maxHealth);
+	hasher.Add(m_shape);
+}
+
+void Enemy::Save(EnemyRecord& record) const
+{
+	record.m_x = m_position.x;
+	record.m_y = m_position.y;
+	record.m_health = m_health;
+
+	record.m_speed = m_stats.m_speed;
+	record.m_damage = m_stats.m_damage;
+	record.m_maxHealth = m_stats.m_maxHealth;
+
+	record.m_color[0] = m_color.r;
+	record.m_color[1] = m_color.g;
+	record.m_color[2] = m_color.b;
+	record.m_color[3] = m_color.a;
+
+	record.m_nextTile = (uint32_t)m_nextTile;
+	record.m_shape = (uint32_t)m_shape;
+}
+
+void Enemy::Load(const EnemyRecord& record, const Path* pPath)
+{
+	m_stats.m_speed = record.m_speed;
+	m_stats.m_damage = record.m_damage;
+	m_stats.m_maxHealth = record.m_maxHealth;
+
+	m_pPath = pPath;
+	m_position = { record.m_x, record.m_y };
+	m_health = record.m_health;
+	m_nextTile = record.m_nextTile;
+
+	m_shape = (Shape)record.m_shape;
+	m_color = dragon::Color(record.m_color[0], record.m_color[1], record.m_color[2]);
+	m_color.a = record.m_color[3];
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Game/Path.h>
+#include <Game/TowerDefense/EnemyRegistry.h>
 
 #include <Dragon/Generic/Math.h>
 #include <Dragon/Graphics/Color.h>
@@ -14,6 +15,9 @@ namespace dragon
 	class RenderTarget;
 }
 
+class StateHasher;
+struct EnemyRecord;
+
 class Enemy
 {
 public:
@@ -59,6 +63,11 @@ private:
 	dragon::Vector2f m_position;
 	size_t m_nextTile;
 
+	/// <summary>
+	/// Handed out by the world's EnemyRegistry, Refer to the enemy by it wherever it might outlive the enemy.
+	/// </summary>
+	EnemyHandle m_handle;
+
 	// Drawing Data
 	Shape m_shape;
 	dragon::Color m_color;
@@ -78,6 +87,9 @@ public:
 
 	dragon::Vector2f GetPosition() const { return m_position; }
 
+	EnemyHandle GetHandle() const { return m_handle; }
+	void SetHandle(EnemyHandle handle) { m_handle = handle; }
+
 	// TODO: Possibly returning by value is faster.
 	void SetStats(const Stats& stats) { m_stats = stats; SetHealth(stats.m_maxHealth); }
 	const Stats& GetStats() const { return m_stats; }
@@ -95,6 +107,21 @@ public:
 	void SetPath(const Path* pPath);
 	const Path* GetPath() const { return m_pPath; }
 
+	/// <summary>
+	/// Index of the path point the enemy is heading to.
+	/// </summary>
+	size_t GetNextTile() const { return m_nextTile; }
+
+	/// <summary>
+	/// Walked past the last point of its path, Ready to damage the base.
+	/// </summary>
+	bool HasReachedGoal() const { return m_pPath && m_nextTile >= m_pPath->size(); }
+
+	/// <summary>
+	/// Continues towards the closest point of the path, Called after the path it is following changed.
+	/// </summary>
+	void RejoinPath();
+
 	/// <summary>
 	/// Moves along the path.
 	/// </summary>
@@ -102,4 +129,13 @@ public:
 	void Update(float dt);
 
 	void Render(dragon::RenderTarget& target);
+
+	void Hash(StateHasher& hasher) const;
+
+	void Save(EnemyRecord& record) const;
+
+	/// <summary>
+	/// Restores the enemy from a snapshot, Continuing along [pPath] where it left off.
+	/// </summary>
+	void Load(const EnemyRecord& record, const Path* pPath);
 };
\ No newline at end of file
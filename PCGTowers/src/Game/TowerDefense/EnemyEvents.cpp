@@ -0,0 +1,16 @@
+#include "EnemyEvents.h"
+
+#include <Utility/Profiler.h>
+
+void EnemyEventQueue::Flush()
+{
+	PCG_PROFILE_ZONE("EnemyEventQueue::Flush");
+
+	if (m_events.empty())
+		return;
+
+	for (const Listener& listener : m_listeners)
+		listener(m_events);
+
+	m_events.clear();
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <Game/Path.h>
+#include <Game/TowerDefense/EnemyRegistry.h>
+
+#include <EASTL/vector.h>
+#include <EASTL/functional.h>
+
+#include <cstdint>
+
+enum class EnemyEventType : uint8_t
+{
+	kDied,			// Killed by the turrets.
+	kReachedGoal,	// Walked off the end of its path into the base.
+	kDespawned,		// Removed without being killed.
+};
+
+struct EnemyEvent
+{
+	EnemyEventType m_type;
+	EnemyHandle m_handle;		// No longer resolves by the time the event is delivered.
+	const Path* m_pPath;		// Path the enemy was following, Tells which spawner it came from.
+	float m_damage;				// Damage it does to the base, Also the gold for killing it.
+};
+
+using EnemyEvents = eastl::vector<EnemyEvent>;
+
+/// <summary>
+/// Collects the enemies that left the world during a tick, Delivered to every listener in one batch at the end of the tick.
+/// Listeners get to see all of them at once instead of being called back for every single enemy.
+/// </summary>
+class EnemyEventQueue
+{
+public:
+
+	using Listener = eastl::function<void(const EnemyEvents&)>;
+
+private:
+
+	EnemyEvents m_events;
+	eastl::vector<Listener> m_listeners;
+
+public:
+
+	/// <summary>
+	/// Calls [listener] with every batch from now on, In the order the listeners subscribed.
+	/// </summary>
+	void Subscribe(Listener&& listener) { m_listeners.emplace_back(eastl::move(listener)); }
+
+	void Push(const EnemyEvent& event) { m_events.push_back(event); }
+
+	/// <summary>
+	/// Delivers the queued events, If any.
+	/// </summary>
+	void Flush();
+
+	/// <summary>
+	/// Drops the queued events without delivering them.
+	/// </summary>
+	void Discard() { m_events.clear(); }
+
+	size_t GetSize() const { return m_events.size(); }
+};
@@ -0,0 +1,42 @@
+#include "EnemyRegistry.h"
+
+#include <Game/TowerDefense/Enemy.h>
+
+EnemyHandle EnemyRegistry::Register(Enemy* pEnemy)
+{
+	uint32_t index = 0;
+
+	if (!m_freeSlots.empty())
+	{
+		index = m_freeSlots.back();
+		m_freeSlots.pop_back();
+	}
+	else
+	{
+		index = (uint32_t)m_slots.size();
+		m_slots.push_back({ nullptr, 1 });
+	}
+
+	Slot& slot = m_slots[index];
+	slot.m_pEnemy = pEnemy;
+
+	EnemyHandle handle(index, slot.m_generation);
+	pEnemy->SetHandle(handle);
+
+	return handle;
+}
+
+void EnemyRegistry::Unregister(EnemyHandle handle)
+{
+	if (!Resolve(handle))
+		return;
+
+	// Outdates every handle to the slot. Skips 0 when the generation wraps around, It marks handles that never referred to anything.
+	Slot& slot = m_slots[handle.m_index];
+	slot.m_pEnemy = nullptr;
+
+	if (++slot.m_generation == 0)
+		slot.m_generation = 1;
+
+	m_freeSlots.push_back(handle.m_index);
+}
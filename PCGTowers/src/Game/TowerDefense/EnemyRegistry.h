@@ -0,0 +1,76 @@
+#pragma once
+
+#include <EASTL/vector.h>
+
+#include <cstdint>
+
+class Enemy;
+
+/// <summary>
+/// Weak reference to an enemy, Resolves to nothing once the enemy is gone even if its slot was reused.
+/// </summary>
+struct EnemyHandle
+{
+	uint32_t m_index;
+	uint32_t m_generation;	// 0 never refers to an enemy.
+
+	EnemyHandle()
+		: m_index(0)
+		, m_generation(0)
+	{}
+
+	EnemyHandle(uint32_t index, uint32_t generation)
+		: m_index(index)
+		, m_generation(generation)
+	{}
+
+	bool IsValid() const { return m_generation != 0; }
+
+	bool operator==(const EnemyHandle& other) const { return m_index == other.m_index && m_generation == other.m_generation; }
+	bool operator!=(const EnemyHandle& other) const { return !(*this == other); }
+};
+
+/// <summary>
+/// Hands out handles to the enemies in the world, Resolving a handle is a single lookup.
+/// Every slot counts the enemies that used it, A handle only resolves while its generation is the current one.
+/// </summary>
+class EnemyRegistry
+{
+	struct Slot
+	{
+		Enemy* m_pEnemy;
+		uint32_t m_generation;
+	};
+
+	eastl::vector<Slot> m_slots;
+
+	/// <summary>
+	/// Slots without an enemy, Reused last in first out so the handles only depend on the order enemies come and go.
+	/// </summary>
+	eastl::vector<uint32_t> m_freeSlots;
+
+public:
+
+	/// <summary>
+	/// Hands [pEnemy] its handle.
+	/// </summary>
+	EnemyHandle Register(Enemy* pEnemy);
+
+	/// <summary>
+	/// Every handle to the enemy stops resolving, Call before the enemy is deleted.
+	/// </summary>
+	void Unregister(EnemyHandle handle);
+
+	/// <summary>
+	/// The enemy [handle] refers to, nullptr once it is gone.
+	/// </summary>
+	Enemy* Resolve(EnemyHandle handle) const
+	{
+		if (handle.m_index >= m_slots.size() || m_slots[handle.m_index].m_generation != handle.m_generation)
+			return nullptr;
+
+		return m_slots[handle.m_index].m_pEnemy;
+	}
+
+	size_t GetSize() const { return m_slots.size() - m_freeSlots.size(); }
+};
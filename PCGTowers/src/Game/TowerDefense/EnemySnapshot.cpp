@@ -0,0 +1,33 @@
+#include "EnemySnapshot.h"
+
+#include <Game/TowerDefense/Enemy.h>
+
+#include <Utility/Profiler.h>
+
+void EnemySnapshot::Build(const eastl::vector<Enemy*>& enemies)
+{
+	PCG_PROFILE_ZONE("EnemySnapshot::Build");
+
+	m_x.resize(enemies.size());
+	m_y.resize(enemies.size());
+	m_handles.resize(enemies.size());
+	m_indices.clear();
+
+	for (size_t i = 0; i < enemies.size(); ++i)
+	{
+		dragon::Vector2f position = enemies[i]->GetPosition();
+		m_x[i] = position.x;
+		m_y[i] = position.y;
+		m_handles[i] = enemies[i]->GetHandle();
+
+		// Enemies that were never registered can't be referred to.
+		const EnemyHandle& handle = m_handles[i];
+		if (!handle.IsValid())
+			continue;
+
+		if (handle.m_index >= m_indices.size())
+			m_indices.resize(handle.m_index + 1, kNone);
+
+		m_indices[handle.m_index] = (uint32_t)i;
+	}
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <Game/TowerDefense/EnemyRegistry.h>
+
+#include <Dragon/Generic/Math.h>
+
+#include <EASTL/vector.h>
+
+#include <cstdint>
+
+/// <summary>
+/// Copy of the enemies the turrets aim at, One array per component. (Structure of arrays)
+/// Taken before the turrets update and never changed whilst they do, So any number of threads can read it.
+/// Only holds living enemies, Dead ones are removed before the next snapshot is taken.
+/// </summary>
+class EnemySnapshot
+{
+public:
+
+	static constexpr uint32_t kNone = 0xFFFFFFFF;
+
+private:
+
+	eastl::vector<float> m_x;
+	eastl::vector<float> m_y;
+	eastl::vector<EnemyHandle> m_handles;
+
+	/// <summary>
+	/// Index in the snapshot of the enemy in every registry slot, kNone for slots without one.
+	/// </summary>
+	eastl::vector<uint32_t> m_indices;
+
+public:
+
+	/// <summary>
+	/// Copies [enemies], The indices in the snapshot follow their order.
+	/// </summary>
+	void Build(const eastl::vector<Enemy*>& enemies);
+
+	/// <summary>
+	/// Index of the enemy [handle] refers to, kNone if it wasn't in the world when the snapshot was taken.
+	/// </summary>
+	uint32_t Find(EnemyHandle handle) const
+	{
+		if (handle.m_index >= m_indices.size())
+			return kNone;
+
+		uint32_t index = m_indices[handle.m_index];
+		if (index == kNone || m_handles[index] != handle)
+			return kNone;
+
+		return index;
+	}
+
+	dragon::Vector2f GetPosition(uint32_t index) const { return { m_x[index], m_y[index] }; }
+	EnemyHandle GetHandle(uint32_t index) const { return m_handles[index]; }
+
+	size_t GetSize() const { return m_handles.size(); }
+};
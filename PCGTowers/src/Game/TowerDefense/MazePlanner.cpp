@@ -0,0 +1,331 @@
+#include "MazePlanner.h"
+
+#include <Config.h>
+
+#include <Game/Generators/MapGenerator.h>
+
+#include <Utility/Profiler.h>
+
+#include <EASTL/heap.h>
+#include <EASTL/algorithm.h>
+
+#include <cstdlib>
+#include <limits>
+
+static constexpr float kInf = std::numeric_limits<float>::infinity();
+
+/// <summary>
+/// Calls [func] for the 4 neighbors of [tileIndex] that are within the map, In the same order as MapGenerator::GetNeighboringTiles.
+/// </summary>
+template<typename Func>
+static void ForEachNeighbor(dragon::Vector2u mapSize, int tileIndex, Func&& func)
+{
+	const int kWidth = (int)mapSize.x;
+	const int kHeight = (int)mapSize.y;
+
+	int x = tileIndex % kWidth;
+	int y = tileIndex / kWidth;
+
+	if (x > 0) func(tileIndex - 1);
+	if (x < kWidth - 1) func(tileIndex + 1);
+	if (y > 0) func(tileIndex - kWidth);
+	if (y < kHeight - 1) func(tileIndex + kWidth);
+}
+
+template<typename Key>
+static bool IsSameKey(const Key& left, const Key& right)
+{
+	return left.estimate == right.estimate && left.cost == right.cost;
+}
+
+/// <summary>
+/// Orders the queue as a min heap, Ties are broken on the tile index to keep the expansion order deterministic.
+/// </summary>
+template<typename Key>
+static bool IsLaterEntry(const Key& left, int leftTile, const Key& right, int rightTile)
+{
+	if (left.estimate != right.estimate)
+		return left.estimate > right.estimate;
+
+	if (left.cost != right.cost)
+		return left.cost > right.cost;
+
+	return leftTile > rightTile;
+}
+
+void MazePlanner::Init(const TDTilemap& tilemap, int goal, const eastl::vector<int>& starts)
+{
+	PCG_PROFILE_ZONE("MazePlanner::Init");
+
+	m_pTilemap = &tilemap;
+	m_mapSize = tilemap.GetSize();
+	m_goal = goal;
+	m_starts = starts;
+
+	const size_t kTileCount = (size_t)m_mapSize.x * (size_t)m_mapSize.y;
+
+	m_tiles.resize(kTileCount);
+	m_extraCosts.assign(kTileCount, 0.0f);
+
+	float minCost = kInf;
+	for (size_t i = 0; i < kTileCount; ++i)
+	{
+		TileState& tile = m_tiles[i];
+		tile.g = kInf;
+		tile.rhs = kInf;
+		tile.cost = MapGenerator::GetTileWeight(tilemap.GetTileDataAtIndex(i));
+		tile.queuedKey = { kInf, kInf };
+
+		minCost = eastl::min(minCost, tile.cost);
+	}
+
+	// Manhattan distance to the nearest start, Every step costs at least the cheapest tile. Extra costs only ever add to that.
+	for (size_t i = 0; i < kTileCount; ++i)
+	{
+		int x = (int)(i % m_mapSize.x);
+		int y = (int)(i / m_mapSize.x);
+
+		int distance = std::numeric_limits<int>::max();
+		for (int start : m_starts)
+		{
+			int startX = start % (int)m_mapSize.x;
+			int startY = start / (int)m_mapSize.x;
+			distance = eastl::min(distance, std::abs(x - startX) + std::abs(y - startY));
+		}
+
+		m_tiles[i].heuristic = (float)distance * minCost;
+	}
+
+	m_queue.clear();
+	m_queue.reserve(kTileCount);
+
+	// The base is where every path ends.
+	m_tiles[m_goal].rhs = 0.0f;
+	Push(m_goal);
+
+	m_expansions = 0;
+}
+
+void MazePlanner::Clear()
+{
+	m_pTilemap = nullptr;
+	m_mapSize = { 0, 0 };
+	m_goal = dragon::kInvalidTile;
+
+	m_tiles.clear();
+	m_extraCosts.clear();
+	m_queue.clear();
+	m_starts.clear();
+}
+
+void MazePlanner::SetExtraCost(int tileIndex, float cost)
+{
+	if (m_extraCosts[tileIndex] == cost)
+		return;
+
+	TileState& tile = m_tiles[tileIndex];
+	float oldReach = tile.cost + tile.g;
+
+	m_extraCosts[tileIndex] = cost;
+	tile.cost = MapGenerator::GetTileWeight(m_pTilemap->GetTileDataAtIndex(tileIndex)) + cost;
+
+	float newReach = tile.cost + tile.g;
+
+	// Only the tiles that can walk onto this tile see the new cost.
+	ForEachNeighbor(m_mapSize, tileIndex, [this, oldReach, newReach](int neighbor)
+	{
+		if (neighbor == m_goal)
+			return;
+
+		if (newReach < m_tiles[neighbor].rhs)
+		{
+			m_tiles[neighbor].rhs = newReach;
+			Requeue(neighbor);
+		}
+		else if (m_tiles[neighbor].rhs == oldReach)
+		{
+			// This tile was its cheapest way to the base.
+			UpdateTile(neighbor);
+		}
+	});
+}
+
+void MazePlanner::ComputePaths()
+{
+	PCG_PROFILE_ZONE("MazePlanner::ComputePaths");
+
+	m_expansions = 0;
+
+	auto isLater = [](const QueueEntry& left, const QueueEntry& right) -> bool
+	{
+		return IsLaterEntry(left.key, left.tileIndex, right.key, right.tileIndex);
+	};
+
+	while (!m_queue.empty() && !HasConverged())
+	{
+		eastl::pop_heap(m_queue.begin(), m_queue.end(), isLater);
+		QueueEntry entry = m_queue.back();
+		m_queue.pop_back();
+
+		int tileIndex = entry.tileIndex;
+		TileState& tile = m_tiles[tileIndex];
+
+		// The tile is no longer waiting with this key, Whatever happens to this entry.
+		if (IsSameKey(entry.key, tile.queuedKey))
+			tile.queuedKey = { kInf, kInf };
+
+		// Pushed again since, Or already made consistent by an earlier entry.
+		if (IsConsistent(tileIndex) || !IsSameKey(entry.key, GetKey(tileIndex)))
+			continue;
+
+		++m_expansions;
+
+		if (tile.g > tile.rhs)
+		{
+			// Got cheaper, Settle it. Neighbors can only get cheaper through it.
+			tile.g = tile.rhs;
+
+			float reach = tile.cost + tile.g;
+			ForEachNeighbor(m_mapSize, tileIndex, [this, reach](int neighbor)
+			{
+				if (neighbor != m_goal && reach < m_tiles[neighbor].rhs)
+				{
+					m_tiles[neighbor].rhs = reach;
+					Requeue(neighbor);
+				}
+			});
+		}
+		else
+		{
+			// Got more expensive, Re-evaluate it and every neighbor that went through it.
+			float oldReach = tile.cost + tile.g;
+			tile.g = kInf;
+			UpdateTile(tileIndex);
+
+			ForEachNeighbor(m_mapSize, tileIndex, [this, oldReach](int neighbor)
+			{
+				if (neighbor != m_goal && m_tiles[neighbor].rhs == oldReach)
+					UpdateTile(neighbor);
+			});
+		}
+	}
+}
+
+TilePath MazePlanner::GetTilePath(int start) const
+{
+	TilePath path;
+
+	if (m_tiles[start].g == kInf)
+		return path;
+
+	// Follow the cheapest neighbor down to the base, Bounded in case the costs are not up to date.
+	const size_t kTileCount = m_tiles.size();
+
+	int current = start;
+	while (current != m_goal && path.size() < kTileCount)
+	{
+		int next = dragon::kInvalidTile;
+		float nextCost = kInf;
+
+		ForEachNeighbor(m_mapSize, current, [this, &next, &nextCost](int neighbor)
+		{
+			float cost = m_tiles[neighbor].cost + m_tiles[neighbor].g;
+			if (cost < nextCost)
+			{
+				next = neighbor;
+				nextCost = cost;
+			}
+		});
+
+		if (next == dragon::kInvalidTile)
+			break;
+
+		path.emplace_back(next);
+		current = next;
+	}
+
+	return path;
+}
+
+Path MazePlanner::GetPath(int start) const
+{
+	TilePath tilePath = GetTilePath(start);
+
+	Path path;
+	path.reserve(tilePath.size());
+
+	for (int tileIndex : tilePath)
+	{
+		dragon::Vector2 tilePos = m_pTilemap->PositionFromIndex(tileIndex);
+		path.emplace_back(
+			(float)tilePos.x * g_kTileSize + (g_kTileSize / 2.0f),
+			(float)tilePos.y * g_kTileSize + (g_kTileSize / 2.0f));
+	}
+
+	return path;
+}
+
+MazePlanner::Key MazePlanner::GetKey(int tileIndex) const
+{
+	const TileState& tile = m_tiles[tileIndex];
+
+	float cost = eastl::min(tile.g, tile.rhs);
+	return { cost + tile.heuristic, cost };
+}
+
+bool MazePlanner::HasConverged() const
+{
+	const QueueEntry& top = m_queue.front();
+
+	for (int start : m_starts)
+	{
+		if (!IsConsistent(start))
+			return false;
+
+		if (!IsLaterEntry(top.key, top.tileIndex, GetKey(start), start))
+			return false;
+	}
+
+	return true;
+}
+
+void MazePlanner::UpdateTile(int tileIndex)
+{
+	if (tileIndex != m_goal)
+	{
+		float rhs = kInf;
+
+		ForEachNeighbor(m_mapSize, tileIndex, [this, &rhs](int neighbor)
+		{
+			rhs = eastl::min(rhs, m_tiles[neighbor].cost + m_tiles[neighbor].g);
+		});
+
+		m_tiles[tileIndex].rhs = rhs;
+	}
+
+	Requeue(tileIndex);
+}
+
+void MazePlanner::Requeue(int tileIndex)
+{
+	if (!IsConsistent(tileIndex))
+		Push(tileIndex);
+}
+
+void MazePlanner::Push(int tileIndex)
+{
+	auto isLater = [](const QueueEntry& left, const QueueEntry& right) -> bool
+	{
+		return IsLaterEntry(left.key, left.tileIndex, right.key, right.tileIndex);
+	};
+
+	Key key = GetKey(tileIndex);
+
+	// Already waiting with this key.
+	if (IsSameKey(m_tiles[tileIndex].queuedKey, key))
+		return;
+
+	m_tiles[tileIndex].queuedKey = key;
+	m_queue.push_back({ key, tileIndex });
+	eastl::push_heap(m_queue.begin(), m_queue.end(), isLater);
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <Game/Path.h>
+#include <Game/TowerDefense/TDTilemap.h>
+
+#include <EASTL/vector.h>
+
+/// <summary>
+/// Keeps the cheapest paths from the spawners to the base up to date while tile costs change. (Lifelong Planning A*)
+/// Searches from the base so one search serves every spawner, A cost change only repairs the tiles whose cost to the base it affects.
+/// </summary>
+class MazePlanner
+{
+	struct Key
+	{
+		float estimate;		// Cost to the base plus the heuristic.
+		float cost;			// Cost to the base, Breaks ties.
+	};
+
+	struct QueueEntry
+	{
+		Key key;
+		int tileIndex;
+	};
+
+	/// <summary>
+	/// Search state of a tile, Kept together since an expansion touches all of it.
+	/// </summary>
+	struct TileState
+	{
+		float g;			// Cost to the base as of the last expansion.
+		float rhs;			// Cost to the base as seen from the neighbors, Equal to g when the tile is consistent.
+		float cost;			// Cost of walking onto the tile, The tile weight plus its extra cost.
+		float heuristic;	// Lower bound of the cost from the nearest start, Focuses the search on the starts.
+		Key queuedKey;		// Key the tile was last queued with, Avoids queueing a tile twice with the same key.
+	};
+
+	const TDTilemap* m_pTilemap;
+	dragon::Vector2u m_mapSize;
+
+	eastl::vector<TileState> m_tiles;
+	eastl::vector<float> m_extraCosts;
+
+	/// <summary>
+	/// Min heap of inconsistent tiles, Outdated entries are skipped once popped.
+	/// </summary>
+	eastl::vector<QueueEntry> m_queue;
+
+	eastl::vector<int> m_starts;
+	int m_goal;
+
+	/// <summary>
+	/// Tiles expanded by the last ComputePaths.
+	/// </summary>
+	size_t m_expansions;
+
+public:
+
+	MazePlanner()
+		: m_pTilemap(nullptr)
+		, m_mapSize(0, 0)
+		, m_goal(dragon::kInvalidTile)
+		, m_expansions(0)
+	{}
+
+	/// <summary>
+	/// Plans from every tile in [starts] to [goal], The tilemap must outlive the planner or the next Init.
+	/// </summary>
+	void Init(const TDTilemap& tilemap, int goal, const eastl::vector<int>& starts);
+	void Clear();
+
+	bool IsInitialized() const { return m_pTilemap != nullptr; }
+
+	/// <summary>
+	/// Changes the extra cost of walking onto [tileIndex], Paths are repaired by the next ComputePaths.
+	/// </summary>
+	void SetExtraCost(int tileIndex, float cost);
+	float GetExtraCost(int tileIndex) const { return m_extraCosts[tileIndex]; }
+
+	/// <summary>
+	/// Expands tiles until the path of every start is up to date again.
+	/// </summary>
+	void ComputePaths();
+
+	/// <summary>
+	/// Cheapest path from [start] to the base, Excluding [start] itself just like carved paths.
+	/// Only valid for starts passed to Init after ComputePaths.
+	/// </summary>
+	TilePath GetTilePath(int start) const;
+
+	/// <summary>
+	/// GetTilePath as tile centroids.
+	/// </summary>
+	Path GetPath(int start) const;
+
+	float GetPathCost(int start) const { return m_tiles[start].g; }
+	size_t GetExpansions() const { return m_expansions; }
+
+private:
+
+	Key GetKey(int tileIndex) const;
+	bool IsConsistent(int tileIndex) const { return m_tiles[tileIndex].g == m_tiles[tileIndex].rhs; }
+
+	/// <summary>
+	/// Wether or not every start is consistent and nothing cheaper is left to expand.
+	/// </summary>
+	bool HasConverged() const;
+
+	/// <summary>
+	/// Recomputes the rhs of [tileIndex] from its neighbors.
+	/// </summary>
+	void UpdateTile(int tileIndex);
+
+	/// <summary>
+	/// Queues [tileIndex] if it is inconsistent.
+	/// </summary>
+	void Requeue(int tileIndex);
+
+	void Push(int tileIndex);
+};
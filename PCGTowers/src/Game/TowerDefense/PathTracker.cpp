@@ -0,0 +1,186 @@
+#include "PathTracker.h"
+
+#include <Game/TowerDefense/Enemy.h>
+
+#include <Utility/Profiler.h>
+
+#include <EASTL/sort.h>
+#include <EASTL/algorithm.h>
+
+#include <cmath>
+#include <limits>
+
+/// <summary>
+/// Enemies snap to the next point of their path within one unit, Coverage is padded by as much so they're never missed.
+/// </summary>
+static constexpr float g_kCoveragePadding = 1.0f;
+
+uint32_t PathTracker::AddPath(const Path& path)
+{
+	TrackedPath trackedPath;
+	trackedPath.m_pPath = &path;
+	trackedPath.m_distances.reserve(path.size());
+
+	float distance = 0.0f;
+	for (size_t i = 0; i < path.size(); ++i)
+	{
+		if (i > 0)
+			distance += std::sqrt((path[i] - path[i - 1]).LengthSquared());
+
+		trackedPath.m_distances.push_back(distance);
+	}
+
+	// An empty path still has a length.
+	if (trackedPath.m_distances.empty())
+		trackedPath.m_distances.push_back(0.0f);
+
+	m_paths.emplace_back(eastl::move(trackedPath));
+
+	return (uint32_t)m_paths.size() - 1;
+}
+
+void PathTracker::Update(const eastl::vector<Enemy*>& enemies)
+{
+	PCG_PROFILE_ZONE("PathTracker::Update");
+
+	for (TrackedPath& path : m_paths)
+		path.m_enemies.clear();
+
+	for (size_t i = 0; i < enemies.size(); ++i)
+	{
+		Enemy* pEnemy = enemies[i];
+
+		// Only a handful of paths, A linear search beats a map.
+		for (TrackedPath& path : m_paths)
+		{
+			if (path.m_pPath == pEnemy->GetPath())
+			{
+				path.m_enemies.push_back({ GetDistanceTravelled(path, *pEnemy), (uint32_t)i });
+				break;
+			}
+		}
+	}
+
+	for (TrackedPath& path : m_paths)
+	{
+		eastl::sort(path.m_enemies.begin(), path.m_enemies.end(), [](const TrackedEnemy& left, const TrackedEnemy& right)
+		{
+			return left.m_distance != right.m_distance ? left.m_distance < right.m_distance : left.m_order < right.m_order;
+		});
+	}
+}
+
+void PathTracker::ComputeCoverage(dragon::Vector2f position, float range, PathCoverage& coverage) const
+{
+	coverage.clear();
+
+	const float kRange = range + g_kCoveragePadding;
+
+	for (uint32_t pathIndex = 0; pathIndex < (uint32_t)m_paths.size(); ++pathIndex)
+	{
+		const Path& path = *m_paths[pathIndex].m_pPath;
+		const eastl::vector<float>& distances = m_paths[pathIndex].m_distances;
+
+		for (size_t i = 0; i + 1 < path.size(); ++i)
+		{
+			// Solve |start + t * direction - position| = range for t, The segment is covered between the two solutions.
+			dragon::Vector2f direction = path[i + 1] - path[i];
+			dragon::Vector2f offset = path[i] - position;
+
+			float a = direction.LengthSquared();
+			float b = 2.0f * (direction.x * offset.x + direction.y * offset.y);
+			float c = offset.LengthSquared() - kRange * kRange;
+
+			float first = 0.0f;
+			float last = 1.0f;
+
+			if (a > 0.0f)
+			{
+				float discriminant = b * b - 4.0f * a * c;
+				if (discriminant < 0.0f)
+					continue;
+
+				float root = std::sqrt(discriminant);
+				first = eastl::max((-b - root) / (2.0f * a), 0.0f);
+				last = eastl::min((-b + root) / (2.0f * a), 1.0f);
+			}
+			else if (c > 0.0f)
+			{
+				continue;
+			}
+
+			if (first > last)
+				continue;
+
+			float length = distances[i + 1] - distances[i];
+			PathInterval interval = { pathIndex, distances[i] + first * length, distances[i] + last * length };
+
+			// Consecutive segments usually continue the same stretch.
+			if (!coverage.empty() && coverage.back().m_path == pathIndex && interval.m_start <= coverage.back().m_end)
+				coverage.back().m_end = eastl::max(coverage.back().m_end, interval.m_end);
+			else
+				coverage.push_back(interval);
+		}
+	}
+
+	for (PathInterval& interval : coverage)
+	{
+		interval.m_start -= g_kCoveragePadding;
+		interval.m_end += g_kCoveragePadding;
+	}
+}
+
+PathTracker::EnemyRange PathTracker::FindEnemies(const PathInterval& interval) const
+{
+	const eastl::vector<TrackedEnemy>& enemies = m_paths[interval.m_path].m_enemies;
+
+	const TrackedEnemy* pBegin = enemies.data();
+	const TrackedEnemy* pEnd = enemies.data() + enemies.size();
+
+	const TrackedEnemy* pFirst = eastl::lower_bound(pBegin, pEnd, interval.m_start, [](const TrackedEnemy& enemy, float distance)
+	{
+		return enemy.m_distance < distance;
+	});
+
+	const TrackedEnemy* pLast = eastl::upper_bound(pFirst, pEnd, interval.m_end, [](float distance, const TrackedEnemy& enemy)
+	{
+		return distance < enemy.m_distance;
+	});
+
+	return { pFirst, pLast };
+}
+
+float PathTracker::GetDistanceToCoverage(const PathCoverage& coverage) const
+{
+	float distance = std::numeric_limits<float>::infinity();
+
+	for (const PathInterval& interval : coverage)
+	{
+		EnemyRange enemies = FindEnemies(interval);
+		if (enemies.first != enemies.second)
+			return 0.0f;
+
+		// The enemy right behind the interval gets there first, Enemies only move forward.
+		const TrackedEnemy* pBegin = m_paths[interval.m_path].m_enemies.data();
+		float behind = enemies.first != pBegin ? enemies.first[-1].m_distance : 0.0f;
+
+		distance = eastl::min(distance, eastl::max(interval.m_start - eastl::max(behind, 0.0f), 0.0f));
+	}
+
+	return distance;
+}
+
+float PathTracker::GetDistanceTravelled(const TrackedPath& path, const Enemy& enemy)
+{
+	const Path& points = *path.m_pPath;
+	size_t nextTile = enemy.GetNextTile();
+
+	if (nextTile == 0 || points.empty())
+		return 0.0f;
+
+	if (nextTile >= points.size())
+		return path.m_distances.back();
+
+	float toNext = std::sqrt((points[nextTile] - enemy.GetPosition()).LengthSquared());
+	return eastl::max(path.m_distances[nextTile] - toNext, path.m_distances[nextTile - 1]);
+}
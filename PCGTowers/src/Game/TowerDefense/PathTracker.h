@@ -0,0 +1,95 @@
+#pragma once
+
+#include <Game/Path.h>
+
+#include <Dragon/Generic/Math.h>
+
+#include <EASTL/vector.h>
+#include <EASTL/utility.h>
+
+#include <cstdint>
+
+class Enemy;
+
+/// <summary>
+/// Stretch of a tracked path, In distance along the path from its start.
+/// </summary>
+struct PathInterval
+{
+	uint32_t m_path;
+	float m_start;
+	float m_end;
+};
+
+/// <summary>
+/// Stretches of the paths within range of a turret.
+/// </summary>
+using PathCoverage = eastl::vector<PathInterval>;
+
+/// <summary>
+/// Tracks how far every enemy is along the path it follows, Sorted so the enemies on a stretch of a path are found with a binary search.
+/// Turrets never move relative to the paths, So the stretches they cover only have to be computed when either of them changes.
+/// </summary>
+class PathTracker
+{
+public:
+
+	struct TrackedEnemy
+	{
+		float m_distance;	// Distance travelled along the path.
+		uint32_t m_order;	// Index in the enemies passed to Update, Breaks ties. Also the index in an EnemySnapshot of the same enemies.
+	};
+
+	using EnemyRange = eastl::pair<const TrackedEnemy*, const TrackedEnemy*>;
+
+private:
+
+	struct TrackedPath
+	{
+		const Path* m_pPath;
+		eastl::vector<float> m_distances;		// Distance along the path of every point.
+		eastl::vector<TrackedEnemy> m_enemies;	// Sorted by distance travelled.
+	};
+
+	eastl::vector<TrackedPath> m_paths;
+
+public:
+
+	void Clear() { m_paths.clear(); }
+
+	/// <summary>
+	/// Starts tracking [path], Returns its index. The path must not change or move until the next Clear.
+	/// </summary>
+	uint32_t AddPath(const Path& path);
+
+	/// <summary>
+	/// Sorts [enemies] onto the paths they follow, Enemies on untracked paths are left out.
+	/// </summary>
+	void Update(const eastl::vector<Enemy*>& enemies);
+
+	/// <summary>
+	/// Replaces [coverage] by the stretches of every tracked path within [range] of [position].
+	/// </summary>
+	void ComputeCoverage(dragon::Vector2f position, float range, PathCoverage& coverage) const;
+
+	/// <summary>
+	/// Enemies within [interval] as of the last Update, Ordered by distance travelled.
+	/// </summary>
+	EnemyRange FindEnemies(const PathInterval& interval) const;
+
+	/// <summary>
+	/// Shortest distance an enemy has to travel along its path to enter [coverage], 0 if one already did. Infinite without coverage.
+	/// Enemies spawning later start out at the start of their path, Which is counted as an enemy standing there.
+	/// </summary>
+	float GetDistanceToCoverage(const PathCoverage& coverage) const;
+
+	float GetPathLength(uint32_t path) const { return m_paths[path].m_distances.back(); }
+	size_t GetPathCount() const { return m_paths.size(); }
+
+private:
+
+	/// <summary>
+	/// Distance [enemy] travelled along [path], Measured back from the point it is heading to.
+	/// </summary>
+	static float GetDistanceTravelled(const TrackedPath& path, const Enemy& enemy);
+};
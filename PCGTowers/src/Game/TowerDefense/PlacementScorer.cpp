@@ -0,0 +1,169 @@
+#include "PlacementScorer.h"
+
+#include <Config.h>
+
+#include <Utility/Profiler.h>
+
+#include <EASTL/algorithm.h>
+
+#include <cmath>
+
+void PlacementScorer::Init(dragon::Vector2u size, float range)
+{
+	// Square with the area of the disk, Measured in whole tiles around the center tile.
+	const float kSide = range * std::sqrt(3.14159265f) / g_kTileSize;
+	int radius = eastl::max(0, (int)std::lround((kSide - 1.0f) / 2.0f));
+
+	if (size.x == m_size.x && size.y == m_size.y && radius == m_radius)
+		return;
+
+	m_size = size;
+	m_radius = radius;
+
+	const size_t kTileCount = (size_t)size.x * size.y;
+	m_occupancy.assign(kTileCount, 0);
+	m_scoredOccupancy.assign(kTileCount, 0);
+	m_touchedTiles.clear();
+	m_buildable.assign(kTileCount, 0);
+	m_table.assign(((size_t)size.x + 1) * ((size_t)size.y + 1), 0);
+	m_scores.assign(kTileCount, 0);
+
+	// Every tile starts out scoring 0, Room for a few paths crossing the whole square.
+	const size_t kSquareArea = (size_t)(2 * radius + 1) * (size_t)(2 * radius + 1);
+	m_scoreCounts.assign(kSquareArea * 4 + 1, 0);
+	m_scoreCounts[0] = (uint32_t)kTileCount;
+	m_maxScore = 0;
+
+	m_dirty = TileRect::FromSize(size);
+}
+
+void PlacementScorer::Reset()
+{
+	eastl::fill(m_occupancy.begin(), m_occupancy.end(), (uint16_t)0);
+	eastl::fill(m_scoredOccupancy.begin(), m_scoredOccupancy.end(), (uint16_t)0);
+	m_touchedTiles.clear();
+
+	m_dirty = TileRect::FromSize(m_size);
+}
+
+void PlacementScorer::AddPath(const TDTilemap& tilemap, const Path& path)
+{
+	AdjustOccupancy(tilemap, path, 1);
+}
+
+void PlacementScorer::RemovePath(const TDTilemap& tilemap, const Path& path)
+{
+	AdjustOccupancy(tilemap, path, -1);
+}
+
+void PlacementScorer::AdjustOccupancy(const TDTilemap& tilemap, const Path& path, int delta)
+{
+	// Carved paths have a point on every tile they cross.
+	for (const dragon::Vector2f& point : path)
+	{
+		dragon::Vector2 tilePosition = tilemap.WorldToMapCoordinates(point);
+		if (!tilemap.WithinBounds(tilePosition))
+			continue;
+
+		const uint32_t kTile = (uint32_t)tilePosition.y * m_size.x + (uint32_t)tilePosition.x;
+		m_occupancy[kTile] = (uint16_t)(m_occupancy[kTile] + delta);
+		m_touchedTiles.push_back(kTile);
+	}
+}
+
+void PlacementScorer::SetBuildable(size_t tileIndex, bool isBuildable)
+{
+	const uint8_t kBuildable = isBuildable ? 1 : 0;
+	if (m_buildable[tileIndex] == kBuildable)
+		return;
+
+	m_buildable[tileIndex] = kBuildable;
+	m_dirty.Merge(dragon::Vector2((int)(tileIndex % m_size.x), (int)(tileIndex / m_size.x)));
+}
+
+TileRect PlacementScorer::Update()
+{
+	PCG_PROFILE_ZONE("PlacementScorer::Update");
+
+	// A path that was removed and added again over the same tile leaves it as it was.
+	for (uint32_t tile : m_touchedTiles)
+	{
+		if (m_occupancy[tile] == m_scoredOccupancy[tile])
+			continue;
+
+		m_scoredOccupancy[tile] = m_occupancy[tile];
+		m_dirty.Merge(dragon::Vector2((int)(tile % m_size.x), (int)(tile / m_size.x)));
+	}
+	m_touchedTiles.clear();
+
+	TileRect dirty = m_dirty;
+	m_dirty = TileRect();
+
+	if (dirty.IsEmpty())
+		return dirty;
+
+	// Every tile whose square reaches into the changed tiles, And the tiles their squares cover.
+	const TileRect kRescored = dirty.Expanded(m_radius).Clipped(m_size);
+	const TileRect kWindow = kRescored.Expanded(m_radius).Clipped(m_size);
+
+	// The table is laid out for the window, So the leading row and column of zeroes move with its width.
+	const size_t kStride = (size_t)kWindow.GetWidth() + 1;
+	eastl::fill(m_table.begin(), m_table.begin() + kStride, 0u);
+
+	for (int y = 0; y < kWindow.GetHeight(); ++y)
+	{
+		const uint16_t* pRow = m_occupancy.data() + (size_t)(kWindow.m_top + y) * m_size.x + (size_t)kWindow.m_left;
+		m_table[(y + 1) * kStride] = 0;
+
+		for (int x = 0; x < kWindow.GetWidth(); ++x)
+		{
+			m_table[(y + 1) * kStride + x + 1] = pRow[x]
+				+ m_table[y * kStride + x + 1]
+				+ m_table[(y + 1) * kStride + x]
+				- m_table[y * kStride + x];
+		}
+	}
+
+	uint32_t highestScore = 0;
+	for (int y = kRescored.m_top; y < kRescored.m_bottom; ++y)
+	{
+		for (int x = kRescored.m_left; x < kRescored.m_right; ++x)
+		{
+			const size_t kTile = (size_t)y * m_size.x + (size_t)x;
+			const uint32_t kScore = m_buildable[kTile] ? SumRect(kWindow, x - m_radius, y - m_radius, x + m_radius, y + m_radius) : 0;
+
+			if (kScore == m_scores[kTile])
+				continue;
+
+			if (kScore >= m_scoreCounts.size())
+				m_scoreCounts.resize((size_t)kScore + 1, 0);
+
+			--m_scoreCounts[m_scores[kTile]];
+			++m_scoreCounts[kScore];
+			m_scores[kTile] = kScore;
+
+			highestScore = eastl::max(highestScore, kScore);
+		}
+	}
+
+	// Scores only went up to the highest rescored one, Or down until a score some tile still has.
+	m_maxScore = eastl::max(m_maxScore, highestScore);
+	while (m_maxScore > 0 && m_scoreCounts[m_maxScore] == 0)
+		--m_maxScore;
+
+	return kRescored;
+}
+
+uint32_t PlacementScorer::SumRect(const TileRect& window, int left, int top, int right, int bottom) const
+{
+	left = eastl::max(left, window.m_left) - window.m_left;
+	top = eastl::max(top, window.m_top) - window.m_top;
+	right = eastl::min(right, window.m_right - 1) - window.m_left;
+	bottom = eastl::min(bottom, window.m_bottom - 1) - window.m_top;
+
+	const size_t kStride = (size_t)window.GetWidth() + 1;
+	return m_table[(size_t)(bottom + 1) * kStride + (size_t)(right + 1)]
+		- m_table[(size_t)top * kStride + (size_t)(right + 1)]
+		- m_table[(size_t)(bottom + 1) * kStride + (size_t)left]
+		+ m_table[(size_t)top * kStride + (size_t)left];
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <Game/Path.h>
+#include <Game/TileRect.h>
+#include <Game/TowerDefense/TDTilemap.h>
+
+#include <Dragon/Generic/Math.h>
+
+#include <EASTL/vector.h>
+
+#include <cstdint>
+
+/// <summary>
+/// Scores every tile by the amount of path a turret built on it would cover, Counting a tile once for every path that crosses it.
+/// The range disk is approximated by a square of the same area, Which a summed-area table answers in constant time per tile.
+/// Only the tiles near what changed since the last update are scored again, So repairing a path around a single turret stays cheap.
+/// </summary>
+class PlacementScorer
+{
+	dragon::Vector2u m_size;
+
+	/// <summary>
+	/// Tiles from the center to the edge of the square, The square is 2 * radius + 1 tiles wide.
+	/// </summary>
+	int m_radius;
+
+	/// <summary>
+	/// Paths crossing every tile, Kept up to date by AddPath and RemovePath. The last update's is kept to find what changed.
+	/// </summary>
+	eastl::vector<uint16_t> m_occupancy;
+	eastl::vector<uint16_t> m_scoredOccupancy;
+
+	/// <summary>
+	/// Tiles AddPath and RemovePath went over since the last update, Only these can have a different occupancy.
+	/// </summary>
+	eastl::vector<uint32_t> m_touchedTiles;
+
+	/// <summary>
+	/// Wether a turret can be built on every tile, As of the last call to SetBuildable.
+	/// </summary>
+	eastl::vector<uint8_t> m_buildable;
+
+	/// <summary>
+	/// Summed-area table of the occupancy around the tiles being scored, With a row and column of zeroes in front.
+	/// Sized for the whole map so scoring everything fits as well.
+	/// </summary>
+	eastl::vector<uint32_t> m_table;
+
+	/// <summary>
+	/// Path tiles covered from every tile, 0 for tiles that can't be built on.
+	/// </summary>
+	eastl::vector<uint32_t> m_scores;
+
+	/// <summary>
+	/// Tiles with every score, So the highest score is known without looking at all of them.
+	/// </summary>
+	eastl::vector<uint32_t> m_scoreCounts;
+
+	uint32_t m_maxScore;
+
+	/// <summary>
+	/// Tiles whose occupancy or buildability changed since the last update.
+	/// </summary>
+	TileRect m_dirty;
+
+public:
+
+	PlacementScorer()
+		: m_size(0, 0)
+		, m_radius(0)
+		, m_maxScore(0)
+	{}
+
+	/// <summary>
+	/// Sizes the grids for [size] tiles and picks the square that matches [range], Does nothing if neither changed.
+	/// </summary>
+	void Init(dragon::Vector2u size, float range);
+
+	/// <summary>
+	/// Removes every path and scores every tile again on the next update, For when all the paths are replaced.
+	/// </summary>
+	void Reset();
+
+	void AddPath(const TDTilemap& tilemap, const Path& path);
+
+	/// <summary>
+	/// Takes back a path added before, [path] has to cross the same tiles it did then.
+	/// </summary>
+	void RemovePath(const TDTilemap& tilemap, const Path& path);
+
+	void SetBuildable(size_t tileIndex, bool isBuildable);
+
+	/// <summary>
+	/// Scores the tiles affected by the paths added or removed and the buildable tiles changed since the last update.
+	/// Returns the tiles that were scored again.
+	/// </summary>
+	TileRect Update();
+
+	uint32_t GetScore(size_t tileIndex) const { return tileIndex < m_scores.size() ? m_scores[tileIndex] : 0; }
+	uint32_t GetMaxScore() const { return m_maxScore; }
+	int GetRadius() const { return m_radius; }
+
+private:
+
+	void AdjustOccupancy(const TDTilemap& tilemap, const Path& path, int delta);
+
+	/// <summary>
+	/// Occupancy in the square of tiles [left, right] by [top, bottom], Inclusive and clipped to [window]. The table has to cover [window].
+	/// </summary>
+	uint32_t SumRect(const TileRect& window, int left, int top, int right, int bottom) const;
+};
@@ -5,6 +5,12 @@
 #include <Game/TowerDefense/Enemy.h>
 #include <Game/TowerDefense/World.h>
 #include <Game/Rounds/Round.h>
+#include <Game/Generators/WaveGenerator.h>
+
+#include <Game/Snapshot/SnapshotFormat.h>
+
+#include <Utility/StateHasher.h>
+#include <Utility/Profiler.h>
 
 #include <Dragon/Graphics/RenderTarget.h>
 #include <Platform/SFML/SfmlHelpers.h>
@@ -17,48 +23,50 @@ Spawner::~Spawner()
 
 void Spawner::UpdateWaveTiming(float waveTime)
 {
+	if (m_groups.empty())
+		return;
+
 	m_timeBetweenGroups = waveTime / m_groups.size();
 
 	// Reset timers
 	m_currentGroupTime = m_timeBetweenGroups; // Must be set to group time to start the first group spawn.
-	m_timeBetweenEnemiesForGroup = m_timeBetweenGroups / m_groups.front().size();
+	m_timeBetweenEnemiesForGroup = m_timeBetweenGroups / m_groups.front().m_count;
 
 	m_currentEnemyTime = 0.f; // Immediatly start.
 }
 
 void Spawner::ClearEnemyGroups()
 {
+	// Groups only describe enemies, Nothing has been created yet.
 	while (!m_groups.empty())
 	{
-		auto& group = m_groups.front();
-
-		while (!group.empty())
-		{
-			// Delete enemies.
-			Enemy* pEnemy = group.front();
-			delete pEnemy;
-			group.pop();
-		}
-
 		m_groups.pop();
 	}
 }
 
 void Spawner::Update(float dt, Round* pRound)
 {
+	PCG_PROFILE_ZONE("Spawner::Update");
+
+	// Nothing to spawn before the first wave started.
+	if (m_groups.empty())
+		return;
+
 	// Enemy Group
-	auto& currentGroup = m_groups.front();
+	SpawnDescriptor& currentGroup = m_groups.front();
 
 	m_currentEnemyTime -= dt;
 	if (m_currentEnemyTime < 0.0f)
 	{
 		m_currentEnemyTime = m_timeBetweenEnemiesForGroup;
 
-		// Spawn the next enemy in the queue.
-		if (!currentGroup.empty())
+		// Create and spawn the next enemy in the group.
+		if (!currentGroup.IsEmpty())
 		{
-			Enemy* pEnemy = currentGroup.front();
-			currentGroup.pop();
+			assert(m_pWaveGenerator);
+
+			Enemy* pEnemy = m_pWaveGenerator->CreateEnemy(currentGroup, currentGroup.m_spawned);
+			++currentGroup.m_spawned;
 
 			// Add Score for this spawned enemy.
 			if (pRound)
@@ -66,23 +74,24 @@ void Spawner::Update(float dt, Round* pRound)
 
 			pEnemy->SetPath(&m_pathToGoal); // Set the path of the enemy.
 			m_pWorld->AddEnemy(pEnemy);
+			++m_liveEnemies;
 		}
 	}
 
 	// Continue to next group if all enemies have spawned in from the current group.
 	m_currentGroupTime -= dt;
-	if (m_currentGroupTime < 0.0f && currentGroup.empty())
+	if (m_currentGroupTime < 0.0f && currentGroup.IsEmpty())
 	{
+		m_groups.pop();
+
 		// If there are still groups left continue.
 		if (!m_groups.empty())
 		{
-			m_groups.pop();
-
 			// Reset Timer
 			m_currentGroupTime = m_timeBetweenGroups;
 
 			// Calculate new timing data for the next group.
-			m_timeBetweenEnemiesForGroup = m_timeBetweenGroups / m_groups.front().size();
+			m_timeBetweenEnemiesForGroup = m_timeBetweenGroups / m_groups.front().m_count;
 		}
 	}
 }
@@ -102,3 +111,57 @@ void Spawner::Render(dragon::RenderTarget& target)
 	pTarget->draw(vertices.data(), vertices.size(), sf::PrimitiveType::LineStrip);
 #endif
 }
+
+void Spawner::OnEnemyEvents(const EnemyEvents& events)
+{
+	// Enemies remember the path they follow, Which is the one of the spawner that released them.
+	for (const EnemyEvent& event : events)
+	{
+		if (event.m_pPath == &m_pathToGoal && m_liveEnemies > 0)
+			--m_liveEnemies;
+	}
+}
+
+void Spawner::Hash(StateHasher& hasher) const
+{
+	hasher.Add(m_position.x);
+	hasher.Add(m_position.y);
+	hasher.Add(m_currentGroupTime);
+	hasher.Add(m_currentEnemyTime);
+
+	for (const dragon::Vector2f& position : m_pathToGoal)
+	{
+		hasher.Add(position.x);
+		hasher.Add(position.y);
+	}
+
+	for (const SpawnDescriptor& group : m_groups.get_container())
+	{
+		hasher.Add(group.m_enemyType);
+		hasher.Add(group.m_count);
+		hasher.Add(group.m_spawned);
+		hasher.Add(group.m_statsSeed);
+	}
+}
+
+void Spawner::Save(SpawnerRecord& record) const
+{
+	record.m_x = m_position.x;
+	record.m_y = m_position.y;
+	record.m_timeBetweenGroups = m_timeBetweenGroups;
+	record.m_timeBetweenEnemiesForGroup = m_timeBetweenEnemiesForGroup;
+	record.m_currentGroupTime = m_currentGroupTime;
+	record.m_currentEnemyTime = m_currentEnemyTime;
+}
+
+void Spawner::Load(const SpawnerRecord& record)
+{
+	m_position = { record.m_x, record.m_y };
+	m_timeBetweenGroups = record.m_timeBetweenGroups;
+	m_timeBetweenEnemiesForGroup = record.m_timeBetweenEnemiesForGroup;
+	m_currentGroupTime = record.m_currentGroupTime;
+	m_currentEnemyTime = record.m_currentEnemyTime;
+
+	// Recounted as the enemies are restored.
+	m_liveEnemies = 0;
+}
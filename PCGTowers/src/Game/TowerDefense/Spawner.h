@@ -1,6 +1,8 @@
 #pragma once
 
 
+#include <Game/TowerDefense/EnemyEvents.h>
+
 #include <Dragon/Generic/Math.h>
 
 #include <EASTL/vector.h>
@@ -11,10 +13,41 @@ namespace dragon
 	class RenderTarget;
 }
 
+class StateHasher;
+struct SpawnerRecord;
+
+/// <summary>
+/// Compact description of a group of enemies.
+/// Enemies are only created once the spawner releases them into the world.
+/// </summary>
+struct SpawnDescriptor
+{
+	char m_enemyType;			// Enemy type symbol from the wave grammar.
+	unsigned int m_count;		// Amount of enemies in the group.
+	unsigned int m_spawned;		// Amount of enemies that have been released.
+	unsigned int m_statsSeed;	// Seed the stats of each enemy in the group are derived from.
+
+	SpawnDescriptor()
+		: SpawnDescriptor(0, 0, 0)
+	{}
+
+	SpawnDescriptor(char enemyType, unsigned int count, unsigned int statsSeed)
+		: m_enemyType(enemyType)
+		, m_count(count)
+		, m_spawned(0)
+		, m_statsSeed(statsSeed)
+	{}
+
+	unsigned int GetRemaining() const { return m_count - m_spawned; }
+	bool IsEmpty() const { return m_spawned >= m_count; }
+};
+
 class Spawner
 {
 public:
-	using SpawnQueue = eastl::queue<class Enemy*>;
+
+	using Groups = eastl::queue<SpawnDescriptor>;
+	using Path = eastl::vector<dragon::Vector2f>;
 
 private:
 
@@ -23,6 +56,11 @@ private:
 	/// </summary>
 	class World* m_pWorld;
 
+	/// <summary>
+	/// Generator used to create the enemies described by the groups.
+	/// </summary>
+	const class WaveGenerator* m_pWaveGenerator;
+
 	/// <summary>
 	/// The position this spawner is located at.
 	/// </summary>
@@ -51,24 +89,29 @@ private:
 	/// </summary>
 	float m_currentEnemyTime;
 
-	using Groups = eastl::queue<SpawnQueue>;
 	Groups m_groups;
 
-	using Path = eastl::vector<dragon::Vector2f>;
 	Path m_pathToGoal;
 
+	/// <summary>
+	/// Enemies released by this spawner that are still in the world.
+	/// </summary>
+	uint32_t m_liveEnemies;
+
 public:
 
 	Spawner() = default;
 
 	Spawner(World* pWorld, dragon::Vector2 position, Path&& path)
 		: m_pWorld(pWorld)
+		, m_pWaveGenerator(nullptr)
 		, m_position(position) 
 		, m_pathToGoal(eastl::move(path))
 		, m_timeBetweenGroups(0.0f)
 		, m_timeBetweenEnemiesForGroup(0.0f)
 		, m_currentGroupTime(0.0f)
 		, m_currentEnemyTime(0.0f)
+		, m_liveEnemies(0)
 	{}
 
 	~Spawner();
@@ -78,12 +121,38 @@ public:
 	/// </summary>
 	void UpdateWaveTiming(float waveTime);
 
-	void EmplaceEnemyGroup(SpawnQueue&& queue) { m_groups.emplace_back(eastl::move(queue)); }
+	void SetWaveGenerator(const WaveGenerator* pGenerator) { m_pWaveGenerator = pGenerator; }
+
+	void EmplaceEnemyGroup(const SpawnDescriptor& group) { m_groups.emplace_back(group); }
 	void ClearEnemyGroups();
 
 	void EmplacePath(Path&& path) { m_pathToGoal = eastl::move(path); }
 
+	dragon::Vector2 GetPosition() const { return m_position; }
+	const Path& GetPath() const { return m_pathToGoal; }
+	const Groups& GetGroups() const { return m_groups; }
+
+	uint32_t GetLiveEnemyCount() const { return m_liveEnemies; }
+
+	/// <summary>
+	/// Counts an enemy that was restored from a snapshot.
+	/// </summary>
+	void AddLiveEnemy() { ++m_liveEnemies; }
+
+	/// <summary>
+	/// Stops counting the enemies of this spawner that died or despawned.
+	/// </summary>
+	void OnEnemyEvents(const EnemyEvents& events);
+
 	void Update(float dt, class Round* pRound);
 
 	void Render(dragon::RenderTarget& target);
+
+	void Hash(StateHasher& hasher) const;
+
+	/// <summary>
+	/// Saves the spawn timers, The path and groups are stored in their own snapshot sections.
+	/// </summary>
+	void Save(SpawnerRecord& record) const;
+	void Load(const SpawnerRecord& record);
 };
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <Game/Biome.h>
+
 #include <Dragon/Game/Tilemap/Tilemap.h>
 
 struct TDTileData
@@ -7,6 +9,7 @@ struct TDTileData
 	float m_noise;			// Noise data of this tile.
 	float m_temperature;	// Temperature of this tile in Fahrenheit
 	float m_moistureLevel;	// Moisture level of this tile in CM^3
+	BiomeType m_biome;		// Biome classified from the temperature and moisture of this tile.
 
 	bool m_isTurretPlaceable; // If a turret can be placed on this tile.
 
@@ -14,6 +17,7 @@ struct TDTileData
 		: m_noise(0.0f)
 		, m_temperature(0.0f)
 		, m_moistureLevel(0.0f)
+		, m_biome(BiomeType::kUnknown)
 		, m_isTurretPlaceable(true)
 	{}
 };
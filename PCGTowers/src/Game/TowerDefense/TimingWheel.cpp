@@ -0,0 +1,69 @@
+#include "TimingWheel.h"
+
+void TimingWheel::Reset(uint32_t tick)
+{
+	for (Slot& slot : m_slots)
+		slot.clear();
+
+	m_tick = tick;
+	m_size = 0;
+}
+
+void TimingWheel::Schedule(uint32_t id, uint32_t tick)
+{
+	// Already processed, Due on the next tick instead.
+	if ((int32_t)(tick - m_tick) < 0)
+		tick = m_tick;
+
+	if (tick - m_tick > kMaxDelay)
+		tick = m_tick + kMaxDelay;
+
+	Insert({ tick, id });
+	++m_size;
+}
+
+void TimingWheel::Advance(uint32_t tick, eastl::vector<uint32_t>& due)
+{
+	while ((int32_t)(tick - m_tick) >= 0)
+	{
+		// Starting a new span on a level, Its slot for this span moves down. The highest level goes first so its entries cascade all the way.
+		uint32_t topLevel = 0;
+		while (topLevel + 1 < kLevelCount && (m_tick & ((1u << (kSlotBits * (topLevel + 1))) - 1)) == 0)
+			++topLevel;
+
+		for (uint32_t level = topLevel; level > 0; --level)
+			Cascade(level, (m_tick >> (kSlotBits * level)) & (kSlotCount - 1));
+
+		Slot& slot = m_slots[m_tick & (kSlotCount - 1)];
+		for (const Entry& entry : slot)
+			due.push_back(entry.m_id);
+
+		m_size -= slot.size();
+		slot.clear();
+
+		++m_tick;
+	}
+}
+
+void TimingWheel::Insert(const Entry& entry)
+{
+	// Lowest level whose slots still tell the tick apart from the current one.
+	uint32_t delay = entry.m_tick - m_tick;
+
+	uint32_t level = 0;
+	while (level + 1 < kLevelCount && delay >= (1u << (kSlotBits * (level + 1))))
+		++level;
+
+	uint32_t slot = (entry.m_tick >> (kSlotBits * level)) & (kSlotCount - 1);
+	m_slots[level * kSlotCount + slot].push_back(entry);
+}
+
+void TimingWheel::Cascade(uint32_t level, uint32_t slot)
+{
+	// Swapped out first, Entries a full turn ahead land right back in this slot.
+	m_cascade.clear();
+	m_cascade.swap(m_slots[level * kSlotCount + slot]);
+
+	for (const Entry& entry : m_cascade)
+		Insert(entry);
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <EASTL/array.h>
+#include <EASTL/vector.h>
+
+#include <cstdint>
+
+/// <summary>
+/// Schedules ids to come due on a later tick, Scheduling and advancing a tick are O(1) however far ahead the tick is. (Hierarchical timing wheel)
+/// Every level has 64 slots, The slots of level L each span 64^L ticks. Entries move down a level whenever the level below wraps around.
+/// </summary>
+class TimingWheel
+{
+public:
+
+	static constexpr uint32_t kSlotBits = 6;
+	static constexpr uint32_t kSlotCount = 1 << kSlotBits;
+	static constexpr uint32_t kLevelCount = 4;
+
+	/// <summary>
+	/// Furthest ahead an entry can be scheduled, Later entries come due early.
+	/// </summary>
+	static constexpr uint32_t kMaxDelay = (1u << (kSlotBits * kLevelCount)) - 1;
+
+private:
+
+	struct Entry
+	{
+		uint32_t m_tick;
+		uint32_t m_id;
+	};
+
+	using Slot = eastl::vector<Entry>;
+
+	eastl::array<Slot, kSlotCount * kLevelCount> m_slots;
+
+	/// <summary>
+	/// Entries taken out of a slot that is being cascaded, Kept so cascading doesn't allocate.
+	/// </summary>
+	Slot m_cascade;
+
+	/// <summary>
+	/// Next tick Advance will process.
+	/// </summary>
+	uint32_t m_tick;
+
+	size_t m_size;
+
+public:
+
+	TimingWheel()
+		: m_tick(0)
+		, m_size(0)
+	{}
+
+	/// <summary>
+	/// Drops every entry, The next tick to process becomes [tick].
+	/// </summary>
+	void Reset(uint32_t tick);
+
+	/// <summary>
+	/// [id] comes due on [tick], Ticks that were already processed come due on the next one.
+	/// Entries can't be cancelled, Check whether an id is still expected when it comes due.
+	/// </summary>
+	void Schedule(uint32_t id, uint32_t tick);
+
+	/// <summary>
+	/// Processes every tick up to and including [tick], Appends the ids that came due in the order they did.
+	/// </summary>
+	void Advance(uint32_t tick, eastl::vector<uint32_t>& due);
+
+	size_t GetSize() const { return m_size; }
+
+private:
+
+	void Insert(const Entry& entry);
+
+	/// <summary>
+	/// Moves the entries of [slot] on [level] down to the levels below.
+	/// </summary>
+	void Cascade(uint32_t level, uint32_t slot);
+};
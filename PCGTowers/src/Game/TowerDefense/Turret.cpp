@@ -4,6 +4,10 @@
 
 #include <Game/TowerDefense/Enemy.h>
 
+#include <Game/Snapshot/SnapshotFormat.h>
+
+#include <Utility/StateHasher.h>
+
 #include <Dragon/Graphics/RenderTexture.h>
 #include <SFML/Graphics.hpp>
 #include <Platform/SFML/SfmlHelpers.h>
@@ -16,44 +20,64 @@ static constexpr dragon::Color g_kUpgradeOutlineColors[] =
 	dragon::Color(0.895f, 0.894f, 0.893f) // Platinum
 };
 
-void Turret::Update(float dt)
+const char* GetTargetingModeName(TargetingMode mode)
+{
+	switch (mode)
+	{
+	case TargetingMode::kClosest: return "Closest";
+	case TargetingMode::kFirst: return "First";
+	case TargetingMode::kLast: return "Last";
+	default: return "Unknown";
+	}
+}
+
+bool Turret::Update(float dt, const EnemySnapshot& enemies, TurretShot& shot)
 {
-	// Cooldown timer
-	m_lastDamageTime -= dt;
+	// Cooldown timer, Stops once it ran out so sleeping turrets have a bounded amount to catch up on.
+	if (m_lastDamageTime >= 0.0f)
+		m_lastDamageTime -= dt;
+
+	if (!m_target.IsValid())
+		return false;
 
-	// Determine if target is still within range and we are enabled.
-	if (m_pTarget && m_enabled)
+	// Killed and removed from the world.
+	uint32_t target = enemies.Find(m_target);
+	if (target == EnemySnapshot::kNone)
 	{
-		float distanceSqrd = dragon::Vector2f::DistanceSquared(m_position, m_pTarget->GetPosition());
+		ClearTarget();
+		return false;
+	}
+
+	// Determine if target is still within range once we can shoot and are enabled.
+	if (m_enabled && m_lastDamageTime < 0.0f)
+	{
+		float distanceSqrd = dragon::Vector2f::DistanceSquared(m_position, enemies.GetPosition(target));
 
 		// Check if within range.
 		if (distanceSqrd < m_range * m_range)
 		{
-			if (m_lastDamageTime < 0.0f)
-			{
-				ShootTarget(m_pTarget);
-			}
-		}
-		else
-		{
-			ClearTarget();
+			ShootTarget(target, shot);
+			return true;
 		}
+
+		ClearTarget();
 	}
 
+	return false;
 }
 
-void Turret::Render(dragon::RenderTarget& target)
+void Turret::Render(dragon::RenderTarget& target, const EnemyRegistry& enemies)
 {
 	sf::RenderTarget* pSfTarget = target.GetNativeTarget<sf::RenderTarget*>();
 
 	// Draw turret range in debug mode.
 	sf::CircleShape turretShape(g_kTileSize / 2.0f, 5);
 
-	// Draw turret, Rotating towards m_pTarget
+	// Draw turret, Rotating towards the target
 	float rotation = 0.0f;
-	if (m_pTarget)
+	if (const Enemy* pTarget = enemies.Resolve(m_target))
 	{
-		dragon::Vector2f directionNormalized = (m_pTarget->GetPosition() - m_position).Normalized();
+		dragon::Vector2f directionNormalized = (pTarget->GetPosition() - m_position).Normalized();
 		rotation = std::atan2(directionNormalized.y, directionNormalized.x);
 	}
 
@@ -76,48 +100,136 @@ void Turret::Render(dragon::RenderTarget& target)
 	pSfTarget->draw(turretShape);
 }
 
-void Turret::ShootTarget(Enemy* pEnemy)
+void Turret::ShootTarget(uint32_t enemy, TurretShot& shot)
 {
 	// Apply cooldown.
 	m_lastDamageTime = m_cooldown;
 
-	// Do damage.
-	pEnemy->Damage(m_damage);
-
-	// It would've been a lot better to subscribe to some event. But this works.
-	if (pEnemy->GetHealth() <= 0.0f)
-		ClearTarget();
+	// Damage is done by the world, Turrets find out about kills through their handle once the enemy is removed.
+	shot.m_enemy = enemy;
+	shot.m_damage = m_damage;
 }
 
-void Turret::FindTarget(eastl::vector<class Enemy*>& enemies)
+void Turret::FindTarget(const PathTracker& tracker, const EnemySnapshot& enemies, float dt, TargetingStats* pStats)
 {
-	// Only find a target if we need to. This speeds things up since we're searching over all enemies.
-	if (m_pTarget)
+	// Only find a target if we need to, And only once it can be shot on the next update. It would be outdated by then otherwise.
+	if (m_target.IsValid() || !m_enabled || m_lastDamageTime - dt >= 0.0f)
 		return;
 
-	// Best Match
-	Enemy* pClosestTarget = nullptr;
-	float closestDistanceSqrd = eastl::numeric_limits<float>::infinity();
+	// Best Match, Lower scores are better.
+	uint32_t bestTarget = EnemySnapshot::kNone;
+	float bestScore = eastl::numeric_limits<float>::infinity();
+	size_t distanceTests = 0;
+
+	// The snapshot only holds living enemies.
+	auto isInRange = [this, &enemies, &distanceTests](uint32_t enemy, float& distanceSqrd) -> bool
+	{
+		distanceSqrd = dragon::Vector2f::DistanceSquared(m_position, enemies.GetPosition(enemy));
+		++distanceTests;
+
+		return distanceSqrd < m_range * m_range;
+	};
 
-	for (Enemy* pEnemy : enemies)
+	for (const PathInterval& interval : m_coverage)
 	{
-		// Filter out enemies that are dead.
-		if (pEnemy->GetHealth() <= 0.0f)
-			continue;
+		PathTracker::EnemyRange range = tracker.FindEnemies(interval);
+		const float kPathLength = tracker.GetPathLength(interval.m_path);
 
-		float distanceSqrd = dragon::Vector2f::DistanceSquared(m_position, pEnemy->GetPosition());
+		float distanceSqrd = 0.0f;
 
-		// Within distance and closest.
-		if (distanceSqrd < m_range * m_range && closestDistanceSqrd > distanceSqrd)
+		switch (m_targetingMode)
 		{
-			closestDistanceSqrd = distanceSqrd;
-			pClosestTarget = pEnemy;
+		case TargetingMode::kFirst:
+			// Furthest along first, The first one in range is the best of this stretch.
+			for (const PathTracker::TrackedEnemy* pTracked = range.second; pTracked != range.first; --pTracked)
+			{
+				if (isInRange(pTracked[-1].m_order, distanceSqrd))
+				{
+					float remaining = kPathLength - pTracked[-1].m_distance;
+					if (remaining < bestScore)
+					{
+						bestScore = remaining;
+						bestTarget = pTracked[-1].m_order;
+					}
+					break;
+				}
+			}
+			break;
+
+		case TargetingMode::kLast:
+			for (const PathTracker::TrackedEnemy* pTracked = range.first; pTracked != range.second; ++pTracked)
+			{
+				if (isInRange(pTracked->m_order, distanceSqrd))
+				{
+					float remaining = kPathLength - pTracked->m_distance;
+					if (-remaining < bestScore)
+					{
+						bestScore = -remaining;
+						bestTarget = pTracked->m_order;
+					}
+					break;
+				}
+			}
+			break;
+
+		default:
+			for (const PathTracker::TrackedEnemy* pTracked = range.first; pTracked != range.second; ++pTracked)
+			{
+				if (isInRange(pTracked->m_order, distanceSqrd) && distanceSqrd < bestScore)
+				{
+					bestScore = distanceSqrd;
+					bestTarget = pTracked->m_order;
+				}
+			}
+			break;
 		}
 	}
 
 	// Set target
-	m_pTarget = pClosestTarget;
+	m_target = bestTarget != EnemySnapshot::kNone ? enemies.GetHandle(bestTarget) : EnemyHandle();
+
+	if (pStats)
+	{
+		++pStats->m_scans;
+		pStats->m_distanceTests += distanceTests;
+	}
+
+}
 
+void Turret::Sleep(uint32_t tick, uint32_t wakeTick)
+{
+	m_isAsleep = true;
+	m_sleepTick = tick;
+	m_wakeTick = wakeTick;
+}
+
+void Turret::Wake(uint32_t tick, float dt)
+{
+	m_lastDamageTime = GetLastDamageTime(tick, dt);
+	m_isAsleep = false;
+}
+
+float Turret::GetLastDamageTime(uint32_t tick, float dt) const
+{
+	if (!m_isAsleep)
+		return m_lastDamageTime;
+
+	// Replays the updates that were skipped, So the timer matches an awake turret to the bit.
+	float lastDamageTime = m_lastDamageTime;
+	for (uint32_t skipped = m_sleepTick + 1; skipped != tick && lastDamageTime >= 0.0f; ++skipped)
+		lastDamageTime -= dt;
+
+	return lastDamageTime;
+}
+
+uint32_t Turret::GetCooldownTicks(float dt) const
+{
+	if (m_lastDamageTime < 0.0f)
+		return 0;
+
+	// The timer runs out on update n, A target is looked for on the update before that.
+	uint32_t updates = (uint32_t)(m_lastDamageTime / dt);
+	return updates > 2 ? updates - 2 : 0;
 }
 
 void Turret::Upgrade()
@@ -126,4 +238,46 @@ void Turret::Upgrade()
 	m_damage *= 1.0f + (m_upgradeLevel * 0.15f);
 	m_range *= 1.05f;
 	m_cooldown *= .95f;
+}
+
+void Turret::Hash(StateHasher& hasher, uint32_t tick, float dt) const
+{
+	hasher.Add(m_position.x);
+	hasher.Add(m_position.y);
+	hasher.Add(m_damage);
+	hasher.Add(m_range);
+	hasher.Add(m_cooldown);
+	hasher.Add(GetLastDamageTime(tick, dt));
+	hasher.Add(m_upgradeLevel);
+	hasher.Add(m_enabled);
+	hasher.Add((uint32_t)m_targetingMode);
+	hasher.Add(m_target.IsValid());
+}
+
+void Turret::Save(TurretRecord& record, uint32_t tick, float dt) const
+{
+	record.m_x = m_position.x;
+	record.m_y = m_position.y;
+	record.m_damage = m_damage;
+	record.m_range = m_range;
+	record.m_cooldown = m_cooldown;
+	record.m_lastDamageTime = GetLastDamageTime(tick, dt);
+	record.m_upgradeLevel = (uint32_t)m_upgradeLevel;
+	record.m_isEnabled = m_enabled ? 1 : 0;
+	record.m_targetingMode = (uint32_t)m_targetingMode;
+}
+
+void Turret::Load(const TurretRecord& record)
+{
+	m_position = { record.m_x, record.m_y };
+	m_damage = record.m_damage;
+	m_range = record.m_range;
+	m_cooldown = record.m_cooldown;
+	m_lastDamageTime = record.m_lastDamageTime;
+	m_upgradeLevel = record.m_upgradeLevel;
+	m_enabled = record.m_isEnabled != 0;
+	m_targetingMode = record.m_targetingMode < (uint32_t)TargetingMode::kCount ? (TargetingMode)record.m_targetingMode : TargetingMode::kClosest;
+	m_target = EnemyHandle();
+	m_coverage.clear();
+	m_isAsleep = false;
 }
\ No newline at end of file
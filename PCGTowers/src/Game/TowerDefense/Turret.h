@@ -2,6 +2,10 @@
 
 #include <Config.h>
 
+#include <Game/TowerDefense/PathTracker.h>
+#include <Game/TowerDefense/EnemyRegistry.h>
+#include <Game/TowerDefense/EnemySnapshot.h>
+
 #include <Dragon/Generic/Math.h>
 #include <EASTL/vector.h>
 
@@ -10,6 +14,46 @@ namespace dragon
 	class RenderTarget;
 }
 
+class StateHasher;
+struct TurretRecord;
+
+/// <summary>
+/// Counts the work done by FindTarget.
+/// </summary>
+struct TargetingStats
+{
+	size_t m_scans;				// Turrets that searched for a target.
+	size_t m_distanceTests;		// Enemies whose distance was tested.
+
+	TargetingStats()
+		: m_scans(0)
+		, m_distanceTests(0)
+	{}
+};
+
+/// <summary>
+/// Damage a turret deals on this tick, Applied to the enemy once every turret picked what to shoot.
+/// </summary>
+struct TurretShot
+{
+	uint32_t m_turret;	// Tile index of the turret, Shots are applied in this order.
+	uint32_t m_enemy;	// Index in the EnemySnapshot.
+	float m_damage;
+};
+
+/// <summary>
+/// Which enemy in range a turret picks.
+/// </summary>
+enum class TargetingMode : uint32_t
+{
+	kClosest,	// Closest to the turret.
+	kFirst,		// Closest to the base along its path.
+	kLast,		// Furthest from the base along its path.
+	kCount
+};
+
+const char* GetTargetingModeName(TargetingMode mode);
+
 class Turret
 {
 	/// <summary>
@@ -47,10 +91,32 @@ class Turret
 	/// </summary>
 	bool m_enabled;
 
+	TargetingMode m_targetingMode;
+
 	/// <summary>
-	/// Last closest match, If nullptr the turret will look for the new closest match.
+	/// Wether the world stopped updating this turret, Until it has something to do. (See World::UpdateTurrets)
 	/// </summary>
-	class Enemy* m_pTarget;
+	bool m_isAsleep;
+
+	/// <summary>
+	/// Last tick the turret was updated on before falling asleep.
+	/// </summary>
+	uint32_t m_sleepTick;
+
+	/// <summary>
+	/// Tick the turret is scheduled to wake up on, Tells outdated schedules apart.
+	/// </summary>
+	uint32_t m_wakeTick;
+
+	/// <summary>
+	/// Stretches of the paths within range, Computed by the world whenever the paths or range change.
+	/// </summary>
+	PathCoverage m_coverage;
+
+	/// <summary>
+	/// Last match, If it doesn't resolve the turret will look for a new match.
+	/// </summary>
+	EnemyHandle m_target;
 
 public:
 
@@ -62,23 +128,45 @@ public:
 		, m_lastDamageTime(0.0f)
 		, m_upgradeLevel(1)
 		, m_enabled(true)
-		, m_pTarget(nullptr)
+		, m_targetingMode(TargetingMode::kClosest)
+		, m_isAsleep(false)
+		, m_sleepTick(0)
+		, m_wakeTick(0)
 	{}
 
-	void Update(float dt);
+	/// <summary>
+	/// Runs the cooldown and shoots the target, Only changes the turret itself.
+	/// Returns wether it shot, The damage goes into [shot] for the world to apply.
+	/// </summary>
+	bool Update(float dt, const EnemySnapshot& enemies, TurretShot& shot);
 
-	void Render(dragon::RenderTarget& target);
+	void Render(dragon::RenderTarget& target, const EnemyRegistry& enemies);
 
 	/// <summary>
-	/// Find and shoot the closest target.
+	/// Find the target to shoot according to the targeting mode, Only once the turret can shoot on the next update.
+	/// Only the enemies [tracker] has on the covered stretches of the paths are tested, [enemies] has to be taken from the same enemies.
 	/// </summary>
-	/// <param name="enemies"></param>
-	void FindTarget(eastl::vector<class Enemy*>& enemies);
+	/// <param name="pStats">Optional, Accumulates the work done.</param>
+	void FindTarget(const PathTracker& tracker, const EnemySnapshot& enemies, float dt, TargetingStats* pStats = nullptr);
+
+	void SetCoverage(PathCoverage&& coverage) { m_coverage = eastl::move(coverage); }
+	const PathCoverage& GetCoverage() const { return m_coverage; }
+
+	TargetingMode GetTargetingMode() const { return m_targetingMode; }
+	void SetTargetingMode(TargetingMode mode) { m_targetingMode = mode; ClearTarget(); }
 
 	/// <summary>
 	/// Clears the target. So that the turret can start finding a new target.
 	/// </summary>
-	void ClearTarget() { m_pTarget = nullptr; }
+	void ClearTarget() { m_target = EnemyHandle(); }
+
+	/// <summary>
+	/// Wether the turret has a target, The target might have left the world since.
+	/// </summary>
+	bool HasTarget() const { return m_target.IsValid(); }
+
+	EnemyHandle GetTarget() const { return m_target; }
+	void SetTarget(EnemyHandle target) { m_target = target; }
 
 	void SetPosition(dragon::Vector2f pos) { m_position = pos; }
 	dragon::Vector2f GetPosition() const { return m_position; }
@@ -112,7 +200,41 @@ public:
 	/// <returns></returns>
 	bool IsActive() const { return m_enabled; }
 
+	/// <summary>
+	/// Stops updating the turret after [tick], Until [wakeTick] or whenever it is woken up earlier.
+	/// </summary>
+	void Sleep(uint32_t tick, uint32_t wakeTick);
+
+	/// <summary>
+	/// Resumes updating on [tick], Catches up on the cooldown of the ticks slept through.
+	/// </summary>
+	void Wake(uint32_t tick, float dt);
+
+	bool IsAsleep() const { return m_isAsleep; }
+	uint32_t GetWakeTick() const { return m_wakeTick; }
+
+	/// <summary>
+	/// Cooldown timer as it would be on [tick] had the turret been updated every tick.
+	/// </summary>
+	float GetLastDamageTime(uint32_t tick, float dt) const;
+
+	/// <summary>
+	/// Updates that can be skipped before the cooldown lets the turret look for a target or shoot, Might underestimate by a tick.
+	/// </summary>
+	uint32_t GetCooldownTicks(float dt) const;
+
+	/// <summary>
+	/// Hashes the turret as of [tick], A sleeping turret hashes the same as one that was updated every tick.
+	/// </summary>
+	void Hash(StateHasher& hasher, uint32_t tick, float dt) const;
+
+	/// <summary>
+	/// Saves the turret's stats and state as of [tick], The target and tile are resolved by the world.
+	/// </summary>
+	void Save(TurretRecord& record, uint32_t tick, float dt) const;
+	void Load(const TurretRecord& record);
+
 private:
 
-	void ShootTarget(class Enemy* pEnemy);
+	void ShootTarget(uint32_t enemy, TurretShot& shot);
 };
\ No newline at end of file
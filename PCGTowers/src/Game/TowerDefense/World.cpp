@@ -6,14 +6,26 @@
 #include <Game/TowerDefense/Enemy.h>
 #include <Game/TowerDefense/Spawner.h>
 #include <Game/Rounds/Round.h>
+#include <Game/Snapshot/WorldSnapshot.h>
+#include <Game/Bots/GreedyBot.h>
 
 #include <Dragon/Application/Application.h>
 #include <Dragon/Graphics/RenderTarget.h>
 #include <Dragon/Application/Window/WindowEvents.h>
 
+#include <Utility/StateHasher.h>
+#include <Utility/Profiler.h>
+
+#include <EASTL/sort.h>
+#include <EASTL/algorithm.h>
+#include <EASTL/numeric_limits.h>
+
 #include <SFML/Graphics.hpp>
 
 #include <iostream>
+#include <cstdio>
+#include <chrono>
+#include <thread>
 
 static constexpr dragon::Color g_kTurretRangeColor = dragon::Colors::Black;
 static constexpr dragon::Color g_kTurretPlaceableColor = dragon::Colors::LightGreen;
@@ -22,31 +34,89 @@ static constexpr dragon::Color g_kMouseTileColor = dragon::Colors::RebeccaPurple
 static constexpr float g_kTranslucencyValue = 0.4f;
 static constexpr float g_kOutlineSize = 1.0f;
 
+/// <summary>
+/// Range of a newly bought turret, Upgrades extend it.
+/// </summary>
+static constexpr float g_kTurretRange = 100.0f;
+
+/// <summary>
+/// Aiming a turret is cheap, Every thread needs this many to make up for starting it.
+/// </summary>
+static constexpr size_t g_kMinTurretsPerThread = 256;
+
+/// <summary>
+/// Compares the points of two paths, Carved paths always share the same tile centroids.
+/// </summary>
+static bool IsSamePath(const Path& left, const Path& right)
+{
+	if (left.size() != right.size())
+		return false;
+
+	for (size_t i = 0; i < left.size(); ++i)
+	{
+		if (left[i].x != right[i].x || left[i].y != right[i].y)
+			return false;
+	}
+
+	return true;
+}
+
 World::~World()
 {
-	m_pCurrentRound->Pause();
+	// Make sure the staging thread is no longer using the world.
+	m_roundStager.Cancel();
+
+	if (m_pCurrentRound)
+		m_pCurrentRound->Pause();
+
 	ClearEnemies();
 
 	delete m_pDefaultWaveGenerator;
 	delete m_pCurrentRound;
 }
 
-bool World::Init()
+bool World::Init(bool isHeadless)
 {
-	if (!m_font.loadFromFile("retro_gaming.ttf"))
+	m_isHeadless = isHeadless;
+	m_isJournalEnabled = !isHeadless;
+
+	if (!m_isHeadless && !m_font.loadFromFile("retro_gaming.ttf"))
 		return false;
 
-	m_random.Seed(time(0));
+	m_random.Seed((unsigned int)time(0), RandomStream::kWorld);
 
 	m_tilemap.Init({ g_kMapSize, g_kMapSize }, { g_kTileSize, g_kTileSize });
-	m_tilemap.LoadTileset("tileset.png");
+
+	if (!m_isHeadless)
+		m_tilemap.LoadTileset("tileset.png");
 
 	m_mapGenerator.Init();
 
+	if (!m_roundStager.Init())
+		return false;
+
 	m_pDefaultWaveGenerator = new WaveGenerator();
 	m_pDefaultWaveGenerator->InitDefaults();
 
-	InitializeUserInterface();
+	// Scoring, Killing an enemy earns the damage it would've done to the base.
+	m_enemyEvents.Subscribe([this](const EnemyEvents& events)
+	{
+		for (const EnemyEvent& event : events)
+		{
+			if (event.m_type == EnemyEventType::kDied)
+				m_playerGold += event.m_damage;
+		}
+	});
+
+	// Spawners keep count of the enemies they have out on their path.
+	m_enemyEvents.Subscribe([this](const EnemyEvents& events)
+	{
+		if (m_pCurrentRound)
+			m_pCurrentRound->OnEnemyEvents(events);
+	});
+
+	if (!m_isHeadless)
+		InitializeUserInterface();
 
 	return true;
 }
@@ -65,21 +135,53 @@ void World::GenerateWorld()
 
 void World::NextRound()
 {
+	PCG_PROFILE_ZONE("World::NextRound");
+
 	if (m_pCurrentRound)
 	{
 		m_score += m_pCurrentRound->GetRoundScore();
 
 		ClearEnemies();
+
+		// The spawners the despawned enemies came from are about to go.
+		m_enemyEvents.Flush();
 		delete m_pCurrentRound;
 	}
 
-	// Generate random round information.
-	Round::RoundData data;
-	data.m_seed = m_random.Random<unsigned int>();
-	data.m_temperature = m_random.RandomRange(g_kMinTemperature, g_kMaxTemperature);
-	data.m_precipitation = m_random.RandomRange(g_kMinPrecipitation, g_kMaxPrecipitation);
+	// A staged round drawn before the difficulty changed is thrown away.
+	if (m_roundStager.IsStaged() && m_roundStager.GetStagedData().m_difficulty != m_difficulty)
+		m_roundStager.Cancel();
+
+	// Swap in the round that was generated in the background, Otherwise generate it on the spot.
+	if (m_roundStager.IsStaged())
+	{
+		m_pCurrentRound = m_roundStager.Acquire(m_tilemap);
+
+		// Only the part of the staging the game thread didn't wait for was saved.
+		DLOG("Swapped in staged round in %.3fms, Waited %.3fms for the worker. Staging took %.3fms. (Saved %.3fms)",
+			m_roundStager.GetSwapTime(), m_roundStager.GetWaitTime(), m_roundStager.GetStagingTime(), m_roundStager.GetStagingTime() - m_roundStager.GetWaitTime());
 
-	GenerateRound(data);
+		m_metrics.Set(Metric::kRoundGenerationTime, m_roundStager.GetSwapTime());
+	}
+	else
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		Round::RoundData data = GenerateRoundData(m_roundCount);
+		m_pCurrentRound = GenerateRound(data, m_mapGenerator, m_tilemap);
+
+		std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+		m_metrics.Set(Metric::kRoundGenerationTime, elapsed.count());
+	}
+
+	++m_roundCount;
+
+	// Every path is new, Repairs below only rescore what they change.
+	UpdatePlacementScores();
+
+	// The turrets stay where they were, So the new paths have to route around them too.
+	RebuildMazePlanner();
+	RefreshPathCoverage();
 
 	// Disable turrets that shouldn't be active anymore due to change in round.
 	for (auto pair : m_turrets)
@@ -87,17 +189,75 @@ void World::NextRound()
 		if (!IsTurretPlaceable(pair.second))
 			pair.second->Disable();
 	}
+
+	// Start working on the round after this one.
+	StageNextRound();
+}
+
+Round::RoundData World::GenerateRoundData(unsigned int roundIndex) const
+{
+	// Every round gets its own stream.
+	CounterRandom random(CounterRandom::Draw(m_worldSeed, RandomStream::kWorld, roundIndex), RandomStream::kRoundData);
+
+	// Generate random round information.
+	Round::RoundData data;
+	data.m_seed = random.Random<unsigned int>();
+	data.m_temperature = random.RandomRange(g_kMinTemperature, g_kMaxTemperature);
+	data.m_precipitation = random.RandomRange(g_kMinPrecipitation, g_kMaxPrecipitation);
+	data.m_difficulty = m_difficulty;
+
+	return data;
+}
+
+void World::StageNextRound()
+{
+	if (!m_isRoundStagingEnabled)
+		return;
+
+	// Round data only depends on the index, So staged rounds are identical to rounds generated on the spot.
+	Round::RoundData data = GenerateRoundData(m_roundCount);
+
+	m_roundStager.Stage(data, [this](const Round::RoundData& roundData, MapGenerator& mapGenerator, WaveGenerator& waveGenerator, TDTilemap& tilemap)
+	{
+		Round* pRound = GenerateRound(roundData, mapGenerator, tilemap);
+
+		// Also get the first wave out of the way. The default wave rules are stateless between waves so this matches the world's generator.
+		pRound->PrepareNextWave(&waveGenerator);
+
+		return pRound;
+	});
 }
 
 void World::GenerateWorld(unsigned int seed)
 {
+	// Staged round belongs to the previous world.
+	m_roundStager.Cancel();
+
 	// Allows for seed to be 0.
 	unsigned int worldSeed = dragon::SquirrelNoise::Get1DNoise(1, seed);
 
-	m_random.Seed(worldSeed);
+	m_worldSeed = worldSeed;
+	m_roundCount = 0;
+
+	// Turrets carry over between worlds, But the ticks they slept through belong to the previous one.
+	WakeAllTurrets();
+
+	m_tick = 0;
+	m_tickAccumulator = 0.0f;
+
+	// Every world starts a fresh journal, The seed and difficulty are all it takes to recreate it.
+	if (m_isJournalEnabled)
+		m_journal.Begin(seed, m_difficulty, g_kFixedTimeStep);
+	else
+		m_journal.Stop();
+
+	// Mazing carries over between worlds, But replays start out without it.
+	if (m_isMazingEnabled)
+		m_journal.RecordAction(PlayerAction(PlayerActionType::kToggleMazing, 0));
 
 	// Get the max depth for this Game's RoundGraph based on difficulty.
-	size_t difficultyDepth = g_kDepthOnDifficulty[(size_t)m_difficulty].GetRandom(m_random);
+	dragon::Random depthRandom(CounterRandom::Draw(worldSeed, RandomStream::kRoundGraph, 0));
+	size_t difficultyDepth = g_kDepthOnDifficulty[(size_t)m_difficulty].GetRandom(depthRandom);
 
 	// Resets the player 
 	Reset();
@@ -132,14 +292,46 @@ void World::Render(dragon::RenderTarget& target)
 
 void World::Update(float dt)
 {
+	PCG_PROFILE_ZONE("World::Update");
+
+	m_metrics.Set(Metric::kFrameTime, dt * 1000.0);
 
+	if (!m_isHeadless)
+	{
 #if _DEBUG
-	// Only necessary in debug mode.
-	UpdateInfoText();
+		// Only necessary in debug mode.
+		UpdateInfoText();
 #endif
 
-	UpdateGameText();
-	UpdateRoundText();
+		UpdateGameText();
+		UpdateRoundText();
+	}
+
+	// Catch up on the frame time in fixed steps.
+	m_tickAccumulator = eastl::min(m_tickAccumulator + dt, g_kMaxFrameTime);
+	while (m_tickAccumulator >= g_kFixedTimeStep)
+	{
+		m_tickAccumulator -= g_kFixedTimeStep;
+		Tick();
+	}
+
+	m_metrics.EndFrame();
+
+	if (m_isMetricsVisible)
+		UpdateMetricsText();
+}
+
+void World::Tick()
+{
+	PCG_PROFILE_ZONE("World::Tick");
+
+	// Before the tick starts, Just like the actions of a player. Its time isn't part of the tick time.
+	if (m_pBot)
+		m_pBot->Tick(*this);
+
+	auto tickStart = std::chrono::steady_clock::now();
+
+	const float dt = g_kFixedTimeStep;
 
 	// Update Round
 	if (m_pCurrentRound)
@@ -155,60 +347,167 @@ void World::Update(float dt)
 
 	UpdateTurrets(dt);
 	UpdateEnemies(dt);
+
+	m_enemyEvents.Flush();
+
+	if (m_journal.IsRecording())
+		m_journal.RecordStateHash(m_tick, ComputeStateHash());
+
+	std::chrono::duration<double, std::milli> tickTime = std::chrono::steady_clock::now() - tickStart;
+	m_metrics.Add(Metric::kTickTime, tickTime.count());
+	m_metrics.Add(Metric::kTicks, 1.0);
+	m_metrics.Set(Metric::kEnemies, (double)m_enemies.size());
+	m_metrics.Set(Metric::kTurrets, (double)m_turrets.size());
+
+	++m_tick;
 }
 
-void World::GenerateRound(const Round::RoundData& roundData)
+void World::ApplyAction(PlayerAction action)
 {
+	action.m_tick = m_tick;
+	m_journal.RecordAction(action);
+
+	size_t index = action.m_tileIndex;
+
+	switch (action.m_type)
+	{
+	case PlayerActionType::kBuyTurret:
+		BuyTurret(index);
+		break;
+	case PlayerActionType::kSellTurret:
+		SellTurret(index);
+		break;
+	case PlayerActionType::kUpgradeTurret:
+		UpgradeTurret(index);
+		break;
+	case PlayerActionType::kPickUpTurret:
+		PickUpTurret(index);
+		break;
+	case PlayerActionType::kPlaceTurret:
+		PlaceMovingTurret(index);
+		break;
+	case PlayerActionType::kTogglePause:
+		TogglePauseRound();
+		break;
+	case PlayerActionType::kGiveGold:
+		m_playerGold += 1000.0f;
+		break;
+	case PlayerActionType::kNextRound:
+		NextRound();
+		break;
+	case PlayerActionType::kKillEnemies:
+		ClearEnemies();
+		break;
+	case PlayerActionType::kToggleMazing:
+		ToggleMazing();
+		break;
+	case PlayerActionType::kCycleTargeting:
+		CycleTurretTargeting(index);
+		break;
+	}
+}
+
+Round* World::GenerateRound(const Round::RoundData& roundData, MapGenerator& mapGenerator, TDTilemap& tilemap)
+{
+	PCG_PROFILE_ZONE("World::GenerateRound");
+
 	dragon::Random roundRandom(roundData.m_seed);
 
-	m_mapGenerator.SetTemperature(roundData.m_temperature);
-	m_mapGenerator.SetPrecipitation(roundData.m_precipitation);
+	mapGenerator.SetTemperature(roundData.m_temperature);
+	mapGenerator.SetPrecipitation(roundData.m_precipitation);
 
-	m_pCurrentRound = new Round(roundData, this);
-	m_pCurrentRound->SetDifficulty(m_difficulty);
+	Round* pRound = new Round(roundData, this);
+	pRound->SetDifficulty(roundData.m_difficulty);
 
-	size_t spawnerCount = g_kSpawnerCountOnDifficulty[(size_t)m_difficulty].GetRandom(roundRandom);
+	size_t spawnerCount = g_kSpawnerCountOnDifficulty[(size_t)roundData.m_difficulty].GetRandom(roundRandom);
 	DLOG("Generating round with %u spawners.", spawnerCount);
 
 	// Generate the map.
-	MapGenerator::PossiblePositions positionsFound;
-	positionsFound.reserve(g_kMaxTries);
-
-	m_mapGenerator.Generate(m_tilemap, roundData.m_seed);
+	mapGenerator.Generate(tilemap, roundData.m_seed);
 
 	// Find a position to place the base at.
-	m_mapGenerator.FindBestBasePosition(m_tilemap, positionsFound);
-	assert(positionsFound.size() > 0);
+	dragon::Vector2 basePosition = mapGenerator.SelectBasePosition(tilemap);
+
+	MapGenerator::PossiblePositions spawnerPositions;
+	mapGenerator.SelectSpawnerLocations(tilemap, basePosition, spawnerCount, spawnerPositions);
+	assert(spawnerPositions.size() > 0);
 
-	size_t randomIndex = roundRandom.RandomIndex(positionsFound.size());
-	dragon::Vector2 basePosition = positionsFound[randomIndex];
+	for (dragon::Vector2 spawnerPos : spawnerPositions)
+	{
+		// Let the map generator carve a path to the base.
+		Path spawnerPath = mapGenerator.CarvePath(tilemap, spawnerPos, basePosition);
+
+		pRound->EmplaceSpawner(this, spawnerPos, eastl::move(spawnerPath));
+	}
 
-	// Clear positions found array.
-	positionsFound.clear();
+	mapGenerator.SetBaseTile(tilemap, basePosition);
+	pRound->SetBasePosition(basePosition);
 
-	m_mapGenerator.FindEnemySpawnerLocations(m_tilemap, basePosition, positionsFound);
-	assert(positionsFound.size() > 0);
+	return pRound;
+}
+
+uint64_t World::ComputeStateHash() const
+{
+	StateHasher hasher;
 
-	for (size_t i = 0; i < spawnerCount; ++i)
+	// Tilemap
+	const dragon::Vector2u kMapSize = m_tilemap.GetSize();
+	const size_t kTileCount = (size_t)kMapSize.x * (size_t)kMapSize.y;
+	for (size_t i = 0; i < kTileCount; ++i)
 	{
-		size_t randomIndex = roundRandom.RandomIndex(positionsFound.size());
-		dragon::Vector2 spawnerPos = positionsFound[randomIndex];
-		positionsFound.erase(positionsFound.begin() + randomIndex); // Remove so it can't be re-used.
+		const TDTileData& tileData = m_tilemap.GetTileDataAtIndex(i);
+
+		hasher.Add(m_tilemap.GetTileAtIndex(i));
+		hasher.Add(tileData.m_noise);
+		hasher.Add(tileData.m_temperature);
+		hasher.Add(tileData.m_moistureLevel);
+		hasher.Add(tileData.m_biome);
+		hasher.Add(tileData.m_isTurretPlaceable);
+	}
 
-		// Let the map generator carve a path to the base.
-		Path spawnerPath = m_mapGenerator.CarvePath(m_tilemap, spawnerPos, basePosition);
+	// Player
+	hasher.Add(m_playerGold);
+	hasher.Add(m_score);
+	hasher.Add(m_isMazingEnabled);
+
+	if (m_pCurrentRound)
+		m_pCurrentRound->Hash(hasher);
+
+	for (const Enemy* pEnemy : m_enemies)
+		pEnemy->Hash(hasher);
+
+	for (const Enemy* pEnemy : m_enemiesToAdd)
+		pEnemy->Hash(hasher);
 
-		m_pCurrentRound->EmplaceSpawner(this, spawnerPos, eastl::move(spawnerPath));
+	// Turrets are hashed in tile order, The iteration order of the map is not part of the state.
+	eastl::vector<size_t> turretTiles;
+	turretTiles.reserve(m_turrets.size());
+	for (const auto& pair : m_turrets)
+		turretTiles.emplace_back(pair.first);
+
+	eastl::sort(turretTiles.begin(), turretTiles.end());
+
+	for (size_t tileIndex : turretTiles)
+	{
+		hasher.Add(tileIndex);
+		m_turrets.find(tileIndex)->second->Hash(hasher, m_tick, g_kFixedTimeStep);
 	}
 
-	m_mapGenerator.SetBaseTile(m_tilemap, basePosition);
+	return hasher.GetHash();
 }
 
 bool World::IsTurretPlaceable(Turret* pTurret)
 {
 	dragon::Vector2 tilePosition = m_tilemap.WorldToMapCoordinates(pTurret->GetPosition());
-	auto tileData = m_tilemap.GetTileData(tilePosition.x, tilePosition.y);
-	return tileData.m_isTurretPlaceable;
+	return IsTileBuildable(m_tilemap.IndexFromPosition(tilePosition));
+}
+
+bool World::IsTileBuildable(size_t tileIndex) const
+{
+	if (m_tilemap.GetTileDataAtIndex(tileIndex).m_isTurretPlaceable)
+		return true;
+
+	return m_isMazingEnabled && MapGenerator::IsPathTile(m_tilemap.GetTileAtIndex(tileIndex));
 }
 
 bool World::TryPlaceTurret(size_t tileIndex, Turret* pTurret)
@@ -238,6 +537,12 @@ bool World::TryPlaceTurret(size_t tileIndex, Turret* pTurret)
 		// Clear the turret target so it can start looking for a new target.
 		pTurret->ClearTarget();
 
+		// New turrets start out awake, Moving turrets were woken up when they were picked up.
+		m_awakeTurrets.push_back({ (uint32_t)tileIndex, pTurret });
+		UpdateTurretCoverage(pTurret);
+
+		OnTurretTileChanged(tileIndex);
+
 		return true;
 	}
 	else
@@ -255,7 +560,7 @@ void World::BuyTurret(size_t index)
 		return;
 
 	// Buy a new turret and place under mouse cursor if possible.
-	if (m_tilemap.GetTileDataAtIndex(index).m_isTurretPlaceable)
+	if (IsTileBuildable(index))
 	{
 		if (TryPlaceTurret(index, GenerateTurret()))
 		{
@@ -274,8 +579,11 @@ void World::SellTurret(size_t index)
 		m_playerGold += pSellingTurret->GetResaleValue();
 
 		// Remove from turrets and delete the memory.
+		UnscheduleTurret(pSellingTurret);
 		delete pSellingTurret;
 		m_turrets.erase(result);
+
+		OnTurretTileChanged(index);
 	}
 }
 
@@ -288,6 +596,7 @@ void World::UpgradeTurret(size_t index)
 		{
 			m_playerGold -= cost;
 			result->second->Upgrade();
+			UpdateTurretCoverage(result->second);
 		}
 	}
 }
@@ -297,7 +606,7 @@ Turret* World::GenerateTurret()
 	Turret* pTurret = new Turret();
 
 	pTurret->SetDamage(10.0f);
-	pTurret->SetRange(100.0f);
+	pTurret->SetRange(g_kTurretRange);
 	pTurret->SetCooldown(1.f);
 
 	return pTurret;
@@ -305,48 +614,186 @@ Turret* World::GenerateTurret()
 
 void World::UpdateEnemies(float dt)
 {
+	PCG_PROFILE_ZONE("World::UpdateEnemies");
+
 	// Add enemies.
 	for (Enemy* pEnemy : m_enemiesToAdd)
 	{
+		// Sleeping turrets counted on no enemy being faster.
+		if (pEnemy->GetStats().m_speed > m_maxEnemySpeed)
+		{
+			m_maxEnemySpeed = pEnemy->GetStats().m_speed;
+			m_isTurretWakeUpPending = true;
+		}
+
 		m_enemies.emplace_back(pEnemy);
 	}
 	m_enemiesToAdd.clear();
 
-	// Update Enemies
-	for (Enemy* pEnemy : m_enemies)
+	// Update Enemies, Deleting the ones that died or reached the goal as we go.
+	// Swapped with the last enemy, Which still gets updated as it moves into this spot.
+	for (size_t i = 0; i < m_enemies.size();)
 	{
-		pEnemy->Update(dt);
+		Enemy* pEnemy = m_enemies[i];
+
+		EnemyEventType eventType;
+		if (pEnemy->GetHealth() <= 0.0f)
+		{
+			// Gold is handed out once the events are flushed. Based on the damage they would've done to the base.
+			eventType = EnemyEventType::kDied;
+		}
+		else
+		{
+			pEnemy->Update(dt);
+
+			if (!pEnemy->HasReachedGoal())
+			{
+				++i;
+				continue;
+			}
+
+			// The base takes the damage of every arrival once the events are flushed.
+			eventType = EnemyEventType::kReachedGoal;
+		}
+
+		m_enemyEvents.Push({ eventType, pEnemy->GetHandle(), pEnemy->GetPath(), pEnemy->GetStats().m_damage });
+		m_enemyRegistry.Unregister(pEnemy->GetHandle());
+		delete pEnemy;
+
+		m_enemies[i] = m_enemies.back();
+		m_enemies.pop_back();
+	}
+}
+
+void World::UpdateTurrets(float dt)
+{
+	PCG_PROFILE_ZONE("World::UpdateTurrets");
+
+	TargetingStats stats;
+
+	m_pathTracker.Update(m_enemies);
+	m_enemySnapshot.Build(m_enemies);
+
+	if (m_isTurretWakeUpPending)
+	{
+		m_isTurretWakeUpPending = false;
+		WakeAllTurrets();
 	}
 
-	// Delete enemies that have died.
-	for (auto it = m_enemies.begin(); it != m_enemies.end();)
+	// Wake the turrets that are due, Entries of turrets that were woken up early or left the board are outdated.
+	m_dueTurretTiles.clear();
+	m_turretWheel.Advance(m_tick, m_dueTurretTiles);
+
+	for (uint32_t tileIndex : m_dueTurretTiles)
 	{
-		Enemy* pEnemy = *it;
+		auto result = m_turrets.find(tileIndex);
+		if (result != m_turrets.end() && result->second->IsAsleep() && result->second->GetWakeTick() == m_tick)
+			WakeTurret(result->second);
+	}
 
-		bool isDead = pEnemy->GetHealth() <= 0.0f;
-		if (isDead)
+	const size_t kAwakeCount = m_awakeTurrets.size();
+
+	// Update and Find Turret Targets, Every turret only reads the snapshot so they are split over threads.
+	const unsigned int kMaxThreads = m_turretThreadCount > 0 ? m_turretThreadCount : std::thread::hardware_concurrency();
+	const size_t kThreadCount = eastl::max<size_t>(eastl::min<size_t>(kMaxThreads, kAwakeCount / g_kMinTurretsPerThread), 1);
+
+	// Kept between ticks, So ticks don't allocate once they warmed up.
+	m_threadShots.resize(eastl::max(m_threadShots.size(), kThreadCount));
+	m_threadStats.assign(kThreadCount, TargetingStats());
+
+	// Every thread aims a stretch of the awake turrets, The last one also takes the remainder.
+	const size_t kStride = kAwakeCount / kThreadCount;
+	auto aimStretch = [this, kStride, kAwakeCount, kThreadCount, dt](size_t i)
+	{
+		size_t last = i + 1 < kThreadCount ? (i + 1) * kStride : kAwakeCount;
+		AimTurrets(i * kStride, last, dt, m_threadShots[i], m_threadStats[i]);
+	};
+
+	if (kThreadCount == 1)
+	{
+		aimStretch(0);
+	}
+	else
+	{
+		if (m_turretPool.GetThreadCount() != kMaxThreads)
+			m_turretPool.Start(kMaxThreads);
+
+		// Only the stretch is captured, Keeps the task within the inline storage of the function.
+		for (size_t i = 0; i < kThreadCount; ++i)
+			m_turretPool.Submit([&aimStretch, i]() { aimStretch(i); });
+		m_turretPool.Wait();
+	}
+
+	// Deal the damage, Sorted on the turrets so the outcome doesn't depend on how they were split or the order they woke up in.
+	m_turretShots.clear();
+	for (size_t i = 0; i < kThreadCount; ++i)
+	{
+		m_turretShots.insert(m_turretShots.end(), m_threadShots[i].begin(), m_threadShots[i].end());
+		stats.m_scans += m_threadStats[i].m_scans;
+		stats.m_distanceTests += m_threadStats[i].m_distanceTests;
+	}
+
+	eastl::sort(m_turretShots.begin(), m_turretShots.end(), [](const TurretShot& left, const TurretShot& right)
+	{
+		return left.m_turret < right.m_turret;
+	});
+
+	for (const TurretShot& shot : m_turretShots)
+		m_enemies[shot.m_enemy]->Damage(shot.m_damage);
+
+	// Put the turrets that have nothing to do for a while to sleep.
+	for (size_t i = 0; i < m_awakeTurrets.size();)
+	{
+		AwakeTurret awakeTurret = m_awakeTurrets[i];
+		Turret* pTurret = awakeTurret.m_pTurret;
+
+		uint32_t sleepTicks = GetTurretSleepTicks(pTurret, dt);
+		if (sleepTicks == 0)
 		{
-			// Increase player gold. Based on the damage they would've done to the base.
-			m_playerGold += pEnemy->GetStats().m_damage;
+			++i;
+			continue;
+		}
 
-			delete pEnemy;
-			it = m_enemies.erase(it);
+		if (sleepTicks == eastl::numeric_limits<uint32_t>::max())
+		{
+			pTurret->Sleep(m_tick, m_tick);
 		}
 		else
 		{
-			++it;
+			uint32_t wakeTick = m_tick + 1 + sleepTicks;
+			pTurret->Sleep(m_tick, wakeTick);
+			m_turretWheel.Schedule(awakeTurret.m_tileIndex, wakeTick);
 		}
 
+		// Swap and pop, The turret swapped in hasn't been checked yet.
+		m_awakeTurrets[i] = m_awakeTurrets.back();
+		m_awakeTurrets.pop_back();
 	}
+
+	m_metrics.Set(Metric::kAwakeTurrets, (double)kAwakeCount);
+	m_metrics.Set(Metric::kSleepingTurrets, (double)(m_turrets.size() - kAwakeCount));
+
+	m_metrics.Add(Metric::kTargetScans, (double)stats.m_scans);
+	m_metrics.Add(Metric::kDistanceTests, (double)stats.m_distanceTests);
 }
 
-void World::UpdateTurrets(float dt)
+void World::AimTurrets(size_t first, size_t last, float dt, eastl::vector<TurretShot>& shots, TargetingStats& stats)
 {
-	// Find Turret Targets and Update
-	for (auto& pair : m_turrets)
+	PCG_PROFILE_ZONE("World::AimTurrets");
+
+	shots.clear();
+
+	for (size_t i = first; i < last; ++i)
 	{
-		pair.second->Update(dt);
-		pair.second->FindTarget(m_enemies);
+		const AwakeTurret& awakeTurret = m_awakeTurrets[i];
+
+		TurretShot shot;
+		shot.m_turret = awakeTurret.m_tileIndex;
+
+		if (awakeTurret.m_pTurret->Update(dt, m_enemySnapshot, shot))
+			shots.push_back(shot);
+
+		awakeTurret.m_pTurret->FindTarget(m_pathTracker, m_enemySnapshot, dt, &stats);
 	}
 }
 
@@ -365,7 +812,7 @@ void World::DrawTurretsAndCursor(dragon::RenderTarget& target)
 	// Draw Turrets
 	for (auto& pair : m_turrets)
 	{
-		pair.second->Render(target);
+		pair.second->Render(target, m_enemyRegistry);
 
 		dragon::Vector2 turretTilePosition = m_tilemap.WorldToMapCoordinates(pair.second->GetPosition());
 
@@ -386,7 +833,7 @@ void World::DrawTurretsAndCursor(dragon::RenderTarget& target)
 	// Draw currently dragged turret
 	if (m_pMovingTurret)
 	{
-		m_pMovingTurret->Render(target);
+		m_pMovingTurret->Render(target, m_enemyRegistry);
 
 		// Draw square if the player could place this turret or not.
 		if (IsTurretPlaceable(m_pMovingTurret))
@@ -402,9 +849,37 @@ void World::DrawTurretsAndCursor(dragon::RenderTarget& target)
 	{
 		// Only draw if we're not dragging a turret around.
 		DrawPlacementSquare(target, mouseTilePosition, g_kMouseTileColor);
+		DrawPlacementHint(target, mouseTilePosition);
 	}
 }
 
+void World::DrawPlacementHint(dragon::RenderTarget& target, dragon::Vector2 tilePos)
+{
+	if (!m_tilemap.WithinBounds(tilePos))
+		return;
+
+	size_t tileIndex = m_tilemap.IndexFromPosition(tilePos);
+	uint32_t score = m_placementScorer.GetScore(tileIndex);
+	if (score == 0 || m_turrets.find(tileIndex) != m_turrets.end())
+		return;
+
+	// Greener the closer it is to the best tile on the map.
+	float t = (float)score / (float)eastl::max(1u, m_placementScorer.GetMaxScore());
+	dragon::Color color = dragon::Color(
+		g_kMouseTileColor.r + (g_kTurretPlaceableColor.r - g_kMouseTileColor.r) * t,
+		g_kMouseTileColor.g + (g_kTurretPlaceableColor.g - g_kMouseTileColor.g) * t,
+		g_kMouseTileColor.b + (g_kTurretPlaceableColor.b - g_kMouseTileColor.b) * t);
+	DrawPlacementSquare(target, tilePos, color);
+
+	m_turretInfoText.setString("Covers " + std::to_string(score) + " path tiles\nBest : " + std::to_string(m_placementScorer.GetMaxScore()));
+
+	auto bounds = m_turretInfoText.getLocalBounds();
+	m_turretInfoText.setOrigin(bounds.width / 2.0f, bounds.height / 2.0f);
+
+	sf::RenderTarget* pSfTarget = target.GetNativeTarget<sf::RenderTarget*>();
+	pSfTarget->draw(m_turretInfoText);
+}
+
 void World::DrawTurretInformation(dragon::RenderTarget& target, Turret* pTurret)
 {
 	// Draw Range of turret.
@@ -417,7 +892,8 @@ void World::DrawTurretInformation(dragon::RenderTarget& target, Turret* pTurret)
 	(
 		"Upgrade Level : " + std::to_string(pTurret->GetUpgradeLevel()) +
 		"\nUpgrade Cost : " + std::to_string((unsigned int)pTurret->GetUpgradeCost()) +
-		"\nResale Value : " + std::to_string((unsigned int)pTurret->GetResaleValue())
+		"\nResale Value : " + std::to_string((unsigned int)pTurret->GetResaleValue()) +
+		"\nTargeting : " + GetTargetingModeName(pTurret->GetTargetingMode())
 	);
 
 	auto bounds = m_turretInfoText.getLocalBounds();
@@ -489,10 +965,27 @@ void World::InitializeUserInterface()
 	applyStyle(m_turretInfoText);
 	m_turretInfoText.setPosition(kGameSize / 2.0f, (kGameSize / 2.0f) - (g_kTextSize * turretInfoLines));
 	m_turretInfoText.setFillColor(sf::Color::Yellow);
+
+	// Performance Overlay, Left Top of Screen
+	applyStyle(m_metricsText);
+	m_metricsText.setCharacterSize((unsigned int)(g_kTextSize * 0.75f));
+	m_metricsText.setPosition(g_kTileSize / 2.0f, g_kTextSize * 3.0f);
+}
+
+bool World::SaveSnapshot(const char* pPath) const
+{
+	return WorldSnapshot::Save(*this, pPath);
+}
+
+bool World::LoadSnapshot(const char* pPath)
+{
+	return WorldSnapshot::Load(*this, pPath);
 }
 
 void World::UpdateInfoText()
 {
+	PCG_PROFILE_ZONE("World::UpdateInfoText");
+
 #if _DEBUG
 	dragon::Vector2 mouseTilePosition = m_tilemap.WorldToMapCoordinates(m_lastMousePosition);
 	size_t tileIndex = m_tilemap.IndexFromPosition(mouseTilePosition);
@@ -503,8 +996,18 @@ void World::UpdateInfoText()
 		"Turret at mouse cursor:\n\n"
 		"B - Buy Turret " + std::to_string(g_kTurretCost) + " Gold.\n"
 		"S - Sell Turret\n"
-		"U - Upgrade Turret\n\n"
-		"Click & Drag turret to move around the map."
+		"U - Upgrade Turret\n"
+		"F - Cycle Turret Targeting\n\n"
+		"Click & Drag turret to move around the map.\n"
+		"J - Save Replay\n"
+		"H - Performance Overlay\n"
+		"O - Save Snapshot\n"
+		"L - Load Snapshot\n"
+		"M - Toggle Mazing (Build on paths)\n"
+		"A - Toggle Auto Player\n"
+#if PCG_PROFILING
+		"T - Save Profiling Trace\n"
+#endif
 		"\nCheats:\n"
 		"G - Give Gold (1000)\n"
 		"N - Next Round\n"
@@ -516,7 +1019,8 @@ void World::UpdateInfoText()
 		"Tile Index: " + std::to_string(tileIndex) + "\n"
 		"Tile Data:\n - Noise: " + std::to_string(tileData.m_noise) +
 		"\n - Temperature: " + std::to_string(tileData.m_temperature) +
-		"\n - Moisture: " + std::to_string(tileData.m_moistureLevel)
+		"\n - Moisture: " + std::to_string(tileData.m_moistureLevel) +
+		"\n - Biome: " + std::to_string((unsigned int)tileData.m_biome)
 #endif
 		; // DYLAN: This is really weird syntax, I'll never do this again...
 
@@ -525,6 +1029,8 @@ void World::UpdateInfoText()
 
 void World::UpdateGameText()
 {
+	PCG_PROFILE_ZONE("World::UpdateGameText");
+
 	std::string text =
 		"Gold: " + std::to_string((unsigned int)m_playerGold) + "\n"
 		"Score: " + std::to_string((unsigned int)m_score) + "\n";
@@ -536,9 +1042,12 @@ void World::UpdateGameText()
 
 void World::UpdateRoundText()
 {
+	PCG_PROFILE_ZONE("World::UpdateRoundText");
+
 	if (m_pCurrentRound)
 	{
-		std::string text = std::to_string((int)m_pCurrentRound->GetWaveTime());
+		std::string text = std::to_string((int)m_pCurrentRound->GetWaveTime()) + " (" + std::to_string(m_pCurrentRound->GetLiveEnemyCount()) + " left)"
+			+ "  Base : " + std::to_string((int)m_pCurrentRound->GetBaseHealth());
 		
 		m_roundText.setString(text);
 		auto bounds = m_roundText.getLocalBounds();
@@ -555,6 +1064,70 @@ void World::DrawUserInterface(dragon::RenderTarget& target)
 
 	if (m_pCurrentRound->IsPaused())
 		pSfTarget->draw(m_pauseText);
+
+	if (m_isMetricsVisible)
+		DrawMetrics(target);
+}
+
+void World::UpdateMetricsText()
+{
+	PCG_PROFILE_ZONE("World::UpdateMetricsText");
+
+	// Per tick averages, A frame can simulate zero or several ticks.
+	const double kTicks = eastl::max(1.0, m_metrics.Get(Metric::kTicks));
+
+	char text[512];
+	std::snprintf(text, sizeof(text),
+		"Frame p50/p95/p99: %.2f / %.2f / %.2f ms\n"
+		"Tick: %.3f ms (%d this frame)\n"
+		"Enemies: %d  Turrets: %d\n"
+		"Turrets awake/sleeping: %d / %d\n"
+		"Target scans/tick: %.1f\n"
+		"Distance tests/tick: %.1f\n"
+		"Allocations/frame: %d\n"
+		"Last round generation: %.2f ms",
+		m_metrics.GetFrameTimePercentile(50.0f), m_metrics.GetFrameTimePercentile(95.0f), m_metrics.GetFrameTimePercentile(99.0f),
+		m_metrics.Get(Metric::kTickTime) / kTicks, (int)m_metrics.Get(Metric::kTicks),
+		(int)m_metrics.Get(Metric::kEnemies), (int)m_metrics.Get(Metric::kTurrets),
+		(int)m_metrics.Get(Metric::kAwakeTurrets), (int)m_metrics.Get(Metric::kSleepingTurrets),
+		m_metrics.Get(Metric::kTargetScans) / kTicks,
+		m_metrics.Get(Metric::kDistanceTests) / kTicks,
+		(int)m_metrics.Get(Metric::kAllocations),
+		m_metrics.Get(Metric::kRoundGenerationTime));
+
+	m_metricsText.setString(text);
+}
+
+void World::DrawMetrics(dragon::RenderTarget& target)
+{
+	static constexpr float kBarScale = 2.0f; // Pixels per millisecond.
+	static constexpr float kMaxBarHeight = 100.0f;
+
+	sf::RenderTarget* pSfTarget = target.GetNativeTarget<sf::RenderTarget*>();
+	pSfTarget->draw(m_metricsText);
+
+	// Frame time histogram underneath the text, Oldest frame on the left.
+	const MetricsRegistry::FrameTimes& frameTimes = m_metrics.GetFrameTimes();
+	const uint64_t kFrameCount = m_metrics.GetFrameCount();
+	const size_t kBars = (size_t)eastl::min<uint64_t>(kFrameCount, MetricsRegistry::kHistorySize);
+
+	auto bounds = m_metricsText.getGlobalBounds();
+	const float kBottom = bounds.top + bounds.height + g_kTextSize / 2.0f + kMaxBarHeight;
+
+	sf::Vertex vertices[MetricsRegistry::kHistorySize * 2];
+	for (size_t i = 0; i < kBars; ++i)
+	{
+		float frameTime = frameTimes[(kFrameCount - kBars + i) % MetricsRegistry::kHistorySize];
+
+		sf::Color color = frameTime <= 1000.0f / 60.0f ? sf::Color::Green : (frameTime <= 1000.0f / 30.0f ? sf::Color::Yellow : sf::Color::Red);
+		float x = bounds.left + (float)i;
+		float height = eastl::min(frameTime * kBarScale, kMaxBarHeight);
+
+		vertices[i * 2] = sf::Vertex(sf::Vector2f(x, kBottom), color);
+		vertices[i * 2 + 1] = sf::Vertex(sf::Vector2f(x, kBottom - height), color);
+	}
+
+	pSfTarget->draw(vertices, kBars * 2, sf::Lines);
 }
 
 void World::HandleMousePress(dragon::MouseButtonPressed& ev)
@@ -563,22 +1136,38 @@ void World::HandleMousePress(dragon::MouseButtonPressed& ev)
 	dragon::Vector2 tilePosition = m_tilemap.WorldToMapCoordinates(m_lastMousePosition);
 	size_t index = m_tilemap.IndexFromPosition(tilePosition);
 
+	if (m_turrets.find(index) != m_turrets.end())
+		ApplyAction(PlayerAction(PlayerActionType::kPickUpTurret, (uint32_t)index));
+}
+
+void World::HandleMouseRelease(dragon::MouseButtonReleased& ev)
+{
+	if (m_pMovingTurret)
+	{
+		dragon::Vector2 tilePosition = m_tilemap.WorldToMapCoordinates(m_lastMousePosition);
+		size_t index = m_tilemap.IndexFromPosition(tilePosition);
+
+		ApplyAction(PlayerAction(PlayerActionType::kPlaceTurret, (uint32_t)index));
+	}
+}
+
+void World::PickUpTurret(size_t index)
+{
 	if (auto result = m_turrets.find(index); result != m_turrets.end())
 	{
 		m_pMovingTurret = result->second;
 		// Remove from the list. This stops it from shooting and other things that a placed turret would do.
+		UnscheduleTurret(m_pMovingTurret);
 		m_turrets.erase(result);
-	}
 
+		OnTurretTileChanged(index);
+	}
 }
 
-void World::HandleMouseRelease(dragon::MouseButtonReleased& ev)
+void World::PlaceMovingTurret(size_t index)
 {
 	if (m_pMovingTurret)
 	{
-		dragon::Vector2 tilePosition = m_tilemap.WorldToMapCoordinates(m_lastMousePosition);
-		size_t index = m_tilemap.IndexFromPosition(tilePosition);
-
 		TryPlaceTurret(index, m_pMovingTurret);
 		m_pMovingTurret = nullptr;
 	}
@@ -602,32 +1191,88 @@ void World::HandleKeyRelease(dragon::KeyReleased& ev)
 	dragon::Vector2 tilePosition = m_tilemap.WorldToMapCoordinates(m_lastMousePosition);
 	size_t index = m_tilemap.IndexFromPosition(tilePosition);
 
+	// Everything that changes the simulation goes through ApplyAction so it ends up in the journal.
 	if (ev.m_keyCode == dragon::Key::B)
 	{
-		BuyTurret(index);
+		ApplyAction(PlayerAction(PlayerActionType::kBuyTurret, (uint32_t)index));
 	}
 	else if (ev.m_keyCode == dragon::Key::S)
 	{
-		SellTurret(index);
+		ApplyAction(PlayerAction(PlayerActionType::kSellTurret, (uint32_t)index));
 	}
 	else if (ev.m_keyCode == dragon::Key::U)
 	{
-		UpgradeTurret(index);
+		ApplyAction(PlayerAction(PlayerActionType::kUpgradeTurret, (uint32_t)index));
+	}
+	else if (ev.m_keyCode == dragon::Key::M)
+	{
+		ApplyAction(PlayerAction(PlayerActionType::kToggleMazing, (uint32_t)index));
+	}
+	else if (ev.m_keyCode == dragon::Key::F)
+	{
+		ApplyAction(PlayerAction(PlayerActionType::kCycleTargeting, (uint32_t)index));
 	}
 
 	if (ev.m_keyCode == dragon::Key::Enter)
 	{
-		TogglePauseRound();
+		ApplyAction(PlayerAction(PlayerActionType::kTogglePause, (uint32_t)index));
+	}
+
+	if (ev.m_keyCode == dragon::Key::J)
+	{
+		if (SaveJournal("replay.pcgr"))
+			std::cout << "Saved replay of " << m_tick << " ticks to replay.pcgr" << std::endl;
+	}
+
+#if PCG_PROFILING
+	if (ev.m_keyCode == dragon::Key::T)
+	{
+		if (Profiler::WriteChromeTrace("trace.json"))
+			std::cout << "Saved profiling trace to trace.json" << std::endl;
+	}
+#endif
+
+	// Not an action, The journal records the actions of the bot instead.
+	if (ev.m_keyCode == dragon::Key::A)
+	{
+		if (HasBot())
+			SetBot(nullptr);
+		else
+			SetBot(eastl::unique_ptr<PlayerBot>(new GreedyBot()));
+
+		std::cout << (HasBot() ? "Auto player enabled" : "Auto player disabled") << std::endl;
+	}
+
+	if (ev.m_keyCode == dragon::Key::H)
+	{
+		m_isMetricsVisible = !m_isMetricsVisible;
+
+		if (m_isMetricsVisible)
+			UpdateMetricsText();
+	}
+
+	if (ev.m_keyCode == dragon::Key::O)
+	{
+		if (SaveSnapshot("snapshot.pcgs"))
+			std::cout << "Saved snapshot at tick " << m_tick << " to snapshot.pcgs" << std::endl;
+	}
+
+	if (ev.m_keyCode == dragon::Key::L)
+	{
+		if (LoadSnapshot("snapshot.pcgs"))
+			std::cout << "Loaded snapshot at tick " << m_tick << " from snapshot.pcgs" << std::endl;
+		else
+			std::cout << "Failed to load snapshot.pcgs" << std::endl;
 	}
 
 	// Cheats
 	if (ev.m_keyCode == dragon::Key::G)
 	{
-		m_playerGold += 1000.0f;
+		ApplyAction(PlayerAction(PlayerActionType::kGiveGold, (uint32_t)index));
 	}
 	else if(ev.m_keyCode == dragon::Key::N)
 	{
-		NextRound();
+		ApplyAction(PlayerAction(PlayerActionType::kNextRound, (uint32_t)index));
 	}
 	else if (ev.m_keyCode == dragon::Key::W)
 	{
@@ -643,7 +1288,7 @@ void World::HandleKeyRelease(dragon::KeyReleased& ev)
 	}
 	else if (ev.m_keyCode == dragon::Key::K)
 	{
-		ClearEnemies();
+		ApplyAction(PlayerAction(PlayerActionType::kKillEnemies, (uint32_t)index));
 	}
 }
 
@@ -661,11 +1306,19 @@ void World::TogglePauseRound()
 void World::ClearEnemies()
 {
 	for (Enemy* pEnemy : m_enemiesToAdd)
+	{
+		m_enemyEvents.Push({ EnemyEventType::kDespawned, pEnemy->GetHandle(), pEnemy->GetPath(), 0.0f });
+		m_enemyRegistry.Unregister(pEnemy->GetHandle());
 		delete pEnemy;
+	}
 	m_enemiesToAdd.clear();
 
 	for (Enemy* pEnemy : m_enemies)
+	{
+		m_enemyEvents.Push({ EnemyEventType::kDespawned, pEnemy->GetHandle(), pEnemy->GetPath(), 0.0f });
+		m_enemyRegistry.Unregister(pEnemy->GetHandle());
 		delete pEnemy;
+	}
 	m_enemies.clear();
 
 	for (auto pair : m_turrets)
@@ -673,3 +1326,255 @@ void World::ClearEnemies()
 		pair.second->ClearTarget();
 	}
 }
+
+void World::ToggleMazing()
+{
+	m_isMazingEnabled = !m_isMazingEnabled;
+
+	RebuildMazePlanner();
+
+	// Path tiles became buildable, Or stopped being so.
+	UpdatePlacementScores();
+}
+
+void World::RebuildMazePlanner()
+{
+	PCG_PROFILE_ZONE("World::RebuildMazePlanner");
+
+	if (!m_isMazingEnabled || !m_pCurrentRound || m_pCurrentRound->GetSpawners().empty())
+	{
+		m_mazePlanner.Clear();
+		return;
+	}
+
+	// Cleared paths go back to the terrain of the current round.
+	const Round::RoundData& data = m_pCurrentRound->GetRoundData();
+	m_mapGenerator.SetTemperature(data.m_temperature);
+	m_mapGenerator.SetPrecipitation(data.m_precipitation);
+	m_mapGenerator.Seed(data.m_seed);
+
+	eastl::vector<int> starts;
+	for (const Spawner& spawner : m_pCurrentRound->GetSpawners())
+		starts.emplace_back(m_tilemap.IndexFromPosition(spawner.GetPosition()));
+
+	m_mazePlanner.Init(m_tilemap, m_tilemap.IndexFromPosition(m_pCurrentRound->GetBasePosition()), starts);
+
+	for (const auto& pair : m_turrets)
+		m_mazePlanner.SetExtraCost((int)pair.first, g_kMazingTurretCost);
+
+	RepairSpawnerPaths();
+}
+
+void World::OnTurretTileChanged(size_t tileIndex)
+{
+	if (!m_mazePlanner.IsInitialized())
+		return;
+
+	bool hasTurret = m_turrets.find(tileIndex) != m_turrets.end();
+	m_mazePlanner.SetExtraCost((int)tileIndex, hasTurret ? g_kMazingTurretCost : 0.0f);
+
+	RepairSpawnerPaths();
+}
+
+void World::RepairSpawnerPaths()
+{
+	PCG_PROFILE_ZONE("World::RepairSpawnerPaths");
+
+	m_mazePlanner.ComputePaths();
+
+	Round::Spawners& spawners = m_pCurrentRound->GetSpawners();
+
+	TileRect dirty;
+	bool hasChanged = false;
+
+	for (Spawner& spawner : spawners)
+	{
+		Path path = m_mazePlanner.GetPath(m_tilemap.IndexFromPosition(spawner.GetPosition()));
+
+		// Keep the old path if the spawner is walled in, Enemies will walk through the turrets rather than stand still.
+		if (path.size() < 2 || IsSamePath(path, spawner.GetPath()))
+			continue;
+
+		m_placementScorer.RemovePath(m_tilemap, spawner.GetPath());
+		m_mapGenerator.ClearPath(m_tilemap, spawner.GetPath(), dirty);
+		spawner.EmplacePath(eastl::move(path));
+		m_placementScorer.AddPath(m_tilemap, spawner.GetPath());
+		hasChanged = true;
+
+		// Enemies point at the spawner's path, Only their place along it is outdated.
+		for (Enemy* pEnemy : m_enemies)
+		{
+			if (pEnemy->GetPath() == &spawner.GetPath())
+				pEnemy->RejoinPath();
+		}
+
+		for (Enemy* pEnemy : m_enemiesToAdd)
+		{
+			if (pEnemy->GetPath() == &spawner.GetPath())
+				pEnemy->RejoinPath();
+		}
+	}
+
+	// Clearing a path also cleared the tiles it shared with the other paths.
+	if (hasChanged)
+	{
+		for (const Spawner& spawner : spawners)
+			m_mapGenerator.StampPath(m_tilemap, spawner.GetPath(), dirty);
+
+		RefreshPathCoverage();
+		UpdatePlacementScores(dirty);
+	}
+
+	DLOG("Repaired spawner paths, Expanded %zu tiles.", m_mazePlanner.GetExpansions());
+}
+
+void World::RefreshPathCoverage()
+{
+	PCG_PROFILE_ZONE("World::RefreshPathCoverage");
+
+	m_pathTracker.Clear();
+
+	if (m_pCurrentRound)
+	{
+		for (const Spawner& spawner : m_pCurrentRound->GetSpawners())
+			m_pathTracker.AddPath(spawner.GetPath());
+	}
+
+	for (auto& pair : m_turrets)
+		UpdateTurretCoverage(pair.second);
+
+	// Enemies might have rejoined a path further along, And the paths themselves changed.
+	m_maxEnemySpeed = 0.0f;
+	for (const Enemy* pEnemy : m_enemies)
+		m_maxEnemySpeed = eastl::max(m_maxEnemySpeed, pEnemy->GetStats().m_speed);
+
+	WakeAllTurrets();
+}
+
+void World::UpdatePlacementScores()
+{
+	PCG_PROFILE_ZONE("World::UpdatePlacementScores");
+
+	m_placementScorer.Init(m_tilemap.GetSize(), g_kTurretRange);
+	m_placementScorer.Reset();
+
+	if (m_pCurrentRound)
+	{
+		for (const Spawner& spawner : m_pCurrentRound->GetSpawners())
+			m_placementScorer.AddPath(m_tilemap, spawner.GetPath());
+	}
+
+	UpdatePlacementScores(TileRect::FromSize(m_tilemap.GetSize()));
+}
+
+void World::UpdatePlacementScores(const TileRect& changedTiles)
+{
+	PCG_PROFILE_ZONE("World::UpdatePlacementScores");
+
+	// Tiles only become buildable or stop being so when their tile changes, Or mazing is toggled.
+	const TileRect kTiles = changedTiles.Clipped(m_tilemap.GetSize());
+	for (int y = kTiles.m_top; y < kTiles.m_bottom; ++y)
+	{
+		for (int x = kTiles.m_left; x < kTiles.m_right; ++x)
+		{
+			size_t tileIndex = m_tilemap.IndexFromPosition(dragon::Vector2(x, y));
+			m_placementScorer.SetBuildable(tileIndex, IsTileBuildable(tileIndex));
+		}
+	}
+
+	m_placementScorer.Update();
+}
+
+void World::UpdateTurretCoverage(Turret* pTurret)
+{
+	PathCoverage coverage;
+	m_pathTracker.ComputeCoverage(pTurret->GetPosition(), pTurret->GetRange(), coverage);
+	pTurret->SetCoverage(eastl::move(coverage));
+
+	// Enemies it was waiting for might be covered already.
+	WakeTurret(pTurret);
+}
+
+void World::CycleTurretTargeting(size_t index)
+{
+	if (auto result = m_turrets.find(index); result != m_turrets.end())
+	{
+		uint32_t mode = ((uint32_t)result->second->GetTargetingMode() + 1) % (uint32_t)TargetingMode::kCount;
+		result->second->SetTargetingMode((TargetingMode)mode);
+		WakeTurret(result->second);
+	}
+}
+
+void World::WakeTurret(Turret* pTurret)
+{
+	if (!pTurret->IsAsleep())
+		return;
+
+	pTurret->Wake(m_tick, g_kFixedTimeStep);
+
+	dragon::Vector2 tilePosition = m_tilemap.WorldToMapCoordinates(pTurret->GetPosition());
+	m_awakeTurrets.push_back({ (uint32_t)m_tilemap.IndexFromPosition(tilePosition), pTurret });
+}
+
+void World::WakeAllTurrets()
+{
+	m_turretWheel.Reset(m_tick);
+	m_awakeTurrets.clear();
+
+	for (auto& pair : m_turrets)
+	{
+		if (pair.second->IsAsleep())
+			pair.second->Wake(m_tick, g_kFixedTimeStep);
+
+		m_awakeTurrets.push_back({ (uint32_t)pair.first, pair.second });
+	}
+}
+
+void World::UnscheduleTurret(Turret* pTurret)
+{
+	// Sleeping turrets are only in the wheel, Their entry is ignored once the turret is gone.
+	if (pTurret->IsAsleep())
+	{
+		pTurret->Wake(m_tick, g_kFixedTimeStep);
+		return;
+	}
+
+	for (size_t i = 0; i < m_awakeTurrets.size(); ++i)
+	{
+		if (m_awakeTurrets[i].m_pTurret == pTurret)
+		{
+			m_awakeTurrets.erase(m_awakeTurrets.begin() + i);
+			break;
+		}
+	}
+}
+
+uint32_t World::GetTurretSleepTicks(const Turret* pTurret, float dt) const
+{
+	// Enemies move a bit further than their speed when they snap onto the next point of their path.
+	static constexpr float kStepSlack = 2.0f;
+	static constexpr uint32_t kForever = eastl::numeric_limits<uint32_t>::max();
+
+	// Turrets are only enabled as they are placed or a round starts, Both wake them up.
+	if (!pTurret->IsActive())
+		return kForever;
+
+	uint32_t cooldownTicks = pTurret->GetCooldownTicks(dt);
+	if (pTurret->HasTarget())
+		return cooldownTicks;
+
+	float distance = m_pathTracker.GetDistanceToCoverage(pTurret->GetCoverage());
+	if (distance == 0.0f)
+		return 0;
+
+	// Covers no path at all.
+	if (distance == eastl::numeric_limits<float>::infinity())
+		return kForever;
+
+	// Awake on the tick the closest enemy could reach the coverage.
+	float steps = distance / (m_maxEnemySpeed * dt + kStepSlack);
+	uint32_t enemyTicks = steps >= (float)TimingWheel::kMaxDelay ? TimingWheel::kMaxDelay : (uint32_t)steps;
+	enemyTicks = enemyTicks > 1 ? enemyTicks - 1 : 0;
+
+	return eastl::max(cooldownTicks, enemyTicks);
+}
@@ -4,16 +4,35 @@
 #include <Game/Generators/MapGenerator.h>
 
 #include <Game/Rounds/Round.h>
+#include <Game/Rounds/RoundStager.h>
+
+#include <Game/TowerDefense/MazePlanner.h>
+#include <Game/TowerDefense/PathTracker.h>
+#include <Game/TowerDefense/PlacementScorer.h>
+#include <Game/TowerDefense/TimingWheel.h>
+#include <Game/TowerDefense/EnemyRegistry.h>
+#include <Game/TowerDefense/EnemyEvents.h>
+#include <Game/TowerDefense/EnemySnapshot.h>
+#include <Game/TowerDefense/Turret.h>
 
 #include <Game/GameDifficulty.h>
+#include <Game/Generators/CounterRandom.h>
+#include <Game/Replay/InputJournal.h>
+#include <Game/Bots/PlayerBot.h>
+
+#include <Utility/Metrics.h>
+#include <Utility/WorkStealingPool.h>
 
 #include <EASTL/vector.h>
 #include <EASTL/array.h>
 #include <EASTL/unordered_map.h>
+#include <EASTL/unique_ptr.h>
 
 #include <SFML/Graphics/Font.hpp>
 #include <SFML/Graphics/Text.hpp>
 
+#include <cstdint>
+
 namespace dragon
 {
 	class RenderTarget;
@@ -27,6 +46,8 @@ namespace dragon
 
 class World
 {
+	friend class WorldSnapshot;
+
 	//
 	// Generators
 	//
@@ -42,13 +63,137 @@ class World
 	/// </summary>
 	WaveGenerator* m_pDefaultWaveGenerator;
 
+	/// <summary>
+	/// Generates the next round in the background whilst the current round is being played.
+	/// </summary>
+	RoundStager m_roundStager;
+
 	// Game State
 	TDTilemap m_tilemap;
 
 	/// <summary>
-	/// World Random, Seeded by GenerateWorld and Init
+	/// Picks the seeds of new worlds, Seeded by Init.
+	/// </summary>
+	CounterRandom m_random;
+
+	/// <summary>
+	/// Seed of the current world, Every round draws its data from its own index in this seed's stream.
+	/// </summary>
+	unsigned int m_worldSeed;
+
+	/// <summary>
+	/// Amount of rounds generated in the current world.
+	/// </summary>
+	unsigned int m_roundCount;
+
+	/// <summary>
+	/// Headless worlds don't load or update anything that is only needed for rendering.
+	/// </summary>
+	bool m_isHeadless;
+
+	/// <summary>
+	/// Amount of fixed steps simulated since the world was generated.
+	/// </summary>
+	uint32_t m_tick;
+
+	/// <summary>
+	/// Frame time that has not been simulated yet.
+	/// </summary>
+	float m_tickAccumulator;
+
+	/// <summary>
+	/// Records the player actions and state hashes of the current game.
+	/// </summary>
+	InputJournal m_journal;
+
+	/// <summary>
+	/// Wether a journal is recorded when a world is generated.
+	/// </summary>
+	bool m_isJournalEnabled;
+
+	/// <summary>
+	/// Wether the next round is generated in the background. (See RoundStager)
+	/// </summary>
+	bool m_isRoundStagingEnabled;
+
+	/// <summary>
+	/// Wether turrets can be built on paths, The spawner paths then route around the turrets. (See MazePlanner)
+	/// </summary>
+	bool m_isMazingEnabled;
+
+	/// <summary>
+	/// Keeps the spawner paths of the current round up to date whilst mazing is enabled.
+	/// </summary>
+	MazePlanner m_mazePlanner;
+
+	/// <summary>
+	/// Enemies sorted along the spawner paths of the current round, Turrets only search the stretches they cover.
+	/// </summary>
+	PathTracker m_pathTracker;
+
+	/// <summary>
+	/// Path tiles a new turret would cover from every tile, Shown when hovering a tile and used by automated players.
+	/// </summary>
+	PlacementScorer m_placementScorer;
+
+	/// <summary>
+	/// Plays in place of the player when set, Ticked before the simulation.
+	/// </summary>
+	eastl::unique_ptr<PlayerBot> m_pBot;
+
+	struct AwakeTurret
+	{
+		uint32_t m_tileIndex;
+		class Turret* m_pTurret;
+	};
+
+	/// <summary>
+	/// Turrets that are updated every tick, The others sleep until they have something to do.
+	/// </summary>
+	eastl::vector<AwakeTurret> m_awakeTurrets;
+
+	/// <summary>
+	/// Wakes sleeping turrets once their cooldown runs out or an enemy could have reached them, By tile index.
+	/// </summary>
+	TimingWheel m_turretWheel;
+	eastl::vector<uint32_t> m_dueTurretTiles;
+
+	/// <summary>
+	/// Fastest enemy on the paths, Bounds how soon an enemy can reach a sleeping turret.
+	/// </summary>
+	float m_maxEnemySpeed;
+
+	/// <summary>
+	/// Wether a faster enemy showed up, Every turret wakes up on the next tick.
+	/// </summary>
+	bool m_isTurretWakeUpPending;
+
+	/// <summary>
+	/// Enemies as they were before the turrets updated, What every turret aims at.
+	/// </summary>
+	EnemySnapshot m_enemySnapshot;
+
+	/// <summary>
+	/// Shots of the awake turrets, One list per thread that aimed.
+	/// </summary>
+	eastl::vector<eastl::vector<TurretShot>> m_threadShots;
+	eastl::vector<TargetingStats> m_threadStats;
+	eastl::vector<TurretShot> m_turretShots;
+
+	/// <summary>
+	/// Most threads the awake turrets are split over, 0 uses every core.
+	/// </summary>
+	unsigned int m_turretThreadCount;
+
+	/// <summary>
+	/// Threads the awake turrets are aimed on, Kept between ticks and only restarted when the thread count changes.
+	/// </summary>
+	WorkStealingPool m_turretPool;
+
+	/// <summary>
+	/// Per frame counters, Shown by the performance overlay.
 	/// </summary>
-	dragon::Random m_random;
+	MetricsRegistry m_metrics;
 
 	/// <summary>
 	/// Player Gold.
@@ -84,6 +229,16 @@ class World
 	/// </summary>
 	Enemies m_enemiesToAdd;
 
+	/// <summary>
+	/// Hands out the handles turrets keep to their targets, A handle stops resolving once its enemy is gone.
+	/// </summary>
+	EnemyRegistry m_enemyRegistry;
+
+	/// <summary>
+	/// Deaths and despawns of this tick, Flushed to scoring and the spawners at the end of the tick.
+	/// </summary>
+	EnemyEventQueue m_enemyEvents;
+
 	//
 	// User Interaction
 	//
@@ -122,6 +277,13 @@ class World
 	/// </summary>
 	sf::Text m_pauseText;
 
+	/// <summary>
+	/// Displays the performance overlay.
+	/// </summary>
+	sf::Text m_metricsText;
+
+	bool m_isMetricsVisible;
+
 public:
 
 	World()
@@ -130,6 +292,19 @@ public:
 		, m_pDefaultWaveGenerator(nullptr)
 		, m_pMovingTurret(nullptr)
 		, m_playerGold(0.0f)
+		, m_score(0.0f)
+		, m_worldSeed(0)
+		, m_roundCount(0)
+		, m_isHeadless(false)
+		, m_tick(0)
+		, m_tickAccumulator(0.0f)
+		, m_isJournalEnabled(false)
+		, m_isMetricsVisible(false)
+		, m_isRoundStagingEnabled(true)
+		, m_isMazingEnabled(false)
+		, m_maxEnemySpeed(0.0f)
+		, m_isTurretWakeUpPending(false)
+		, m_turretThreadCount(0)
 	{}
 
 	~World();
@@ -137,7 +312,8 @@ public:
 	/// <summary>
 	/// Initialize the world
 	/// </summary>
-	bool Init();
+	/// <param name="isHeadless">Skip loading fonts, tilesets and the user interface.</param>
+	bool Init(bool isHeadless = false);
 
 	/// <summary>
 	/// Reset the world to start from the beginning.
@@ -182,18 +358,121 @@ public:
 	/// <param name="target"></param>
 	void Render(dragon::RenderTarget& target);
 
+	/// <summary>
+	/// Updates the user interface and runs as many fixed simulation steps as [dt] covers.
+	/// </summary>
 	void Update(float dt);
 
+	/// <summary>
+	/// Advances the simulation by exactly one fixed step.
+	/// </summary>
+	void Tick();
+
+	uint32_t GetTick() const { return m_tick; }
+
+	/// <summary>
+	/// Applies a player action to the world, And records it when a journal is being recorded.
+	/// </summary>
+	void ApplyAction(PlayerAction action);
+
+	/// <summary>
+	/// Hashes the full simulation state. Equal hashes mean equal worlds.
+	/// </summary>
+	uint64_t ComputeStateHash() const;
+
+	/// <summary>
+	/// Enables recording a journal for every generated world. (Enabled by default unless headless)
+	/// </summary>
+	void SetJournalEnabled(bool enabled) { m_isJournalEnabled = enabled; }
+
+	/// <summary>
+	/// Lets [pBot] play from the next tick on, Null hands the game back to the player.
+	/// </summary>
+	void SetBot(eastl::unique_ptr<PlayerBot> pBot) { m_pBot = eastl::move(pBot); }
+	bool HasBot() const { return m_pBot != nullptr; }
+
+	const InputJournal& GetJournal() const { return m_journal; }
+
+	/// <summary>
+	/// Writes the journal of the current game to disk, So it can be played back with --replay.
+	/// </summary>
+	bool SaveJournal(const char* pPath) const { return m_journal.Save(pPath); }
+
+	unsigned int GetWorldSeed() const { return m_worldSeed; }
+
+	const Round* GetCurrentRound() const { return m_pCurrentRound; }
+
+	float GetPlayerGold() const { return m_playerGold; }
+	size_t GetTurretCount() const { return m_turrets.size(); }
+	unsigned int GetRoundCount() const { return m_roundCount; }
+
+	/// <summary>
+	/// Placed turrets by tile index, The turret being moved isn't on the board.
+	/// </summary>
+	const Turrets& GetTurrets() const { return m_turrets; }
+	const Enemies& GetEnemies() const { return m_enemies; }
+
+	/// <summary>
+	/// Calls [listener] with the enemies that died, reached the goal or despawned, Once at the end of every tick they left the world on.
+	/// </summary>
+	void SubscribeEnemyEvents(EnemyEventQueue::Listener&& listener) { m_enemyEvents.Subscribe(eastl::move(listener)); }
+
+	MetricsRegistry& GetMetrics() { return m_metrics; }
+
+	const TDTilemap& GetTilemap() const { return m_tilemap; }
+	const MapGenerator& GetMapGenerator() const { return m_mapGenerator; }
+	const PlacementScorer& GetPlacementScorer() const { return m_placementScorer; }
+
+	/// <summary>
+	/// Disable when the world is driven by a tool that already keeps every core busy.
+	/// </summary>
+	void SetRoundStagingEnabled(bool enabled) { m_isRoundStagingEnabled = enabled; }
+
+	/// <summary>
+	/// Most threads the turrets aim on, 0 uses every core. The game plays out the same for any count.
+	/// </summary>
+	void SetTurretThreadCount(unsigned int threadCount) { m_turretThreadCount = threadCount; }
+
+	/// <summary>
+	/// Most threads the maps of this world are generated on, 0 uses every core. Staged rounds are generated by the stager's own generator.
+	/// </summary>
+	void SetGeneratorThreadCount(unsigned int threadCount) { m_mapGenerator.SetThreadCount(threadCount); }
+
+	bool IsMazingEnabled() const { return m_isMazingEnabled; }
+
+	/// <summary>
+	/// Writes the full game state to disk. (See WorldSnapshot)
+	/// </summary>
+	bool SaveSnapshot(const char* pPath) const;
+
+	/// <summary>
+	/// Restores the game state from a snapshot, Stops recording the journal.
+	/// </summary>
+	bool LoadSnapshot(const char* pPath);
+
 private:
 
-	void GenerateRound(const Round::RoundData& roundData);
+	/// <summary>
+	/// Generates the map, base and spawners of a round into [tilemap].
+	/// Only reads [roundData] (its difficulty included) and touches no world state, Which allows it to run on the round staging thread.
+	/// The round only keeps a pointer to the world.
+	/// </summary>
+	Round* GenerateRound(const Round::RoundData& roundData, MapGenerator& mapGenerator, TDTilemap& tilemap);
 
 	bool IsTurretPlaceable(class Turret* pTurret);
+
+	/// <summary>
+	/// Wether a turret can be built on [tileIndex], Paths are only buildable whilst mazing.
+	/// </summary>
+	bool IsTileBuildable(size_t tileIndex) const;
+
 	bool TryPlaceTurret(size_t tileIndex, class Turret* pTurret);
 
 	void BuyTurret(size_t index);
 	void SellTurret(size_t index);
 	void UpgradeTurret(size_t index);
+	void PickUpTurret(size_t index);
+	void PlaceMovingTurret(size_t index);
 	Turret* GenerateTurret();
 
 	void UpdateEnemies(float dt);
@@ -203,6 +482,11 @@ private:
 	void DrawTurretsAndCursor(dragon::RenderTarget& target);
 	void DrawTurretInformation(dragon::RenderTarget& target, class Turret* pTurret);
 
+	/// <summary>
+	/// Tints the hovered tile by how much path a turret on it would cover.
+	/// </summary>
+	void DrawPlacementHint(dragon::RenderTarget& target, dragon::Vector2 tilePos);
+
 	void DrawPlacementSquare(dragon::RenderTarget& target, dragon::Vector2 tilePos, dragon::Color color) const;
 
 	void InitializeUserInterface();
@@ -211,6 +495,9 @@ private:
 	void UpdateRoundText();
 	void DrawUserInterface(dragon::RenderTarget& target);
 
+	void UpdateMetricsText();
+	void DrawMetrics(dragon::RenderTarget& target);
+
 #pragma region User Interactions
 
 	void HandleMousePress(dragon::MouseButtonPressed& ev);
@@ -229,6 +516,17 @@ private:
 	/// </summary>
 	void NextRound();
 
+	/// <summary>
+	/// Draws the data for round [roundIndex] of the current world.
+	/// Only depends on the world seed and the index, So rounds can be generated in any order.
+	/// </summary>
+	Round::RoundData GenerateRoundData(unsigned int roundIndex) const;
+
+	/// <summary>
+	/// Starts generating the round after the current one on the staging thread.
+	/// </summary>
+	void StageNextRound();
+
 	/// <summary>
 	/// Tell the round to start spawning waves of enemies or to stop.
 	/// </summary>
@@ -239,13 +537,84 @@ private:
 	/// </summary>
 	void ClearEnemies();
 
+	/// <summary>
+	/// Lets turrets block the paths, Or stops doing so.
+	/// </summary>
+	void ToggleMazing();
+
+	/// <summary>
+	/// Plans the spawner paths of the current round from scratch, Around every turret on the board.
+	/// </summary>
+	void RebuildMazePlanner();
+
+	/// <summary>
+	/// Lets the maze planner know a turret was added to or removed from [tileIndex].
+	/// </summary>
+	void OnTurretTileChanged(size_t tileIndex);
+
+	/// <summary>
+	/// Carves the paths the maze planner found, Enemies continue from wherever they are on their new path.
+	/// </summary>
+	void RepairSpawnerPaths();
+
+	/// <summary>
+	/// Tracks the spawner paths of the current round and recomputes the coverage of every turret, Called whenever the paths change.
+	/// </summary>
+	void RefreshPathCoverage();
+
+	/// <summary>
+	/// Adds the paths of the current round to the placement scorer again and rescores every tile.
+	/// </summary>
+	void UpdatePlacementScores();
+
+	/// <summary>
+	/// Rescores the tiles near [changedTiles] and near the paths added or removed from the placement scorer since the last call.
+	/// </summary>
+	void UpdatePlacementScores(const TileRect& changedTiles);
+
+	/// <summary>
+	/// Recomputes the stretches of the paths within range of [pTurret], Called whenever it moves or its range changes.
+	/// </summary>
+	void UpdateTurretCoverage(class Turret* pTurret);
+
+	/// <summary>
+	/// Switches the turret on [index] to the next targeting mode.
+	/// </summary>
+	void CycleTurretTargeting(size_t index);
+
+	/// <summary>
+	/// Updates [pTurret] again from this tick on, Catching up on the ticks it slept through.
+	/// </summary>
+	void WakeTurret(class Turret* pTurret);
+
+	/// <summary>
+	/// Wakes every turret on the board, Called when whatever they were waiting on might come sooner.
+	/// </summary>
+	void WakeAllTurrets();
+
+	/// <summary>
+	/// Wakes [pTurret] and stops updating it, Before it leaves the board.
+	/// </summary>
+	void UnscheduleTurret(class Turret* pTurret);
+
+	/// <summary>
+	/// Ticks [pTurret] can sleep through without missing anything, 0 keeps it awake. UINT32_MAX until it is woken up.
+	/// </summary>
+	uint32_t GetTurretSleepTicks(const class Turret* pTurret, float dt) const;
+
+	/// <summary>
+	/// Updates the awake turrets in [first, last) and has them look for a target, Collecting their shots in [shots].
+	/// Only changes the turrets themselves, So ranges that don't overlap can run on different threads.
+	/// </summary>
+	void AimTurrets(size_t first, size_t last, float dt, eastl::vector<TurretShot>& shots, TargetingStats& stats);
+
 public:
 
 	/// <summary>
 	/// Adds an enemy to the world.
 	/// </summary>
 	/// <param name="pEnemy"></param>
-	void AddEnemy(class Enemy* pEnemy) { m_enemiesToAdd.emplace_back(pEnemy); }
+	void AddEnemy(class Enemy* pEnemy) { m_enemyRegistry.Register(pEnemy); m_enemiesToAdd.emplace_back(pEnemy); }
 
 #pragma endregion
 
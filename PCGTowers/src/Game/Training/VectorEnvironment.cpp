@@ -0,0 +1,274 @@
+#include "VectorEnvironment.h"
+
+#include <Game/TowerDefense/World.h>
+#include <Game/TowerDefense/Enemy.h>
+#include <Game/Rounds/Round.h>
+#include <Game/Replay/PlayerAction.h>
+#include <Game/Generators/MapGenerator.h>
+
+#include <Utility/Profiler.h>
+
+#include <EASTL/algorithm.h>
+
+#include <cstring>
+#include <thread>
+
+/// <summary>
+/// Least environments stepped per task, Smaller chunks spend more time in the pool than in the worlds.
+/// </summary>
+static constexpr size_t g_kMinEnvironmentsPerChunk = 4;
+
+VectorEnvironment::VectorEnvironment()
+	: m_buffers()
+	, m_pActions(nullptr)
+	, m_threadCount(1)
+	, m_chunkSize(1)
+	, m_ticksPerStep(1)
+	, m_maxEpisodeTicks(0)
+{
+}
+
+VectorEnvironment::~VectorEnvironment()
+{
+	// Workers might still reference the environments.
+	m_pool.Stop();
+}
+
+bool VectorEnvironment::Init(size_t count, const EnvironmentBuffers& buffers, size_t threadCount)
+{
+	PCG_PROFILE_ZONE("VectorEnvironment::Init");
+
+	m_pool.Stop();
+
+	m_buffers = buffers;
+	m_threadCount = threadCount > 0 ? threadCount : eastl::max(1u, std::thread::hardware_concurrency());
+
+	// A few chunks per thread, So threads that finish early have something to steal.
+	m_chunkSize = eastl::max(g_kMinEnvironmentsPerChunk, count / (m_threadCount * 4));
+
+	m_environments.clear();
+	m_environments.resize(count);
+
+	for (Environment& environment : m_environments)
+	{
+		environment.m_pWorld.reset(new World());
+		environment.m_reward = 0.0f;
+		environment.m_episodeTicks = 0;
+		environment.m_isDone = true;
+		environment.m_observedRound = kNoRound;
+
+		World& world = *environment.m_pWorld;
+		if (!world.Init(true))
+			return false;
+
+		// The environments already keep every core busy.
+		world.SetRoundStagingEnabled(false);
+		world.SetTurretThreadCount(1);
+		world.SetGeneratorThreadCount(1);
+
+		// The environments never move, So the listener can hold on to this one.
+		Environment* pEnvironment = &environment;
+		world.SubscribeEnemyEvents([pEnvironment](const EnemyEvents& events)
+		{
+			for (const EnemyEvent& event : events)
+			{
+				if (event.m_type == EnemyEventType::kDied)
+					pEnvironment->m_reward += event.m_damage;
+				else if (event.m_type == EnemyEventType::kReachedGoal)
+					pEnvironment->m_reward -= event.m_damage;
+			}
+		});
+	}
+
+	if (m_threadCount > 1)
+		m_pool.Start(m_threadCount);
+
+	return true;
+}
+
+void VectorEnvironment::Reset(const uint32_t* pSeeds)
+{
+	PCG_PROFILE_ZONE("VectorEnvironment::Reset");
+
+	for (size_t i = 0; i < m_environments.size(); ++i)
+		Reset(i, pSeeds[i]);
+}
+
+void VectorEnvironment::Reset(size_t index, uint32_t seed)
+{
+	Environment& environment = m_environments[index];
+
+	environment.m_pWorld->GenerateWorld(seed);
+	environment.m_reward = 0.0f;
+	environment.m_episodeTicks = 0;
+	environment.m_isDone = false;
+	environment.m_observedRound = kNoRound;
+
+	m_buffers.m_pRewards[index] = 0.0f;
+	m_buffers.m_pDones[index] = 0;
+
+	WriteObservation(index);
+}
+
+void VectorEnvironment::Step(const EnvironmentAction* pActions)
+{
+	PCG_PROFILE_ZONE("VectorEnvironment::Step");
+
+	m_pActions = pActions;
+
+	const size_t kChunkCount = (m_environments.size() + m_chunkSize - 1) / m_chunkSize;
+
+	if (m_threadCount == 1 || kChunkCount == 1)
+	{
+		for (size_t chunk = 0; chunk < kChunkCount; ++chunk)
+			StepChunk(chunk);
+	}
+	else
+	{
+		// Only the chunk index is captured, Keeps the task within the inline storage of the function.
+		for (size_t chunk = 0; chunk < kChunkCount; ++chunk)
+			m_pool.Submit([this, chunk]() { StepChunk(chunk); });
+		m_pool.Wait();
+	}
+
+	m_pActions = nullptr;
+}
+
+void VectorEnvironment::StepChunk(size_t chunk)
+{
+	PCG_PROFILE_ZONE("VectorEnvironment::StepChunk");
+
+	const size_t kFirst = chunk * m_chunkSize;
+	const size_t kLast = eastl::min(kFirst + m_chunkSize, m_environments.size());
+
+	for (size_t i = kFirst; i < kLast; ++i)
+		StepEnvironment(i, m_pActions[i]);
+}
+
+void VectorEnvironment::StepEnvironment(size_t index, const EnvironmentAction& action)
+{
+	Environment& environment = m_environments[index];
+
+	// Done environments wait for a reset, Their last observation stays in the buffers.
+	if (environment.m_isDone)
+	{
+		m_buffers.m_pRewards[index] = 0.0f;
+		return;
+	}
+
+	World& world = *environment.m_pWorld;
+	environment.m_reward = 0.0f;
+
+	ApplyAction(world, action);
+
+	for (uint32_t tick = 0; tick < m_ticksPerStep; ++tick)
+	{
+		// Rounds start out paused, The agent only decides where the turrets go.
+		const Round* pRound = world.GetCurrentRound();
+		if (pRound && pRound->IsPaused())
+			world.ApplyAction(PlayerAction(PlayerActionType::kTogglePause, 0));
+
+		world.Tick();
+		++environment.m_episodeTicks;
+
+		pRound = world.GetCurrentRound();
+		if (!pRound || pRound->GetBaseHealth() <= 0.0f || (m_maxEpisodeTicks > 0 && environment.m_episodeTicks >= m_maxEpisodeTicks))
+		{
+			environment.m_isDone = true;
+			break;
+		}
+	}
+
+	m_buffers.m_pRewards[index] = environment.m_reward;
+	m_buffers.m_pDones[index] = environment.m_isDone ? 1 : 0;
+
+	WriteObservation(index);
+}
+
+void VectorEnvironment::ApplyAction(World& world, const EnvironmentAction& action)
+{
+	if (action.m_tileIndex >= kTileCount)
+		return;
+
+	switch (action.m_type)
+	{
+	case EnvironmentActionType::kBuy:
+		world.ApplyAction(PlayerAction(PlayerActionType::kBuyTurret, action.m_tileIndex));
+		break;
+	case EnvironmentActionType::kSell:
+		world.ApplyAction(PlayerAction(PlayerActionType::kSellTurret, action.m_tileIndex));
+		break;
+	case EnvironmentActionType::kUpgrade:
+		world.ApplyAction(PlayerAction(PlayerActionType::kUpgradeTurret, action.m_tileIndex));
+		break;
+	case EnvironmentActionType::kMove:
+	{
+		// A turret that is picked up and can't be put down would be lost, So only move onto free tiles.
+		const auto& turrets = world.GetTurrets();
+		if (action.m_targetTileIndex < kTileCount && action.m_targetTileIndex != action.m_tileIndex &&
+			turrets.find(action.m_tileIndex) != turrets.end() && turrets.find(action.m_targetTileIndex) == turrets.end())
+		{
+			world.ApplyAction(PlayerAction(PlayerActionType::kPickUpTurret, action.m_tileIndex));
+			world.ApplyAction(PlayerAction(PlayerActionType::kPlaceTurret, action.m_targetTileIndex));
+		}
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+void VectorEnvironment::WriteObservation(size_t index)
+{
+	PCG_PROFILE_ZONE("VectorEnvironment::WriteObservation");
+
+	Environment& environment = m_environments[index];
+	const World& world = *environment.m_pWorld;
+	const TDTilemap& tilemap = world.GetTilemap();
+
+	uint8_t* pTiles = m_buffers.m_pTiles + index * kTileChannelCount * kTileCount;
+	uint8_t* pPlaceable = pTiles + (size_t)EnvironmentTileChannel::kPlaceable * kTileCount;
+	uint8_t* pPath = pTiles + (size_t)EnvironmentTileChannel::kPath * kTileCount;
+	uint8_t* pTurrets = pTiles + (size_t)EnvironmentTileChannel::kTurret * kTileCount;
+
+	// Placeable tiles and paths only change with the map, Which is generated once per round.
+	if (environment.m_observedRound != world.GetRoundCount())
+	{
+		environment.m_observedRound = world.GetRoundCount();
+
+		for (size_t i = 0; i < kTileCount; ++i)
+		{
+			pPlaceable[i] = tilemap.GetTileDataAtIndex(i).m_isTurretPlaceable ? 1 : 0;
+			pPath[i] = MapGenerator::IsPathTile(tilemap.GetTileAtIndex(i)) ? 1 : 0;
+		}
+	}
+
+	// Turrets
+	std::memset(pTurrets, 0, kTileCount);
+	for (const auto& turret : world.GetTurrets())
+	{
+		if (turret.first < kTileCount)
+			pTurrets[turret.first] = (uint8_t)eastl::min<size_t>(turret.second->GetUpgradeLevel(), 255);
+	}
+
+	// Enemy density
+	float* pEnemies = m_buffers.m_pEnemies + index * kTileCount;
+	eastl::fill(pEnemies, pEnemies + kTileCount, 0.0f);
+
+	for (const Enemy* pEnemy : world.GetEnemies())
+	{
+		dragon::Vector2 tilePosition = tilemap.WorldToMapCoordinates(pEnemy->GetPosition());
+		if (tilemap.WithinBounds(tilePosition))
+			pEnemies[tilemap.IndexFromPosition(tilePosition)] += 1.0f;
+	}
+
+	// Scalars
+	float* pScalars = m_buffers.m_pScalars + index * kScalarChannelCount;
+	const Round* pRound = world.GetCurrentRound();
+
+	pScalars[(size_t)EnvironmentScalarChannel::kGold] = world.GetPlayerGold();
+	pScalars[(size_t)EnvironmentScalarChannel::kBaseHealth] = pRound ? pRound->GetBaseHealth() : 0.0f;
+	pScalars[(size_t)EnvironmentScalarChannel::kWaveTime] = pRound ? pRound->GetWaveTime() : 0.0f;
+	pScalars[(size_t)EnvironmentScalarChannel::kEnemies] = (float)world.GetEnemies().size();
+	pScalars[(size_t)EnvironmentScalarChannel::kTurrets] = (float)world.GetTurretCount();
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <Config.h>
+
+#include <Utility/WorkStealingPool.h>
+
+#include <EASTL/vector.h>
+#include <EASTL/unique_ptr.h>
+
+#include <cstdint>
+
+enum class EnvironmentActionType : uint8_t
+{
+	kNone,
+	kBuy,
+	kSell,
+	kUpgrade,
+	kMove,		// Move the turret on [m_tileIndex] to [m_targetTileIndex].
+
+	kCount
+};
+
+struct EnvironmentAction
+{
+	EnvironmentActionType m_type;
+	uint32_t m_tileIndex;
+	uint32_t m_targetTileIndex;	// Only used by kMove.
+
+	EnvironmentAction()
+		: EnvironmentAction(EnvironmentActionType::kNone, 0)
+	{}
+
+	EnvironmentAction(EnvironmentActionType type, uint32_t tileIndex, uint32_t targetTileIndex = 0)
+		: m_type(type)
+		, m_tileIndex(tileIndex)
+		, m_targetTileIndex(targetTileIndex)
+	{}
+};
+
+/// <summary>
+/// Layers of the tile observation, One byte per tile.
+/// </summary>
+enum class EnvironmentTileChannel : uint8_t
+{
+	kPlaceable,	// 1 if a turret can be built on the tile.
+	kPath,		// 1 if enemies walk over the tile.
+	kTurret,	// Upgrade level of the turret on the tile, 0 without one.
+
+	kCount
+};
+
+enum class EnvironmentScalarChannel : uint8_t
+{
+	kGold,
+	kBaseHealth,
+	kWaveTime,
+	kEnemies,
+	kTurrets,
+
+	kCount
+};
+
+/// <summary>
+/// Memory the observations are written to, Owned by the caller and laid out so it can be handed to a training framework as is.
+/// Each buffer holds the environments one after another.
+/// </summary>
+struct EnvironmentBuffers
+{
+	uint8_t* m_pTiles;		// [environment][EnvironmentTileChannel][tile]
+	float* m_pEnemies;		// [environment][tile], Amount of enemies on the tile.
+	float* m_pScalars;		// [environment][EnvironmentScalarChannel]
+	float* m_pRewards;		// [environment], Reward of the last step.
+	uint8_t* m_pDones;		// [environment], 1 once the episode ended, Stays so until the environment is reset.
+};
+
+/// <summary>
+/// Plays many headless worlds side by side for training agents, Every step applies one action and ticks each world.
+/// Observations go straight into the caller's buffers, So stepping doesn't allocate once the worlds warmed up.
+/// Worlds are independent, So with more than one thread they are stepped in chunks on a work-stealing pool.
+/// </summary>
+class VectorEnvironment
+{
+public:
+
+	static constexpr size_t kTileCount = g_kMapSize * g_kMapSize;
+	static constexpr size_t kTileChannelCount = (size_t)EnvironmentTileChannel::kCount;
+	static constexpr size_t kScalarChannelCount = (size_t)EnvironmentScalarChannel::kCount;
+
+private:
+
+	static constexpr unsigned int kNoRound = 0xFFFFFFFF;
+
+	struct Environment
+	{
+		eastl::unique_ptr<class World> m_pWorld;
+		float m_reward;				// Gathered from the enemy events during a step.
+		uint32_t m_episodeTicks;
+		bool m_isDone;
+
+		/// <summary>
+		/// Round the placeable and path layers were written for, They only change when a new map is generated.
+		/// </summary>
+		unsigned int m_observedRound;
+	};
+
+	eastl::vector<Environment> m_environments;
+	EnvironmentBuffers m_buffers;
+
+	/// <summary>
+	/// The actions of the step being played, Read by the chunks on the pool.
+	/// </summary>
+	const EnvironmentAction* m_pActions;
+
+	size_t m_threadCount;
+	size_t m_chunkSize;
+	WorkStealingPool m_pool;
+
+	uint32_t m_ticksPerStep;
+
+	/// <summary>
+	/// Ticks after which an episode ends on its own, 0 to play until the base falls.
+	/// </summary>
+	uint32_t m_maxEpisodeTicks;
+
+public:
+
+	VectorEnvironment();
+	~VectorEnvironment();
+
+	VectorEnvironment(const VectorEnvironment&) = delete;
+	VectorEnvironment& operator=(const VectorEnvironment&) = delete;
+
+	/// <summary>
+	/// Creates [count] worlds writing into [buffers], The buffers have to outlive the environment. 0 threads uses every core.
+	/// </summary>
+	bool Init(size_t count, const EnvironmentBuffers& buffers, size_t threadCount = 1);
+
+	void SetTicksPerStep(uint32_t ticks) { m_ticksPerStep = ticks > 0 ? ticks : 1; }
+	void SetMaxEpisodeTicks(uint32_t ticks) { m_maxEpisodeTicks = ticks; }
+
+	/// <summary>
+	/// Generates a new world for every environment from [pSeeds], One seed per environment. Writes the first observations.
+	/// </summary>
+	void Reset(const uint32_t* pSeeds);
+
+	/// <summary>
+	/// Generates a new world for environment [index] only, For resetting environments as their episodes end.
+	/// </summary>
+	void Reset(size_t index, uint32_t seed);
+
+	/// <summary>
+	/// Applies [pActions], One per environment, Then plays every environment that isn't done and writes its observation, reward and done flag.
+	/// </summary>
+	void Step(const EnvironmentAction* pActions);
+
+	size_t GetSize() const { return m_environments.size(); }
+
+private:
+
+	void StepChunk(size_t chunk);
+	void StepEnvironment(size_t index, const EnvironmentAction& action);
+
+	/// <summary>
+	/// Turns [action] into the player actions the world understands, Invalid actions do nothing.
+	/// </summary>
+	void ApplyAction(class World& world, const EnvironmentAction& action);
+
+	void WriteObservation(size_t index);
+};
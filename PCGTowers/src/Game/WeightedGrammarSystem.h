@@ -1,6 +1,6 @@
 #pragma once
 
-#include <Dragon/Generic/Random.h>
+#include <Game/Generators/CounterRandom.h>
 
 #include <EASTL/map.h>
 #include <EASTL/unordered_set.h>
@@ -52,7 +52,7 @@ private:
 	using TerminationSymbols = eastl::unordered_set<char>;
 	TerminationSymbols m_terminationSymbols;
 
-	dragon::Random m_random;
+	CounterRandom m_random;
 
 public:
 
@@ -62,13 +62,13 @@ public:
 	WeightedGrammarSystem(RuleMap&& rules, TerminationSymbols&& terminators)
 		: m_rules(eastl::move(rules))
 		, m_terminationSymbols(eastl::move(terminators))
-		, m_random((unsigned int)time(nullptr))
+		, m_random(0, RandomStream::kGrammar) // Deterministic until seeded.
 		, m_pRoot(nullptr)
 	{}
 
 	~WeightedGrammarSystem();
 
-	void SetSeed(unsigned int seed) { m_random.Seed(seed); }
+	void SetSeed(unsigned int seed) { m_random.Seed(seed, RandomStream::kGrammar); }
 
 	void AddRule(char symbol, const Rule& rule) { m_rules.emplace(symbol, rule); }
 
@@ -2,6 +2,15 @@
 
 #include <Game/TowerDefense/Enemy.h>
 
+#include <Tools/DeterminismCheck.h>
+#include <Tools/ReplayPlayer.h>
+#include <Tools/SeedSweep.h>
+#include <Tools/SessionHost.h>
+
+#include <Utility/Profiler.h>
+
+#include <cstring>
+
 /// <summary>
 /// Things that I would improve:
 /// 
@@ -17,13 +26,46 @@
 /// Otherwise I am generally happy with the outcome.
 /// Anyway Happy Holidays ! And I hope you feel better soon from the breakdown.
 /// </summary>
-int main()
+int main(int argc, char** argv)
 {
+	// Command line tools, These run without opening a window.
+	if (argc > 1 && std::strcmp(argv[1], "--verify-determinism") == 0)
+	{
+		DeterminismCheck check;
+		check.ParseArguments(argc - 2, argv + 2);
+		return check.Run();
+	}
+
+	if (argc > 1 && std::strcmp(argv[1], "--replay") == 0)
+	{
+		ReplayPlayer player;
+		player.ParseArguments(argc - 2, argv + 2);
+		return player.Run();
+	}
+
+	if (argc > 1 && std::strcmp(argv[1], "--sweep") == 0)
+	{
+		SeedSweep sweep;
+		sweep.ParseArguments(argc - 2, argv + 2);
+		return sweep.Run();
+	}
+
+	if (argc > 1 && std::strcmp(argv[1], "--sessions") == 0)
+	{
+		SessionHost host;
+		host.ParseArguments(argc - 2, argv + 2);
+		return host.Run();
+	}
+
 	PCGTowersApp app;
 	if (!app.Init())
 		return 0;
 
 	app.Run();
 
+#if PCG_PROFILING
+	Profiler::WriteChromeTrace("trace.json");
+#endif
+
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,208 @@
+#include "DeterminismCheck.h"
+
+#include <Config.h>
+
+#include <Game/TowerDefense/World.h>
+#include <Game/TowerDefense/Enemy.h>
+#include <Game/TowerDefense/Spawner.h>
+#include <Game/Generators/WaveGenerator.h>
+#include <Game/Generators/MapGenerator.h>
+
+#include <Utility/StateHasher.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+static constexpr size_t g_kSpawnersToHash = 5;
+static constexpr unsigned int g_kEnemiesPerType = 8;
+
+/// <summary>
+/// Tiles along each edge of the region wiped by the river check.
+/// </summary>
+static constexpr int g_kRegrownRegionSize = 5;
+
+void DeterminismCheck::ParseArguments(int argc, char** argv)
+{
+	if (argc > 0)
+		m_firstSeed = (unsigned int)std::strtoul(argv[0], nullptr, 10);
+
+	if (argc > 1)
+		m_seedCount = (unsigned int)std::strtoul(argv[1], nullptr, 10);
+}
+
+int DeterminismCheck::Run()
+{
+	const size_t kHardwareThreads = eastl::max(1u, std::thread::hardware_concurrency());
+	const size_t kThreadCounts[] = { 1, 2, 4, kHardwareThreads };
+
+	std::printf("Verifying determinism of seeds [%u, %u)\n", m_firstSeed, m_firstSeed + m_seedCount);
+
+	Hashes reference = HashSeeds(1);
+
+	int result = 0;
+	for (size_t threadCount : kThreadCounts)
+	{
+		Hashes hashes = HashSeeds(threadCount);
+
+		size_t mismatches = 0;
+		for (size_t i = 0; i < hashes.size(); ++i)
+		{
+			if (hashes[i] != reference[i])
+			{
+				if (mismatches == 0)
+					std::printf("  seed %u diverged: %016llx != %016llx\n", m_firstSeed + (unsigned int)i, (unsigned long long)hashes[i], (unsigned long long)reference[i]);
+
+				++mismatches;
+			}
+		}
+
+		std::printf("  %zu threads: %s (%zu mismatches)\n", threadCount, mismatches == 0 ? "OK" : "FAILED", mismatches);
+
+		if (mismatches > 0)
+			result = 1;
+	}
+
+	size_t riverMismatches = CheckRiverRegrowth();
+	std::printf("  river regrowth: %s (%zu mismatches)\n", riverMismatches == 0 ? "OK" : "FAILED", riverMismatches);
+
+	if (riverMismatches > 0)
+		result = 1;
+
+	return result;
+}
+
+size_t DeterminismCheck::CheckRiverRegrowth() const
+{
+	MapGenerator generator;
+	if (!generator.Init())
+		return m_seedCount;
+
+	const dragon::Vector2u kMapSize = { g_kMapSize, g_kMapSize };
+	const size_t kTileCount = (size_t)kMapSize.x * (size_t)kMapSize.y;
+
+	TDTilemap reference;
+	reference.Init(kMapSize, { g_kTileSize, g_kTileSize });
+
+	TDTilemap tilemap;
+	tilemap.Init(kMapSize, { g_kTileSize, g_kTileSize });
+
+	size_t mismatches = 0;
+	for (unsigned int i = 0; i < m_seedCount; ++i)
+	{
+		unsigned int seed = m_firstSeed + i;
+
+		// Corner to center like a spawner path, So the region has carved tiles to keep as well.
+		generator.Generate(reference, seed);
+		dragon::Vector2 base((int)kMapSize.x / 2, (int)kMapSize.y / 2);
+		Path path = generator.CarvePath(reference, dragon::Vector2(0, 0), base);
+		generator.SetBaseTile(reference, base);
+
+		for (size_t tile = 0; tile < kTileCount; ++tile)
+		{
+			tilemap.SetTileAtIndex(tile, reference.GetTileAtIndex(tile));
+			tilemap.GetTileDataAtIndex(tile) = reference.GetTileDataAtIndex(tile);
+		}
+
+		// Wipe the terrain around a tile halfway along the path, Paths and the base stay.
+		dragon::Vector2 center = tilemap.WorldToMapCoordinates(path[path.size() / 2]);
+		TileRect region = TileRect::FromTile(center).Expanded(g_kRegrownRegionSize / 2).Clipped(kMapSize);
+
+		for (int y = region.m_top; y < region.m_bottom; ++y)
+		{
+			for (int x = region.m_left; x < region.m_right; ++x)
+			{
+				dragon::TileID tileId = tilemap.GetTile(x, y);
+				MapGenerator::MapTile tileType = (MapGenerator::MapTile)(tileId % (size_t)MapGenerator::MapTile::kCount);
+				if (MapGenerator::IsPathTile(tileId) || tileType == MapGenerator::MapTile::kBase)
+					continue;
+
+				tilemap.SetTile(x, y, MapGenerator::GetThemeTile((size_t)tileId / (size_t)MapGenerator::MapTile::kCount, MapGenerator::MapTile::kPlain));
+				tilemap.GetTileData(x, y).m_isTurretPlaceable = true;
+			}
+		}
+
+		generator.GrowRivers(tilemap, region);
+
+		for (size_t tile = 0; tile < kTileCount; ++tile)
+		{
+			if (tilemap.GetTileAtIndex(tile) != reference.GetTileAtIndex(tile) ||
+				tilemap.GetTileDataAtIndex(tile).m_isTurretPlaceable != reference.GetTileDataAtIndex(tile).m_isTurretPlaceable)
+			{
+				if (mismatches == 0)
+					std::printf("  seed %u regrew tile %zu differently\n", seed, tile);
+
+				++mismatches;
+				break;
+			}
+		}
+	}
+
+	return mismatches;
+}
+
+DeterminismCheck::Hashes DeterminismCheck::HashSeeds(size_t threadCount) const
+{
+	Hashes hashes(m_seedCount, 0);
+
+	auto work = [this, threadCount, &hashes](size_t threadIndex)
+	{
+		// Every worker owns its own world and generators.
+		World world;
+		world.Init(true);
+
+		WaveGenerator waveGenerator;
+		waveGenerator.InitDefaults();
+
+		// Visit the seeds back to front, Results must not depend on the order of generation.
+		for (size_t i = m_seedCount; i-- > 0;)
+		{
+			if (i % threadCount != threadIndex)
+				continue;
+
+			unsigned int seed = m_firstSeed + (unsigned int)i;
+
+			StateHasher hasher;
+
+			// Map, base, spawners and paths.
+			world.GenerateWorld(seed);
+			hasher.Add(world.ComputeStateHash());
+
+			// Wave grammar and groups.
+			eastl::vector<Spawner> spawners;
+			for (size_t spawner = 0; spawner < g_kSpawnersToHash; ++spawner)
+				spawners.emplace_back(nullptr, dragon::Vector2((int)spawner, (int)spawner), Path());
+
+			for (unsigned int wave = 1; wave <= g_kWavesPerRound; ++wave)
+				waveGenerator.GenerateWaves(spawners, seed, wave);
+
+			for (const Spawner& spawner : spawners)
+				spawner.Hash(hasher);
+
+			// Enemy stats, Created back to front as well.
+			for (char enemyType : { 't', 's', 'g', 'r' })
+			{
+				SpawnDescriptor group(enemyType, g_kEnemiesPerType, seed);
+				for (unsigned int index = g_kEnemiesPerType; index-- > 0;)
+				{
+					Enemy* pEnemy = waveGenerator.CreateEnemy(group, index);
+					pEnemy->Hash(hasher);
+					delete pEnemy;
+				}
+			}
+
+			hashes[i] = hasher.GetHash();
+		}
+	};
+
+	eastl::vector<std::thread> threads;
+	for (size_t i = 1; i < threadCount; ++i)
+		threads.emplace_back(work, i);
+
+	work(0);
+
+	for (std::thread& thread : threads)
+		thread.join();
+
+	return hashes;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <EASTL/vector.h>
+#include <EASTL/algorithm.h>
+
+#include <cstdint>
+
+/// <summary>
+/// Generates worlds and waves for a range of seeds with different thread counts and compares the hashes.
+/// Also checks that regrowing the rivers of an edited region gives the same tiles as generating the whole map.
+/// Usage: PCGTowers --verify-determinism [firstSeed] [seedCount]
+/// </summary>
+class DeterminismCheck
+{
+	unsigned int m_firstSeed;
+	unsigned int m_seedCount;
+
+	using Hashes = eastl::vector<uint64_t>;
+
+public:
+
+	DeterminismCheck()
+		: m_firstSeed(0)
+		, m_seedCount(64)
+	{}
+
+	/// <summary>
+	/// Parses the arguments following --verify-determinism
+	/// </summary>
+	void ParseArguments(int argc, char** argv);
+
+	/// <summary>
+	/// Runs the check, Returns 0 if all thread counts produced identical hashes and every regrown region matched.
+	/// </summary>
+	int Run();
+
+private:
+
+	/// <summary>
+	/// Hashes all seeds using [threadCount] workers, Each worker visits its seeds in reverse order.
+	/// </summary>
+	Hashes HashSeeds(size_t threadCount) const;
+
+	/// <summary>
+	/// Wipes a region along a carved path for every seed and grows its rivers again, Returns the seeds whose tiles differ from the generated map.
+	/// </summary>
+	size_t CheckRiverRegrowth() const;
+};
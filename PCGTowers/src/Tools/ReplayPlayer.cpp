@@ -0,0 +1,123 @@
+#include "ReplayPlayer.h"
+
+#include <Config.h>
+
+#include <Game/TowerDefense/World.h>
+#include <Game/Replay/WorldRasterizer.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+void ReplayPlayer::ParseArguments(int argc, char** argv)
+{
+	for (int i = 0; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--no-verify") == 0)
+			m_shouldVerify = false;
+		else if (std::strcmp(argv[i], "--metrics") == 0 && i + 1 < argc)
+			m_pMetricsPath = argv[++i];
+		else if (std::strcmp(argv[i], "--raster") == 0 && i + 1 < argc)
+			m_pRasterPath = argv[++i];
+		else if (std::strcmp(argv[i], "--raster-scale") == 0 && i + 1 < argc)
+			m_rasterScale = (uint32_t)std::strtoul(argv[++i], nullptr, 10);
+		else
+			m_pPath = argv[i];
+	}
+}
+
+int ReplayPlayer::Run()
+{
+	if (!m_journal.Load(m_pPath))
+	{
+		std::printf("Failed to load replay '%s'\n", m_pPath);
+		return 1;
+	}
+
+	if (m_journal.GetTimeStep() != g_kFixedTimeStep)
+	{
+		std::printf("Replay was recorded with a time step of %f, This build uses %f\n", m_journal.GetTimeStep(), g_kFixedTimeStep);
+		return 1;
+	}
+
+	World world;
+	if (!world.Init(true))
+		return 1;
+
+	world.SetDifficulty(m_journal.GetDifficulty());
+	world.GenerateWorld(m_journal.GetSeed());
+
+	MetricsRegistry& metrics = world.GetMetrics();
+	if (m_pMetricsPath && !metrics.OpenCsv(m_pMetricsPath))
+	{
+		std::printf("Failed to open '%s'\n", m_pMetricsPath);
+		return 1;
+	}
+
+	WorldRasterizer rasterizer;
+	rasterizer.SetScale(m_rasterScale);
+	if (m_pRasterPath && !rasterizer.OpenStream(m_pRasterPath))
+	{
+		std::printf("Failed to open '%s'\n", m_pRasterPath);
+		return 1;
+	}
+
+	const InputJournal::Actions& actions = m_journal.GetActions();
+	const InputJournal::StateHashes& hashes = m_journal.GetStateHashes();
+	const uint32_t kTickCount = m_journal.GetTickCount();
+
+	std::printf("Replaying '%s': seed %u, %u ticks, %zu actions\n", m_pPath, m_journal.GetSeed(), kTickCount, actions.size());
+
+	auto start = std::chrono::steady_clock::now();
+
+	size_t nextAction = 0;
+	int result = 0;
+
+	for (uint32_t tick = 0; tick < kTickCount; ++tick)
+	{
+		auto frameStart = std::chrono::steady_clock::now();
+
+		// Actions are applied before the tick they were stamped with, Just like during recording.
+		while (nextAction < actions.size() && actions[nextAction].m_tick == tick)
+		{
+			world.ApplyAction(actions[nextAction]);
+			++nextAction;
+		}
+
+		world.Tick();
+
+		if (m_pRasterPath)
+			rasterizer.Rasterize(world);
+
+		if (m_shouldVerify && tick < hashes.size())
+		{
+			uint64_t hash = world.ComputeStateHash();
+			if (hash != hashes[tick])
+			{
+				std::printf("Diverged at tick %u (%.2fs): %016llx != %016llx\n", tick, tick * g_kFixedTimeStep, (unsigned long long)hash, (unsigned long long)hashes[tick]);
+				result = 1;
+				break;
+			}
+		}
+
+		// Every tick is a frame when running headless.
+		std::chrono::duration<double, std::milli> frameTime = std::chrono::steady_clock::now() - frameStart;
+		metrics.Set(Metric::kFrameTime, frameTime.count());
+		metrics.EndFrame();
+	}
+
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	double simulatedTime = world.GetTick() * (double)g_kFixedTimeStep;
+
+	std::printf("Simulated %u ticks in %.3fs (%.1f ticks/s, %.1fx realtime)\n",
+		world.GetTick(), elapsed.count(), world.GetTick() / elapsed.count(), simulatedTime / elapsed.count());
+
+	if (result == 0 && m_shouldVerify)
+		std::printf("All %zu recorded state hashes matched.\n", hashes.size());
+
+	if (m_pRasterPath)
+		std::printf("Wrote %u rasters of %ux%u cells to '%s'\n", rasterizer.GetFrameCount(), rasterizer.GetWidth(), rasterizer.GetHeight(), m_pRasterPath);
+
+	return result;
+}
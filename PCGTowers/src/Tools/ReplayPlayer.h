@@ -0,0 +1,49 @@
+#pragma once
+
+#include <Game/Replay/InputJournal.h>
+
+#include <cstdint>
+
+/// <summary>
+/// Plays a recorded journal back in a headless world as fast as possible.
+/// Compares the state hash after every tick and reports the first tick at which the simulation diverged.
+/// Usage: PCGTowers --replay [journal] [--no-verify] [--metrics file.csv] [--raster file.pcgx] [--raster-scale n]
+/// </summary>
+class ReplayPlayer
+{
+	const char* m_pPath;
+	bool m_shouldVerify;
+
+	/// <summary>
+	/// Writes the metrics of every tick as CSV when set.
+	/// </summary>
+	const char* m_pMetricsPath;
+
+	/// <summary>
+	/// Streams a raster of every tick when set. (See WorldRasterizer)
+	/// </summary>
+	const char* m_pRasterPath;
+	uint32_t m_rasterScale;
+
+	InputJournal m_journal;
+
+public:
+
+	ReplayPlayer()
+		: m_pPath("replay.pcgr")
+		, m_shouldVerify(true)
+		, m_pMetricsPath(nullptr)
+		, m_pRasterPath(nullptr)
+		, m_rasterScale(1)
+	{}
+
+	/// <summary>
+	/// Parses the arguments following --replay
+	/// </summary>
+	void ParseArguments(int argc, char** argv);
+
+	/// <summary>
+	/// Plays the journal back, Returns 0 if every tick matched the recording.
+	/// </summary>
+	int Run();
+};
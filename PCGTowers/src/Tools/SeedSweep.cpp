@@ -0,0 +1,225 @@
+#include "SeedSweep.h"
+
+#include <Config.h>
+
+#include <Game/TowerDefense/World.h>
+#include <Game/TowerDefense/Spawner.h>
+#include <Game/Rounds/Round.h>
+#include <Game/Generators/MapGenerator.h>
+
+#include <EASTL/algorithm.h>
+#include <EASTL/unique_ptr.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+/// <summary>
+/// Seeds generated between writes, Keeps memory bounded for huge ranges.
+/// </summary>
+static constexpr unsigned int g_kSeedsPerChunk = 4096;
+
+SeedSweep::SeedSweep()
+	: m_firstSeed(0)
+	, m_seedCount(1024)
+	, m_roundsPerSeed(1)
+	, m_threadCount(eastl::max(1u, std::thread::hardware_concurrency()))
+	, m_pOutPath("sweep.csv")
+{
+}
+
+void SeedSweep::ParseArguments(int argc, char** argv)
+{
+	size_t position = 0;
+
+	for (int i = 0; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--rounds") == 0 && i + 1 < argc)
+			m_roundsPerSeed = eastl::max(1u, (unsigned int)std::strtoul(argv[++i], nullptr, 10));
+		else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+			m_threadCount = eastl::max<size_t>(1, (size_t)std::strtoul(argv[++i], nullptr, 10));
+		else if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+			m_pOutPath = argv[++i];
+		else if (position == 0)
+		{
+			m_firstSeed = (unsigned int)std::strtoul(argv[i], nullptr, 10);
+			++position;
+		}
+		else if (position == 1)
+		{
+			m_seedCount = (unsigned int)std::strtoul(argv[i], nullptr, 10);
+			++position;
+		}
+	}
+}
+
+int SeedSweep::Run()
+{
+	std::FILE* pFile = std::fopen(m_pOutPath, "w");
+	if (!pFile)
+	{
+		std::printf("Failed to open '%s'\n", m_pOutPath);
+		return 1;
+	}
+
+	std::printf("Sweeping seeds [%u, %u), %u round(s) each, on %zu threads\n", m_firstSeed, m_firstSeed + m_seedCount, m_roundsPerSeed, m_threadCount);
+
+	// Every worker owns a headless world, And with it its own map generator.
+	eastl::vector<eastl::unique_ptr<World>> worlds;
+	for (size_t i = 0; i < m_threadCount; ++i)
+	{
+		World* pWorld = new World();
+		if (!pWorld->Init(true))
+		{
+			delete pWorld;
+			std::fclose(pFile);
+			return 1;
+		}
+
+		// The workers already keep every core busy.
+		pWorld->SetRoundStagingEnabled(false);
+		pWorld->SetGeneratorThreadCount(1);
+		worlds.emplace_back(pWorld);
+	}
+
+	WriteHeader(pFile);
+
+	Results results;
+	auto start = std::chrono::steady_clock::now();
+
+	for (unsigned int chunkStart = 0; chunkStart < m_seedCount; chunkStart += g_kSeedsPerChunk)
+	{
+		const unsigned int kChunkSize = eastl::min(g_kSeedsPerChunk, m_seedCount - chunkStart);
+
+		results.resize((size_t)kChunkSize * m_roundsPerSeed);
+
+		// Seeds vary in cost, So workers take the next seed as they become free.
+		// Rows are written to the seed's slot, So the output doesn't depend on the thread count.
+		std::atomic<unsigned int> nextSeed(0);
+
+		auto work = [&](size_t threadIndex)
+		{
+			World& world = *worlds[threadIndex];
+
+			for (unsigned int i = nextSeed.fetch_add(1); i < kChunkSize; i = nextSeed.fetch_add(1))
+			{
+				unsigned int seed = m_firstSeed + chunkStart + i;
+
+				world.GenerateWorld(seed);
+				MeasureRound(world, seed, 0, results[(size_t)i * m_roundsPerSeed]);
+
+				for (unsigned int round = 1; round < m_roundsPerSeed; ++round)
+				{
+					world.ApplyAction(PlayerAction(PlayerActionType::kNextRound, 0));
+					MeasureRound(world, seed, round, results[(size_t)i * m_roundsPerSeed + round]);
+				}
+			}
+		};
+
+		eastl::vector<std::thread> threads;
+		for (size_t i = 1; i < m_threadCount; ++i)
+			threads.emplace_back(work, i);
+
+		work(0);
+
+		for (std::thread& thread : threads)
+			thread.join();
+
+		for (const RoundMetrics& metrics : results)
+			WriteRow(pFile, metrics);
+	}
+
+	std::fclose(pFile);
+
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	std::printf("Generated %u seeds in %.3fs (%.1f seeds/s), Written to '%s'\n", m_seedCount, elapsed.count(), m_seedCount / elapsed.count(), m_pOutPath);
+
+	return 0;
+}
+
+void SeedSweep::MeasureRound(const World& world, unsigned int seed, unsigned int round, RoundMetrics& metrics)
+{
+	std::memset(&metrics, 0, sizeof(metrics));
+	metrics.m_seed = seed;
+	metrics.m_round = round;
+
+	const Round* pRound = world.GetCurrentRound();
+	if (!pRound)
+		return;
+
+	const Round::RoundData& data = pRound->GetRoundData();
+	metrics.m_temperature = data.m_temperature;
+	metrics.m_precipitation = data.m_precipitation;
+	metrics.m_biome = world.GetMapGenerator().GetBiomeType(data.m_temperature, data.m_precipitation);
+
+	// Paths
+	const Round::Spawners& spawners = pRound->GetSpawners();
+	metrics.m_spawners = (uint32_t)spawners.size();
+	metrics.m_minPathLength = spawners.empty() ? 0 : UINT32_MAX;
+
+	size_t totalPathLength = 0;
+	for (const Spawner& spawner : spawners)
+	{
+		uint32_t length = (uint32_t)spawner.GetPath().size();
+		metrics.m_minPathLength = eastl::min(metrics.m_minPathLength, length);
+		metrics.m_maxPathLength = eastl::max(metrics.m_maxPathLength, length);
+		totalPathLength += length;
+	}
+
+	if (!spawners.empty())
+		metrics.m_meanPathLength = (float)totalPathLength / (float)spawners.size();
+
+	// Tiles
+	const TDTilemap& tilemap = world.GetTilemap();
+	const dragon::Vector2u kMapSize = tilemap.GetSize();
+	const size_t kTileCount = (size_t)kMapSize.x * (size_t)kMapSize.y;
+
+	size_t placeable = 0;
+	size_t dense = 0;
+	size_t river = 0;
+	size_t path = 0;
+
+	for (size_t i = 0; i < kTileCount; ++i)
+	{
+		if (tilemap.GetTileDataAtIndex(i).m_isTurretPlaceable)
+			++placeable;
+
+		auto tile = (MapGenerator::MapTile)(tilemap.GetTileAtIndex(i) % (size_t)MapGenerator::MapTile::kCount);
+		switch (tile)
+		{
+		case MapGenerator::MapTile::kDense:
+			++dense;
+			break;
+		case MapGenerator::MapTile::kVeryMoist:
+			++river;
+			break;
+		case MapGenerator::MapTile::kPath:
+		case MapGenerator::MapTile::kPathVeryMoist:
+			++path;
+			break;
+		default:
+			break;
+		}
+	}
+
+	metrics.m_placeableRatio = (float)placeable / (float)kTileCount;
+	metrics.m_denseRatio = (float)dense / (float)kTileCount;
+	metrics.m_riverRatio = (float)river / (float)kTileCount;
+	metrics.m_pathRatio = (float)path / (float)kTileCount;
+}
+
+void SeedSweep::WriteHeader(std::FILE* pFile)
+{
+	std::fprintf(pFile, "seed,round,temperature,precipitation,biome,spawners,min_path,max_path,mean_path,placeable_ratio,dense_ratio,river_ratio,path_ratio\n");
+}
+
+void SeedSweep::WriteRow(std::FILE* pFile, const RoundMetrics& metrics)
+{
+	std::fprintf(pFile, "%u,%u,%.4f,%.4f,%08X,%u,%u,%u,%.3f,%.5f,%.5f,%.5f,%.5f\n",
+		metrics.m_seed, metrics.m_round,
+		metrics.m_temperature, metrics.m_precipitation, (unsigned int)metrics.m_biome,
+		metrics.m_spawners, metrics.m_minPathLength, metrics.m_maxPathLength, metrics.m_meanPathLength,
+		metrics.m_placeableRatio, metrics.m_denseRatio, metrics.m_riverRatio, metrics.m_pathRatio);
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <Game/Biome.h>
+
+#include <EASTL/vector.h>
+
+#include <cstdint>
+#include <cstdio>
+
+/// <summary>
+/// Generates worlds for a range of seeds on all cores and writes the quality metrics of every round to a CSV file.
+/// Usage: PCGTowers --sweep [firstSeed] [seedCount] [--rounds n] [--threads n] [--out file.csv]
+/// </summary>
+class SeedSweep
+{
+	/// <summary>
+	/// Metrics of a single generated round.
+	/// </summary>
+	struct RoundMetrics
+	{
+		unsigned int m_seed;
+		unsigned int m_round;
+
+		float m_temperature;
+		float m_precipitation;
+		BiomeType m_biome;
+
+		uint32_t m_spawners;
+		uint32_t m_minPathLength;
+		uint32_t m_maxPathLength;
+		float m_meanPathLength;
+
+		// Fraction of the tiles of each kind.
+		float m_placeableRatio;
+		float m_denseRatio;
+		float m_riverRatio;
+		float m_pathRatio;
+	};
+
+	using Results = eastl::vector<RoundMetrics>;
+
+	unsigned int m_firstSeed;
+	unsigned int m_seedCount;
+	unsigned int m_roundsPerSeed;
+	size_t m_threadCount;
+	const char* m_pOutPath;
+
+public:
+
+	SeedSweep();
+
+	/// <summary>
+	/// Parses the arguments following --sweep
+	/// </summary>
+	void ParseArguments(int argc, char** argv);
+
+	/// <summary>
+	/// Runs the sweep, Returns 0 on success.
+	/// </summary>
+	int Run();
+
+private:
+
+	static void MeasureRound(const class World& world, unsigned int seed, unsigned int round, RoundMetrics& metrics);
+
+	static void WriteHeader(std::FILE* pFile);
+	static void WriteRow(std::FILE* pFile, const RoundMetrics& metrics);
+};
@@ -0,0 +1,171 @@
+#include "SessionHost.h"
+
+#include <Config.h>
+
+#include <Game/TowerDefense/World.h>
+#include <Game/Rounds/Round.h>
+#include <Game/Replay/PlayerAction.h>
+#include <Game/Bots/GreedyBot.h>
+
+#include <Utility/StateHasher.h>
+#include <Utility/Profiler.h>
+
+#include <EASTL/algorithm.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+SessionHost::SessionHost()
+	: m_sessionCount(256)
+	, m_firstSeed(0)
+	, m_threadCount(eastl::max(1u, std::thread::hardware_concurrency()))
+	, m_ticksPerSession((uint32_t)(60.0f / g_kFixedTimeStep))
+	, m_ticksPerSlice((uint32_t)(1.0f / g_kFixedTimeStep))
+	, m_hasBots(false)
+{
+}
+
+SessionHost::~SessionHost()
+{
+	// Workers might still reference the sessions.
+	m_pool.Stop();
+}
+
+void SessionHost::ParseArguments(int argc, char** argv)
+{
+	for (int i = 0; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+			m_threadCount = eastl::max<size_t>(1, (size_t)std::strtoul(argv[++i], nullptr, 10));
+		else if (std::strcmp(argv[i], "--ticks") == 0 && i + 1 < argc)
+			m_ticksPerSession = (uint32_t)std::strtoul(argv[++i], nullptr, 10);
+		else if (std::strcmp(argv[i], "--slice") == 0 && i + 1 < argc)
+			m_ticksPerSlice = eastl::max(1u, (uint32_t)std::strtoul(argv[++i], nullptr, 10));
+		else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+			m_firstSeed = (unsigned int)std::strtoul(argv[++i], nullptr, 10);
+		else if (std::strcmp(argv[i], "--bot") == 0)
+			m_hasBots = true;
+		else
+			m_sessionCount = (unsigned int)std::strtoul(argv[i], nullptr, 10);
+	}
+}
+
+int SessionHost::Run()
+{
+	std::printf("Hosting %u sessions of %u ticks each, Seeds [%u, %u), on %zu threads%s\n",
+		m_sessionCount, m_ticksPerSession, m_firstSeed, m_firstSeed + m_sessionCount, m_threadCount, m_hasBots ? ", Played by bots" : "");
+
+	m_sessions.clear();
+	m_sessions.resize(m_sessionCount);
+	m_pool.Start(m_threadCount);
+
+	// Generating a world is as expensive as playing a good while of it, So it is spread over the pool as well.
+	std::atomic<bool> isFailed(false);
+	for (size_t i = 0; i < m_sessions.size(); ++i)
+	{
+		m_pool.Submit([this, i, &isFailed]()
+		{
+			if (!CreateSession(i))
+				isFailed = true;
+		});
+	}
+	m_pool.Wait();
+
+	if (isFailed)
+	{
+		std::printf("Failed to create the sessions\n");
+		return 1;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+
+	for (size_t i = 0; i < m_sessions.size(); ++i)
+		m_pool.Submit([this, i]() { StepSession(i); });
+	m_pool.Wait();
+
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	// Sessions don't share any state, So the combined hash is the same for any thread count.
+	StateHasher hasher;
+	double stepTime = 0.0;
+
+	for (const Session& session : m_sessions)
+	{
+		hasher.Add(session.m_pWorld->ComputeStateHash());
+		stepTime += session.m_stepTime;
+	}
+
+	const double kTotalTicks = (double)m_sessionCount * (double)m_ticksPerSession;
+	const double kTicksPerSecond = kTotalTicks / elapsed.count();
+
+	std::printf("Played %.0f ticks in %.3fs: %.0f ticks/s, %.0f ticks/s per core (%.1fx realtime per core)\n",
+		kTotalTicks, elapsed.count(), kTicksPerSecond, kTicksPerSecond / m_threadCount, kTicksPerSecond / m_threadCount * g_kFixedTimeStep);
+	std::printf("Threads were ticking %.1f%% of the time, %zu slices were stolen\n",
+		100.0 * stepTime / (elapsed.count() * m_threadCount), m_pool.GetStealCount());
+	std::printf("State hash %016llx\n", (unsigned long long)hasher.GetHash());
+
+	m_pool.Stop();
+	m_sessions.clear();
+
+	return 0;
+}
+
+bool SessionHost::CreateSession(size_t index)
+{
+	PCG_PROFILE_ZONE("SessionHost::CreateSession");
+
+	Session& session = m_sessions[index];
+	session.m_pWorld.reset(new World());
+	session.m_ticksLeft = m_ticksPerSession;
+	session.m_stepTime = 0.0;
+
+	World& world = *session.m_pWorld;
+	if (!world.Init(true))
+		return false;
+
+	// The pool already keeps every core busy.
+	world.SetRoundStagingEnabled(false);
+	world.SetTurretThreadCount(1);
+	world.SetGeneratorThreadCount(1);
+
+	world.GenerateWorld(m_firstSeed + (unsigned int)index);
+
+	if (m_hasBots)
+		world.SetBot(eastl::unique_ptr<PlayerBot>(new GreedyBot()));
+
+	return true;
+}
+
+void SessionHost::StepSession(size_t index)
+{
+	PCG_PROFILE_ZONE("SessionHost::StepSession");
+
+	Session& session = m_sessions[index];
+	World& world = *session.m_pWorld;
+
+	const uint32_t kTicks = eastl::min(session.m_ticksLeft, m_ticksPerSlice);
+
+	auto start = std::chrono::steady_clock::now();
+
+	for (uint32_t tick = 0; tick < kTicks; ++tick)
+	{
+		// Rounds start out paused, Nobody is there to start them.
+		const Round* pRound = world.GetCurrentRound();
+		if (pRound && pRound->IsPaused())
+			world.ApplyAction(PlayerAction(PlayerActionType::kTogglePause, 0));
+
+		world.Tick();
+	}
+
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	session.m_stepTime += elapsed.count();
+	session.m_ticksLeft -= kTicks;
+
+	// Back into this thread's queue, Idle threads steal it from there.
+	if (session.m_ticksLeft > 0)
+		m_pool.Submit([this, index]() { StepSession(index); });
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <Utility/WorkStealingPool.h>
+
+#include <EASTL/vector.h>
+#include <EASTL/unique_ptr.h>
+
+#include <cstdint>
+
+/// <summary>
+/// Plays many independent headless games at once on a work-stealing pool and reports the throughput in game ticks per second per core.
+/// Every session owns its world, And with it its generators and random streams. Sessions only share read-only tables.
+/// Usage: PCGTowers --sessions [sessionCount] [--threads n] [--ticks n] [--slice n] [--seed n] [--bot]
+/// </summary>
+class SessionHost
+{
+	struct Session
+	{
+		eastl::unique_ptr<class World> m_pWorld;
+		uint32_t m_ticksLeft;
+		double m_stepTime;	// Seconds spent ticking the world.
+	};
+
+	unsigned int m_sessionCount;
+	unsigned int m_firstSeed;
+	size_t m_threadCount;
+
+	/// <summary>
+	/// Ticks every session plays.
+	/// </summary>
+	uint32_t m_ticksPerSession;
+
+	/// <summary>
+	/// Ticks a session plays per task, After which it goes back into the pool so idle threads can steal it.
+	/// </summary>
+	uint32_t m_ticksPerSlice;
+
+	/// <summary>
+	/// Lets a GreedyBot build and upgrade turrets in every session, Without it sessions only play the waves.
+	/// </summary>
+	bool m_hasBots;
+
+	eastl::vector<Session> m_sessions;
+	WorkStealingPool m_pool;
+
+public:
+
+	SessionHost();
+	~SessionHost();
+
+	/// <summary>
+	/// Parses the arguments following --sessions
+	/// </summary>
+	void ParseArguments(int argc, char** argv);
+
+	/// <summary>
+	/// Plays every session to the end, Returns 0 on success.
+	/// </summary>
+	int Run();
+
+private:
+
+	/// <summary>
+	/// Creates and generates the world of session [index].
+	/// </summary>
+	bool CreateSession(size_t index);
+
+	/// <summary>
+	/// Plays a slice of session [index], Then submits the next slice.
+	/// </summary>
+	void StepSession(size_t index);
+};
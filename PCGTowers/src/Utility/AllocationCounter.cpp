@@ -0,0 +1,48 @@
+#include "AllocationCounter.h"
+
+#include <Utility/Profiler.h>
+
+#if PCG_PROFILING
+
+#include <cstdlib>
+#include <new>
+
+static thread_local uint64_t s_allocationCount = 0;
+
+uint64_t AllocationCounter::GetThreadCount()
+{
+	return s_allocationCount;
+}
+
+//
+// Global allocation functions, The array and nothrow versions forward to these by default.
+//
+
+void* operator new(std::size_t size)
+{
+	++s_allocationCount;
+
+	if (void* pMemory = std::malloc(size > 0 ? size : 1))
+		return pMemory;
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void* pMemory) noexcept
+{
+	std::free(pMemory);
+}
+
+void operator delete(void* pMemory, std::size_t) noexcept
+{
+	std::free(pMemory);
+}
+
+#else
+
+uint64_t AllocationCounter::GetThreadCount()
+{
+	return 0;
+}
+
+#endif
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+
+/// <summary>
+/// Counts the allocations made through the global operator new, Per thread so counting never contends.
+/// Replacing operator new is left to profiling builds, Like the profiler. Other builds count nothing.
+/// </summary>
+class AllocationCounter
+{
+public:
+
+	/// <summary>
+	/// Amount of allocations the calling thread has made since it started.
+	/// </summary>
+	static uint64_t GetThreadCount();
+};
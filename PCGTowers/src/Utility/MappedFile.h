@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// Read-only memory mapping of a file. The contents are paged in by the OS on access, Nothing is copied up front.
+/// </summary>
+class MappedFile
+{
+	const uint8_t* m_pData;
+	size_t m_size;
+
+#if _WIN32
+	void* m_fileHandle;
+	void* m_mappingHandle;
+#endif
+
+public:
+
+	MappedFile()
+		: m_pData(nullptr)
+		, m_size(0)
+#if _WIN32
+		, m_fileHandle(nullptr)
+		, m_mappingHandle(nullptr)
+#endif
+	{}
+
+	~MappedFile() { Close(); }
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool Open(const char* pPath);
+	void Close();
+
+	bool IsOpen() const { return m_pData != nullptr; }
+
+	const uint8_t* GetData() const { return m_pData; }
+	size_t GetSize() const { return m_size; }
+};
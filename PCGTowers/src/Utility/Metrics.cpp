@@ -0,0 +1,118 @@
+#include "Metrics.h"
+
+#include <Utility/AllocationCounter.h>
+
+#include <EASTL/algorithm.h>
+#include <EASTL/sort.h>
+
+struct MetricInfo
+{
+	const char* m_pName;
+	bool m_isCounter;
+};
+
+static constexpr MetricInfo g_kMetricInfo[] =
+{
+	{ "frame_ms", false },
+	{ "tick_ms", true },
+	{ "ticks", true },
+	{ "enemies", false },
+	{ "turrets", false },
+	{ "awake_turrets", false },
+	{ "sleeping_turrets", false },
+	{ "target_scans", true },
+	{ "distance_tests", true },
+	{ "allocations", true },
+	{ "round_generation_ms", false },
+};
+
+static_assert(sizeof(g_kMetricInfo) / sizeof(g_kMetricInfo[0]) == (size_t)Metric::kCount, "Every metric needs info.");
+
+MetricsRegistry::MetricsRegistry()
+	: m_frameCount(0)
+	, m_allocationsAtFrameStart(AllocationCounter::GetThreadCount())
+	, m_pCsvFile(nullptr)
+{
+	m_values.fill(0.0);
+	m_lastFrame.fill(0.0);
+	m_frameTimes.fill(0.0f);
+}
+
+MetricsRegistry::~MetricsRegistry()
+{
+	CloseCsv();
+}
+
+void MetricsRegistry::EndFrame()
+{
+	uint64_t allocations = AllocationCounter::GetThreadCount();
+	Set(Metric::kAllocations, (double)(allocations - m_allocationsAtFrameStart));
+	m_allocationsAtFrameStart = allocations;
+
+	m_frameTimes[m_frameCount % kHistorySize] = (float)m_values[(size_t)Metric::kFrameTime];
+
+	if (m_pCsvFile)
+	{
+		std::fprintf(m_pCsvFile, "%llu", (unsigned long long)m_frameCount);
+		for (double value : m_values)
+			std::fprintf(m_pCsvFile, ",%g", value);
+		std::fprintf(m_pCsvFile, "\n");
+	}
+
+	++m_frameCount;
+	m_lastFrame = m_values;
+
+	for (size_t i = 0; i < (size_t)Metric::kCount; ++i)
+	{
+		if (g_kMetricInfo[i].m_isCounter)
+			m_values[i] = 0.0;
+	}
+}
+
+float MetricsRegistry::GetFrameTimePercentile(float percentile) const
+{
+	const size_t kCount = (size_t)eastl::min<uint64_t>(m_frameCount, kHistorySize);
+	if (kCount == 0)
+		return 0.0f;
+
+	FrameTimes sorted = m_frameTimes;
+	eastl::sort(sorted.begin(), sorted.begin() + kCount);
+
+	size_t index = (size_t)(percentile / 100.0f * (float)(kCount - 1) + 0.5f);
+	return sorted[eastl::min(index, kCount - 1)];
+}
+
+bool MetricsRegistry::OpenCsv(const char* pPath)
+{
+	CloseCsv();
+
+	m_pCsvFile = std::fopen(pPath, "w");
+	if (!m_pCsvFile)
+		return false;
+
+	std::fprintf(m_pCsvFile, "frame");
+	for (const MetricInfo& info : g_kMetricInfo)
+		std::fprintf(m_pCsvFile, ",%s", info.m_pName);
+	std::fprintf(m_pCsvFile, "\n");
+
+	return true;
+}
+
+void MetricsRegistry::CloseCsv()
+{
+	if (m_pCsvFile)
+	{
+		std::fclose(m_pCsvFile);
+		m_pCsvFile = nullptr;
+	}
+}
+
+const char* MetricsRegistry::GetName(Metric metric)
+{
+	return g_kMetricInfo[(size_t)metric].m_pName;
+}
+
+bool MetricsRegistry::IsCounter(Metric metric)
+{
+	return g_kMetricInfo[(size_t)metric].m_isCounter;
+}
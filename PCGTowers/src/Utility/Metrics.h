@@ -0,0 +1,94 @@
+#pragma once
+
+#include <EASTL/array.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+
+/// <summary>
+/// Everything that is measured per frame.
+/// </summary>
+enum struct Metric : uint8_t
+{
+	kFrameTime,				// Milliseconds
+	kTickTime,				// Milliseconds spent simulating during the frame.
+	kTicks,					// Fixed steps simulated during the frame.
+	kEnemies,
+	kTurrets,
+	kAwakeTurrets,			// Turrets updated on the last tick.
+	kSleepingTurrets,		// Turrets skipped on the last tick. (See World::UpdateTurrets)
+	kTargetScans,			// Turrets that searched for a new target.
+	kDistanceTests,			// Enemy distances tested by those turrets.
+	kAllocations,			// Allocations made by the thread ending the frames, Including the overlay text whilst it is shown. Profiling builds only.
+	kRoundGenerationTime,	// Milliseconds the last round took to become playable.
+
+	kCount
+};
+
+/// <summary>
+/// Cheap per frame metrics, Values are plain doubles indexed by Metric.
+/// Counters are reset at the end of every frame, Gauges keep their value until they are set again.
+/// </summary>
+class MetricsRegistry
+{
+public:
+
+	static constexpr size_t kHistorySize = 240;
+
+	using Values = eastl::array<double, (size_t)Metric::kCount>;
+	using FrameTimes = eastl::array<float, kHistorySize>;
+
+private:
+
+	Values m_values;
+	Values m_lastFrame;
+
+	/// <summary>
+	/// Rolling window of frame times, m_frameCount % kHistorySize is the oldest entry once full.
+	/// </summary>
+	FrameTimes m_frameTimes;
+	uint64_t m_frameCount;
+
+	uint64_t m_allocationsAtFrameStart;
+
+	std::FILE* m_pCsvFile;
+
+public:
+
+	MetricsRegistry();
+	~MetricsRegistry();
+
+	MetricsRegistry(const MetricsRegistry&) = delete;
+	MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+	void Add(Metric metric, double value) { m_values[(size_t)metric] += value; }
+	void Set(Metric metric, double value) { m_values[(size_t)metric] = value; }
+
+	/// <summary>
+	/// Value of the last finished frame.
+	/// </summary>
+	double Get(Metric metric) const { return m_lastFrame[(size_t)metric]; }
+
+	/// <summary>
+	/// Closes the frame, Records its history and CSV row and resets the counters.
+	/// </summary>
+	void EndFrame();
+
+	/// <summary>
+	/// Frame time at percentile [percentile] (0-100) over the history.
+	/// </summary>
+	float GetFrameTimePercentile(float percentile) const;
+
+	const FrameTimes& GetFrameTimes() const { return m_frameTimes; }
+	uint64_t GetFrameCount() const { return m_frameCount; }
+
+	/// <summary>
+	/// Writes a row for every following frame to [pPath].
+	/// </summary>
+	bool OpenCsv(const char* pPath);
+	void CloseCsv();
+
+	static const char* GetName(Metric metric);
+	static bool IsCounter(Metric metric);
+};
@@ -0,0 +1,154 @@
+#include "Profiler.h"
+
+#if PCG_PROFILING
+
+#include <EASTL/vector.h>
+#include <EASTL/unique_ptr.h>
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+
+size_t ProfileBuffer::Read(ProfileEvent* pOut) const
+{
+	uint64_t end = m_writeIndex.load(std::memory_order_acquire);
+	uint64_t begin = end > kCapacity ? end - kCapacity : 0;
+
+	for (uint64_t i = begin; i < end; ++i)
+		pOut[i - begin] = m_events[i % kCapacity];
+
+	// Events the owner wrote over whilst we were copying are torn, Drop them.
+	uint64_t written = m_writeIndex.load(std::memory_order_acquire);
+	uint64_t firstIntact = written > kCapacity ? written - kCapacity : 0;
+	if (firstIntact <= begin)
+		return (size_t)(end - begin);
+
+	if (firstIntact >= end)
+		return 0;
+
+	size_t skip = (size_t)(firstIntact - begin);
+	for (size_t i = skip; i < (size_t)(end - begin); ++i)
+		pOut[i - skip] = pOut[i];
+
+	return (size_t)(end - firstIntact);
+}
+
+/// <summary>
+/// Owns the buffers of all threads, Buffers outlive their threads so short lived workers still end up in the trace.
+/// </summary>
+struct ProfileRegistry
+{
+	std::mutex m_mutex;
+	eastl::vector<eastl::unique_ptr<ProfileBuffer>> m_buffers;
+	eastl::vector<ProfileBuffer*> m_freeBuffers;
+
+	static ProfileRegistry& Get()
+	{
+		static ProfileRegistry s_registry;
+		return s_registry;
+	}
+
+	ProfileBuffer* Acquire()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if (!m_freeBuffers.empty())
+		{
+			ProfileBuffer* pBuffer = m_freeBuffers.back();
+			m_freeBuffers.pop_back();
+			pBuffer->SetThreadName(nullptr);
+			return pBuffer;
+		}
+
+		m_buffers.emplace_back(new ProfileBuffer((uint32_t)m_buffers.size()));
+		return m_buffers.back().get();
+	}
+
+	void Release(ProfileBuffer* pBuffer)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_freeBuffers.push_back(pBuffer);
+	}
+};
+
+/// <summary>
+/// Hands the buffer back to the registry when the thread exits.
+/// </summary>
+struct ThreadBufferHandle
+{
+	ProfileBuffer* m_pBuffer;
+
+	ThreadBufferHandle()
+		: m_pBuffer(ProfileRegistry::Get().Acquire())
+	{}
+
+	~ThreadBufferHandle()
+	{
+		ProfileRegistry::Get().Release(m_pBuffer);
+	}
+};
+
+static const std::chrono::steady_clock::time_point s_kStartTime = std::chrono::steady_clock::now();
+
+uint64_t Profiler::GetTime()
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_kStartTime).count();
+}
+
+ProfileBuffer& Profiler::GetThreadBuffer()
+{
+	static thread_local ThreadBufferHandle s_handle;
+	return *s_handle.m_pBuffer;
+}
+
+bool Profiler::WriteChromeTrace(const char* pPath)
+{
+	std::FILE* pFile = std::fopen(pPath, "w");
+	if (!pFile)
+		return false;
+
+	ProfileRegistry& registry = ProfileRegistry::Get();
+
+	eastl::vector<ProfileBuffer*> buffers;
+	{
+		std::lock_guard<std::mutex> lock(registry.m_mutex);
+		for (auto& pBuffer : registry.m_buffers)
+			buffers.push_back(pBuffer.get());
+	}
+
+	std::unique_ptr<ProfileEvent[]> pEvents(new ProfileEvent[ProfileBuffer::kCapacity]);
+
+	std::fprintf(pFile, "{\"traceEvents\":[\n");
+
+	bool isFirst = true;
+	for (ProfileBuffer* pBuffer : buffers)
+	{
+		const uint32_t kThreadId = pBuffer->GetId();
+
+		if (const char* pThreadName = pBuffer->GetThreadName())
+		{
+			std::fprintf(pFile, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"%s\"}}", isFirst ? "" : ",\n", kThreadId, pThreadName);
+			isFirst = false;
+		}
+
+		size_t count = pBuffer->Read(pEvents.get());
+		for (size_t i = 0; i < count; ++i)
+		{
+			const ProfileEvent& event = pEvents[i];
+
+			// Chrome expects microseconds.
+			std::fprintf(pFile, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+				isFirst ? "" : ",\n", event.m_pName, kThreadId, (double)event.m_start / 1000.0, (double)(event.m_end - event.m_start) / 1000.0);
+
+			isFirst = false;
+		}
+	}
+
+	std::fprintf(pFile, "\n],\"displayTimeUnit\":\"ms\"}\n");
+	std::fclose(pFile);
+
+	return true;
+}
+
+#endif
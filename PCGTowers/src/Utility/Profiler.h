@@ -0,0 +1,144 @@
+#pragma once
+
+/// <summary>
+/// Profiling zones are compiled into debug builds, Release builds only get them with premake's --profiling option.
+/// </summary>
+#if !defined(PCG_PROFILING) && _DEBUG
+	#define PCG_PROFILING 1
+#endif
+
+#if PCG_PROFILING
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+/// <summary>
+/// A finished zone, Timestamps are nanoseconds since the profiler started.
+/// </summary>
+struct ProfileEvent
+{
+	const char* m_pName;
+	uint64_t m_start;
+	uint64_t m_end;
+};
+
+/// <summary>
+/// Fixed size ring buffer of zones for a single thread.
+/// Only the owning thread writes, Readers detect and skip events that were overwritten whilst reading.
+/// </summary>
+class ProfileBuffer
+{
+public:
+
+	static constexpr size_t kCapacity = 1 << 14;
+
+private:
+
+	ProfileEvent m_events[kCapacity];
+
+	/// <summary>
+	/// Amount of events ever written, The next event goes to m_writeIndex % kCapacity.
+	/// </summary>
+	std::atomic<uint64_t> m_writeIndex;
+
+	/// <summary>
+	/// Identifies the buffer in the trace, Buffers of finished threads are handed to new threads.
+	/// </summary>
+	uint32_t m_id;
+
+	const char* m_pThreadName;
+
+public:
+
+	ProfileBuffer(uint32_t id)
+		: m_writeIndex(0)
+		, m_id(id)
+		, m_pThreadName(nullptr)
+	{}
+
+	void Write(const char* pName, uint64_t start, uint64_t end)
+	{
+		uint64_t index = m_writeIndex.load(std::memory_order_relaxed);
+		m_events[index % kCapacity] = { pName, start, end };
+		m_writeIndex.store(index + 1, std::memory_order_release);
+	}
+
+	/// <summary>
+	/// Copies the events that are still in the buffer into [pOut], Returns the amount copied.
+	/// [pOut] must be able to hold kCapacity events.
+	/// </summary>
+	size_t Read(ProfileEvent* pOut) const;
+
+	uint32_t GetId() const { return m_id; }
+
+	void SetThreadName(const char* pName) { m_pThreadName = pName; }
+	const char* GetThreadName() const { return m_pThreadName; }
+};
+
+/// <summary>
+/// Collects the zones of all threads and writes them out as a Chrome trace (chrome://tracing or ui.perfetto.dev).
+/// </summary>
+class Profiler
+{
+public:
+
+	/// <summary>
+	/// Nanoseconds since the profiler started.
+	/// </summary>
+	static uint64_t GetTime();
+
+	/// <summary>
+	/// Buffer of the calling thread, Created or recycled the first time a thread records a zone.
+	/// </summary>
+	static ProfileBuffer& GetThreadBuffer();
+
+	/// <summary>
+	/// Names the calling thread in the trace, [pName] must outlive the profiler.
+	/// </summary>
+	static void SetThreadName(const char* pName) { GetThreadBuffer().SetThreadName(pName); }
+
+	/// <summary>
+	/// Writes the zones of all threads in Chrome's trace_event format.
+	/// </summary>
+	static bool WriteChromeTrace(const char* pPath);
+};
+
+/// <summary>
+/// Records the time between its construction and destruction into the thread's buffer.
+/// </summary>
+class ProfileZone
+{
+	const char* m_pName;
+	uint64_t m_start;
+
+public:
+
+	ProfileZone(const char* pName)
+		: m_pName(pName)
+		, m_start(Profiler::GetTime())
+	{}
+
+	~ProfileZone()
+	{
+		Profiler::GetThreadBuffer().Write(m_pName, m_start, Profiler::GetTime());
+	}
+
+	ProfileZone(const ProfileZone&) = delete;
+	ProfileZone& operator=(const ProfileZone&) = delete;
+};
+
+#define PCG_PROFILE_CONCAT_IMPL(a, b) a##b
+#define PCG_PROFILE_CONCAT(a, b) PCG_PROFILE_CONCAT_IMPL(a, b)
+
+#define PCG_PROFILE_ZONE(name) ProfileZone PCG_PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PCG_PROFILE_FUNCTION() PCG_PROFILE_ZONE(__FUNCTION__)
+#define PCG_PROFILE_THREAD(name) Profiler::SetThreadName(name)
+
+#else
+
+#define PCG_PROFILE_ZONE(name) ((void)0)
+#define PCG_PROFILE_FUNCTION() ((void)0)
+#define PCG_PROFILE_THREAD(name) ((void)0)
+
+#endif
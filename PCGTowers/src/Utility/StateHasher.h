@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+
+/// <summary>
+/// FNV-1a hash over raw state, Used to compare simulation state across runs and thread counts.
+/// </summary>
+class StateHasher
+{
+	static constexpr uint64_t kOffsetBasis = 14695981039346656037ull;
+	static constexpr uint64_t kPrime = 1099511628211ull;
+
+	uint64_t m_hash;
+
+public:
+
+	StateHasher()
+		: m_hash(kOffsetBasis)
+	{}
+
+	void AddBytes(const void* pData, size_t size)
+	{
+		const unsigned char* pBytes = static_cast<const unsigned char*>(pData);
+		for (size_t i = 0; i < size; ++i)
+		{
+			m_hash ^= pBytes[i];
+			m_hash *= kPrime;
+		}
+	}
+
+	/// <summary>
+	/// Adds the bytes of [value], Types with padding must be added member by member.
+	/// </summary>
+	template<typename Type>
+	void Add(const Type& value)
+	{
+		static_assert(std::is_trivially_copyable_v<Type>, "Only trivially copyable types can be hashed directly.");
+		AddBytes(&value, sizeof(Type));
+	}
+
+	uint64_t GetHash() const { return m_hash; }
+};
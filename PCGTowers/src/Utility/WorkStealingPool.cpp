@@ -0,0 +1,164 @@
+#include "WorkStealingPool.h"
+
+#include <Utility/Profiler.h>
+
+#include <EASTL/algorithm.h>
+
+// Pool and queue of the calling thread, Lets Submit push onto the queue of the worker it is called from.
+static thread_local const WorkStealingPool* s_pCurrentPool = nullptr;
+static thread_local size_t s_currentQueue = 0;
+
+void WorkStealingPool::Start(size_t threadCount)
+{
+	Stop();
+
+	threadCount = eastl::max<size_t>(threadCount, 1);
+
+	m_isStopping = false;
+	m_stealCount = 0;
+
+	for (size_t i = 0; i < threadCount; ++i)
+		m_queues.emplace_back(new Queue());
+
+	m_workers.reserve(threadCount - 1);
+	for (size_t i = 0; i < threadCount - 1; ++i)
+		m_workers.emplace_back([this, i]() { RunWorker(i); });
+}
+
+void WorkStealingPool::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_wakeMutex);
+		m_isStopping = true;
+	}
+	m_wakeCondition.notify_all();
+
+	for (std::thread& worker : m_workers)
+		worker.join();
+
+	m_workers.clear();
+	m_queues.clear();
+	m_pendingCount = 0;
+	m_queuedCount = 0;
+}
+
+void WorkStealingPool::Submit(Task&& task)
+{
+	size_t index = s_pCurrentPool == this ? s_currentQueue : m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+
+	m_pendingCount.fetch_add(1);
+
+	// Counted under the wake lock, So a thread that just found every queue empty can't miss it.
+	// Counted before the task is pushed as well, Otherwise a thread could take it and count it off first.
+	{
+		std::lock_guard<std::mutex> lock(m_wakeMutex);
+		m_queuedCount.fetch_add(1);
+	}
+
+	{
+		Queue& queue = *m_queues[index];
+		std::lock_guard<std::mutex> lock(queue.m_mutex);
+		queue.m_tasks.push_back(eastl::move(task));
+	}
+	m_wakeCondition.notify_one();
+}
+
+void WorkStealingPool::Wait()
+{
+	PCG_PROFILE_ZONE("WorkStealingPool::Wait");
+
+	const WorkStealingPool* pPreviousPool = s_pCurrentPool;
+	size_t previousQueue = s_currentQueue;
+
+	s_pCurrentPool = this;
+	s_currentQueue = m_queues.size() - 1;
+
+	Task task;
+	while (m_pendingCount.load() > 0)
+	{
+		if (TryTakeTask(s_currentQueue, task))
+		{
+			RunTask(task);
+			continue;
+		}
+
+		// Everything left is running on the workers.
+		std::unique_lock<std::mutex> lock(m_wakeMutex);
+		m_wakeCondition.wait(lock, [this]() { return m_pendingCount.load() == 0 || m_queuedCount.load() > 0; });
+	}
+
+	s_pCurrentPool = pPreviousPool;
+	s_currentQueue = previousQueue;
+}
+
+void WorkStealingPool::RunWorker(size_t index)
+{
+	PCG_PROFILE_THREAD("Pool Worker");
+
+	s_pCurrentPool = this;
+	s_currentQueue = index;
+
+	Task task;
+	while (true)
+	{
+		if (TryTakeTask(index, task))
+		{
+			RunTask(task);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_wakeMutex);
+		m_wakeCondition.wait(lock, [this]() { return m_isStopping || m_queuedCount.load() > 0; });
+
+		if (m_isStopping)
+			return;
+	}
+}
+
+bool WorkStealingPool::TryTakeTask(size_t index, Task& task)
+{
+	const size_t kQueueCount = m_queues.size();
+
+	// Own queue first, Newest task so whatever it works on is still in the cache.
+	{
+		Queue& queue = *m_queues[index];
+		std::lock_guard<std::mutex> lock(queue.m_mutex);
+		if (!queue.m_tasks.empty())
+		{
+			task = eastl::move(queue.m_tasks.back());
+			queue.m_tasks.pop_back();
+			m_queuedCount.fetch_sub(1);
+			return true;
+		}
+	}
+
+	// Steal the oldest task of the next busy queue, Those are the least likely to be touched by their owner soon.
+	for (size_t offset = 1; offset < kQueueCount; ++offset)
+	{
+		Queue& queue = *m_queues[(index + offset) % kQueueCount];
+		std::lock_guard<std::mutex> lock(queue.m_mutex);
+		if (!queue.m_tasks.empty())
+		{
+			task = eastl::move(queue.m_tasks.front());
+			queue.m_tasks.pop_front();
+			m_queuedCount.fetch_sub(1);
+			m_stealCount.fetch_add(1, std::memory_order_relaxed);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void WorkStealingPool::RunTask(Task& task)
+{
+	task();
+	task = nullptr;
+
+	// Wakes the thread waiting for the last task.
+	if (m_pendingCount.fetch_sub(1) == 1)
+	{
+		std::lock_guard<std::mutex> lock(m_wakeMutex);
+		m_wakeCondition.notify_all();
+	}
+}
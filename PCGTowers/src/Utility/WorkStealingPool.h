@@ -0,0 +1,111 @@
+#pragma once
+
+#include <EASTL/deque.h>
+#include <EASTL/functional.h>
+#include <EASTL/unique_ptr.h>
+#include <EASTL/vector.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/// <summary>
+/// Runs tasks on a fixed set of threads, Every thread has its own queue and steals from the others once it runs dry.
+/// Tasks submitted from a worker go to that worker's queue, So a task that keeps resubmitting itself tends to stay on the same thread.
+/// The thread that waits for the tasks helps run them, So [threadCount] threads do the work in total.
+/// </summary>
+class WorkStealingPool
+{
+public:
+
+	using Task = eastl::function<void()>;
+
+private:
+
+	struct Queue
+	{
+		std::mutex m_mutex;
+		eastl::deque<Task> m_tasks;
+	};
+
+	/// <summary>
+	/// One queue per thread, The last one belongs to the thread that waits.
+	/// </summary>
+	eastl::vector<eastl::unique_ptr<Queue>> m_queues;
+	eastl::vector<std::thread> m_workers;
+
+	/// <summary>
+	/// Tasks that were submitted and haven't finished yet.
+	/// </summary>
+	std::atomic<size_t> m_pendingCount;
+
+	/// <summary>
+	/// Tasks sitting in a queue, Idle workers sleep whilst there are none.
+	/// </summary>
+	std::atomic<size_t> m_queuedCount;
+
+	/// <summary>
+	/// Queue Submit uses next when called from outside the pool.
+	/// </summary>
+	std::atomic<size_t> m_nextQueue;
+
+	std::atomic<size_t> m_stealCount;
+
+	bool m_isStopping;
+	std::mutex m_wakeMutex;
+	std::condition_variable m_wakeCondition;
+
+public:
+
+	WorkStealingPool()
+		: m_pendingCount(0)
+		, m_queuedCount(0)
+		, m_nextQueue(0)
+		, m_stealCount(0)
+		, m_isStopping(false)
+	{}
+
+	~WorkStealingPool() { Stop(); }
+
+	WorkStealingPool(const WorkStealingPool&) = delete;
+	WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+	/// <summary>
+	/// Starts [threadCount] - 1 workers, The thread calling Wait is the last one.
+	/// </summary>
+	void Start(size_t threadCount);
+
+	/// <summary>
+	/// Stops the workers once they finished their current task, Tasks still queued are dropped.
+	/// </summary>
+	void Stop();
+
+	void Submit(Task&& task);
+
+	/// <summary>
+	/// Runs tasks until every submitted task, And every task those submitted, has finished.
+	/// </summary>
+	void Wait();
+
+	size_t GetThreadCount() const { return m_queues.size(); }
+
+	/// <summary>
+	/// Tasks a thread took from the queue of another thread, Since Start.
+	/// </summary>
+	size_t GetStealCount() const { return m_stealCount.load(std::memory_order_relaxed); }
+
+private:
+
+	void RunWorker(size_t index);
+
+	/// <summary>
+	/// Takes the newest task of queue [index], Or the oldest task of any other queue. False if every queue is empty.
+	/// </summary>
+	bool TryTakeTask(size_t index, Task& task);
+
+	/// <summary>
+	/// Runs [task] and marks it finished.
+	/// </summary>
+	void RunTask(Task& task);
+};
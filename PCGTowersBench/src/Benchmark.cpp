@@ -0,0 +1,355 @@
+#include "Benchmark.h"
+
+#include <EASTL/algorithm.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <regex>
+#include <thread>
+
+/// <summary>
+/// Upper bound on the iterations of a single run.
+/// </summary>
+static constexpr size_t g_kMaxIterations = 1000000000;
+
+//
+// BenchmarkState
+//
+
+bool BenchmarkState::KeepRunning()
+{
+	if (m_iterations == 0 && !m_isTiming)
+		ResumeTiming();
+
+	if (m_iterations < m_maxIterations)
+	{
+		++m_iterations;
+		return true;
+	}
+
+	PauseTiming();
+	return false;
+}
+
+void BenchmarkState::PauseTiming()
+{
+	if (!m_isTiming)
+		return;
+
+	std::chrono::duration<double> elapsed = Clock::now() - m_realStart;
+	m_realTime += elapsed.count();
+	m_cpuTime += (double)(std::clock() - m_cpuStart) / CLOCKS_PER_SEC;
+	m_isTiming = false;
+}
+
+void BenchmarkState::ResumeTiming()
+{
+	if (m_isTiming)
+		return;
+
+	m_isTiming = true;
+	m_cpuStart = std::clock();
+	m_realStart = Clock::now();
+}
+
+void BenchmarkState::SetCounter(const char* pName, double value)
+{
+	for (auto& counter : m_counters)
+	{
+		if (counter.first == pName)
+		{
+			counter.second = value;
+			return;
+		}
+	}
+
+	m_counters.emplace_back(pName, value);
+}
+
+//
+// Benchmark
+//
+
+Benchmark* Benchmark::ArgNames(std::initializer_list<const char*> names)
+{
+	m_argNames.clear();
+	for (const char* pName : names)
+		m_argNames.emplace_back(pName);
+
+	return this;
+}
+
+Benchmark* Benchmark::Args(std::initializer_list<int64_t> args)
+{
+	m_argSets.emplace_back(args.begin(), args.end());
+	return this;
+}
+
+Benchmark* Benchmark::ArgsProduct(std::initializer_list<std::initializer_list<int64_t>> values)
+{
+	eastl::vector<eastl::vector<int64_t>> product(1);
+
+	for (const auto& argValues : values)
+	{
+		eastl::vector<eastl::vector<int64_t>> next;
+		for (const auto& prefix : product)
+		{
+			for (int64_t value : argValues)
+			{
+				next.push_back(prefix);
+				next.back().push_back(value);
+			}
+		}
+
+		product = eastl::move(next);
+	}
+
+	for (auto& args : product)
+		m_argSets.emplace_back(eastl::move(args));
+
+	return this;
+}
+
+eastl::string Benchmark::GetRunName(size_t index) const
+{
+	eastl::string name = m_name;
+
+	const auto& args = m_argSets[index];
+	for (size_t i = 0; i < args.size(); ++i)
+	{
+		name += "/";
+
+		if (i < m_argNames.size())
+			name += m_argNames[i] + ":";
+
+		name += eastl::to_string(args[i]);
+	}
+
+	return name;
+}
+
+//
+// BenchmarkRunner
+//
+
+BenchmarkRunner::~BenchmarkRunner()
+{
+	for (Benchmark* pBenchmark : m_benchmarks)
+		delete pBenchmark;
+}
+
+BenchmarkRunner& BenchmarkRunner::Get()
+{
+	static BenchmarkRunner s_runner;
+	return s_runner;
+}
+
+Benchmark* BenchmarkRunner::Register(const char* pName, BenchmarkFunction function)
+{
+	Benchmark* pBenchmark = new Benchmark(pName, function);
+	m_benchmarks.emplace_back(pBenchmark);
+	return pBenchmark;
+}
+
+bool BenchmarkRunner::ParseArguments(int argc, char** argv)
+{
+	auto matchOption = [](const char* pArg, const char* pOption) -> const char*
+	{
+		size_t length = std::strlen(pOption);
+		if (std::strncmp(pArg, pOption, length) == 0 && pArg[length] == '=')
+			return pArg + length + 1;
+
+		return nullptr;
+	};
+
+	for (int i = 0; i < argc; ++i)
+	{
+		const char* pArg = argv[i];
+		const char* pValue = nullptr;
+
+		if ((pValue = matchOption(pArg, "--benchmark_filter")))
+			m_filter = pValue;
+		else if ((pValue = matchOption(pArg, "--benchmark_out")))
+			m_outPath = pValue;
+		else if ((pValue = matchOption(pArg, "--benchmark_min_time")))
+			m_minTime = std::strtod(pValue, nullptr);
+		else if ((pValue = matchOption(pArg, "--benchmark_repetitions")))
+			m_repetitions = eastl::max<size_t>(1, (size_t)std::strtoul(pValue, nullptr, 10));
+		else if ((pValue = matchOption(pArg, "--benchmark_format")))
+			m_isJsonOutput = std::strcmp(pValue, "json") == 0;
+		else if (std::strcmp(pArg, "--benchmark_list_tests") == 0)
+			m_isListOnly = true;
+		else
+		{
+			std::fprintf(stderr, "Unknown argument: %s\n", pArg);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int BenchmarkRunner::Run()
+{
+	std::regex filter(m_filter.empty() ? "." : m_filter.c_str());
+
+	Results results;
+
+	if (!m_isJsonOutput && !m_isListOnly)
+		std::printf("%-64s %15s %15s %12s\n", "Benchmark", "Time (ns)", "CPU (ns)", "Iterations");
+
+	for (const Benchmark* pBenchmark : m_benchmarks)
+	{
+		// Benchmarks without arguments run once without any.
+		size_t argSetCount = eastl::max<size_t>(1, pBenchmark->GetArgSets().size());
+
+		for (size_t argSet = 0; argSet < argSetCount; ++argSet)
+		{
+			eastl::string runName = pBenchmark->GetArgSets().empty() ? pBenchmark->GetName() : pBenchmark->GetRunName(argSet);
+			if (!std::regex_search(runName.c_str(), filter))
+				continue;
+
+			if (m_isListOnly)
+			{
+				std::printf("%s\n", runName.c_str());
+				continue;
+			}
+
+			for (size_t repetition = 0; repetition < m_repetitions; ++repetition)
+			{
+				Result result = RunBenchmark(*pBenchmark, argSet, repetition);
+				result.m_runName = runName;
+
+				if (!m_isJsonOutput)
+					PrintResult(result);
+
+				results.emplace_back(eastl::move(result));
+			}
+		}
+	}
+
+	if (m_isListOnly)
+		return 0;
+
+	int exitCode = 0;
+
+	if (m_isJsonOutput && !WriteJson(results, nullptr))
+		exitCode = 1;
+
+	if (!m_outPath.empty() && !WriteJson(results, m_outPath.c_str()))
+	{
+		std::fprintf(stderr, "Failed to write %s\n", m_outPath.c_str());
+		exitCode = 1;
+	}
+
+	return exitCode;
+}
+
+BenchmarkRunner::Result BenchmarkRunner::RunBenchmark(const Benchmark& benchmark, size_t argSet, size_t repetition) const
+{
+	static const eastl::vector<int64_t> s_kNoArgs;
+	const eastl::vector<int64_t>& args = benchmark.GetArgSets().empty() ? s_kNoArgs : benchmark.GetArgSets()[argSet];
+
+	size_t iterations = 1;
+
+	for (;;)
+	{
+		BenchmarkState state(args, iterations);
+		benchmark.GetFunction()(state);
+
+		// Stop growing once the run was long enough.
+		const double kTime = state.GetRealTime();
+		if (kTime >= m_minTime || iterations >= g_kMaxIterations)
+		{
+			Result result;
+			result.m_name = benchmark.GetName();
+			result.m_repetitionIndex = repetition;
+			result.m_iterations = state.GetIterations();
+			result.m_realTime = state.GetRealTime() * 1e9 / (double)result.m_iterations;
+			result.m_cpuTime = state.GetCpuTime() * 1e9 / (double)result.m_iterations;
+			result.m_itemsPerSecond = state.GetItemsProcessed() > 0 && kTime > 0.0 ? (double)state.GetItemsProcessed() / kTime : 0.0;
+			result.m_counters = state.GetCounters();
+			return result;
+		}
+
+		// Predict the iterations needed with some headroom, But never grow more than 10x at once.
+		double multiplier = kTime > 0.0 ? (m_minTime * 1.4) / kTime : 10.0;
+		multiplier = eastl::min(10.0, eastl::max(multiplier, 2.0));
+		iterations = eastl::min(g_kMaxIterations, (size_t)std::ceil((double)iterations * multiplier));
+	}
+}
+
+void BenchmarkRunner::PrintResult(const Result& result) const
+{
+	std::printf("%-64s %15.0f %15.0f %12zu", result.m_runName.c_str(), result.m_realTime, result.m_cpuTime, result.m_iterations);
+
+	if (result.m_itemsPerSecond > 0.0)
+		std::printf(" items_per_second=%.4g/s", result.m_itemsPerSecond);
+
+	for (const auto& counter : result.m_counters)
+		std::printf(" %s=%.4g", counter.first.c_str(), counter.second);
+
+	std::printf("\n");
+}
+
+bool BenchmarkRunner::WriteJson(const Results& results, const char* pPath) const
+{
+	std::FILE* pFile = pPath ? std::fopen(pPath, "w") : stdout;
+	if (!pFile)
+		return false;
+
+	char date[64] = {};
+	std::time_t now = std::time(nullptr);
+	std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+#if _DEBUG
+	const char* pBuildType = "debug";
+#else
+	const char* pBuildType = "release";
+#endif
+
+	std::fprintf(pFile, "{\n");
+	std::fprintf(pFile, "  \"context\": {\n");
+	std::fprintf(pFile, "    \"date\": \"%s\",\n", date);
+	std::fprintf(pFile, "    \"executable\": \"PCGTowersBench\",\n");
+	std::fprintf(pFile, "    \"num_cpus\": %u,\n", std::thread::hardware_concurrency());
+	std::fprintf(pFile, "    \"library_build_type\": \"%s\"\n", pBuildType);
+	std::fprintf(pFile, "  },\n");
+	std::fprintf(pFile, "  \"benchmarks\": [\n");
+
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		const Result& result = results[i];
+
+		std::fprintf(pFile, "    {\n");
+		std::fprintf(pFile, "      \"name\": \"%s\",\n", result.m_runName.c_str());
+		std::fprintf(pFile, "      \"family_name\": \"%s\",\n", result.m_name.c_str());
+		std::fprintf(pFile, "      \"run_name\": \"%s\",\n", result.m_runName.c_str());
+		std::fprintf(pFile, "      \"run_type\": \"iteration\",\n");
+		std::fprintf(pFile, "      \"repetitions\": %zu,\n", m_repetitions);
+		std::fprintf(pFile, "      \"repetition_index\": %zu,\n", result.m_repetitionIndex);
+		std::fprintf(pFile, "      \"threads\": 1,\n");
+		std::fprintf(pFile, "      \"iterations\": %zu,\n", result.m_iterations);
+		std::fprintf(pFile, "      \"real_time\": %.6f,\n", result.m_realTime);
+		std::fprintf(pFile, "      \"cpu_time\": %.6f,\n", result.m_cpuTime);
+
+		if (result.m_itemsPerSecond > 0.0)
+			std::fprintf(pFile, "      \"items_per_second\": %.6f,\n", result.m_itemsPerSecond);
+
+		for (const auto& counter : result.m_counters)
+			std::fprintf(pFile, "      \"%s\": %.6f,\n", counter.first.c_str(), counter.second);
+
+		std::fprintf(pFile, "      \"time_unit\": \"ns\"\n");
+		std::fprintf(pFile, "    }%s\n", i + 1 < results.size() ? "," : "");
+	}
+
+	std::fprintf(pFile, "  ]\n");
+	std::fprintf(pFile, "}\n");
+
+	if (pPath)
+		std::fclose(pFile);
+
+	return true;
+}
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <EASTL/vector.h>
+#include <EASTL/string.h>
+#include <EASTL/utility.h>
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <initializer_list>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/// <summary>
+/// Keeps the compiler from optimizing away [value] and the work that produced it.
+/// </summary>
+template<typename T>
+inline void DoNotOptimize(const T& value)
+{
+#if defined(_MSC_VER)
+	const volatile char* pValue = reinterpret_cast<const volatile char*>(&value);
+	(void)*pValue;
+	_ReadWriteBarrier();
+#else
+	asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+/// <summary>
+/// State of a single benchmark run, Passed to the benchmark function.
+/// Usage:
+/// 
+///		while (state.KeepRunning())
+///		{
+///			// Measured work
+///		}
+/// </summary>
+class BenchmarkState
+{
+	using Clock = std::chrono::steady_clock;
+
+	const eastl::vector<int64_t>& m_args;
+
+	size_t m_iterations;
+	size_t m_maxIterations;
+
+	Clock::time_point m_realStart;
+	std::clock_t m_cpuStart;
+
+	double m_realTime;	// Seconds
+	double m_cpuTime;	// Seconds
+	bool m_isTiming;
+
+	int64_t m_itemsProcessed;
+
+public:
+
+	using Counters = eastl::vector<eastl::pair<eastl::string, double>>;
+
+private:
+
+	Counters m_counters;
+
+public:
+
+	BenchmarkState(const eastl::vector<int64_t>& args, size_t maxIterations)
+		: m_args(args)
+		, m_iterations(0)
+		, m_maxIterations(maxIterations)
+		, m_cpuStart(0)
+		, m_realTime(0.0)
+		, m_cpuTime(0.0)
+		, m_isTiming(false)
+		, m_itemsProcessed(0)
+	{}
+
+	/// <summary>
+	/// Returns true whilst there are iterations left to run, Starts the timer on the first call.
+	/// </summary>
+	bool KeepRunning();
+
+	/// <summary>
+	/// Stops the timer, Use around setup work that shouldn't be measured.
+	/// </summary>
+	void PauseTiming();
+	void ResumeTiming();
+
+	int64_t GetArg(size_t index) const { return m_args[index]; }
+
+	size_t GetIterations() const { return m_iterations; }
+	size_t GetMaxIterations() const { return m_maxIterations; }
+
+	void SetItemsProcessed(int64_t items) { m_itemsProcessed = items; }
+	int64_t GetItemsProcessed() const { return m_itemsProcessed; }
+
+	/// <summary>
+	/// Reports an extra value alongside the timings.
+	/// </summary>
+	void SetCounter(const char* pName, double value);
+	const Counters& GetCounters() const { return m_counters; }
+
+	double GetRealTime() const { return m_realTime; }
+	double GetCpuTime() const { return m_cpuTime; }
+};
+
+using BenchmarkFunction = void(*)(BenchmarkState&);
+
+/// <summary>
+/// A registered benchmark function and the sets of arguments it is run with.
+/// </summary>
+class Benchmark
+{
+	eastl::string m_name;
+	BenchmarkFunction m_function;
+
+	eastl::vector<eastl::string> m_argNames;
+	eastl::vector<eastl::vector<int64_t>> m_argSets;
+
+public:
+
+	Benchmark(const char* pName, BenchmarkFunction function)
+		: m_name(pName)
+		, m_function(function)
+	{}
+
+	/// <summary>
+	/// Names the arguments, Used in the run names. (Name/mapSize:45/enemies:100)
+	/// </summary>
+	Benchmark* ArgNames(std::initializer_list<const char*> names);
+
+	/// <summary>
+	/// Adds a set of arguments to run the benchmark with.
+	/// </summary>
+	Benchmark* Args(std::initializer_list<int64_t> args);
+
+	/// <summary>
+	/// Adds the cartesian product of the given argument values.
+	/// </summary>
+	Benchmark* ArgsProduct(std::initializer_list<std::initializer_list<int64_t>> values);
+
+	const eastl::string& GetName() const { return m_name; }
+	BenchmarkFunction GetFunction() const { return m_function; }
+	const eastl::vector<eastl::vector<int64_t>>& GetArgSets() const { return m_argSets; }
+
+	/// <summary>
+	/// Name of the run with the [index]th set of arguments.
+	/// </summary>
+	eastl::string GetRunName(size_t index) const;
+};
+
+/// <summary>
+/// Runs the registered benchmarks and reports them in the Google Benchmark JSON format.
+/// Usage: PCGTowersBench [--benchmark_filter=regex] [--benchmark_min_time=seconds] [--benchmark_repetitions=n]
+///						  [--benchmark_format=console|json] [--benchmark_out=file.json] [--benchmark_list_tests]
+/// </summary>
+class BenchmarkRunner
+{
+	using Benchmarks = eastl::vector<Benchmark*>;
+	Benchmarks m_benchmarks;
+
+	eastl::string m_filter;
+	eastl::string m_outPath;
+	double m_minTime;
+	size_t m_repetitions;
+	bool m_isJsonOutput;
+	bool m_isListOnly;
+
+	struct Result
+	{
+		eastl::string m_name;
+		eastl::string m_runName;
+		size_t m_repetitionIndex;
+		size_t m_iterations;
+		double m_realTime;	// Nanoseconds per iteration.
+		double m_cpuTime;	// Nanoseconds per iteration.
+		double m_itemsPerSecond;
+		BenchmarkState::Counters m_counters;
+	};
+
+	using Results = eastl::vector<Result>;
+
+	BenchmarkRunner()
+		: m_minTime(0.5)
+		, m_repetitions(1)
+		, m_isJsonOutput(false)
+		, m_isListOnly(false)
+	{}
+
+public:
+
+	~BenchmarkRunner();
+
+	static BenchmarkRunner& Get();
+
+	Benchmark* Register(const char* pName, BenchmarkFunction function);
+
+	/// <summary>
+	/// Returns false if an argument wasn't recognized.
+	/// </summary>
+	bool ParseArguments(int argc, char** argv);
+
+	/// <summary>
+	/// Runs all benchmarks that pass the filter, Returns the exit code.
+	/// </summary>
+	int Run();
+
+private:
+
+	/// <summary>
+	/// Grows the iteration count until a run takes at least the minimum time.
+	/// </summary>
+	Result RunBenchmark(const Benchmark& benchmark, size_t argSet, size_t repetition) const;
+
+	void PrintResult(const Result& result) const;
+	bool WriteJson(const Results& results, const char* pPath) const;
+};
+
+#define PCG_BENCHMARK_CONCAT_IMPL(a, b) a##b
+#define PCG_BENCHMARK_CONCAT(a, b) PCG_BENCHMARK_CONCAT_IMPL(a, b)
+
+/// <summary>
+/// Registers a benchmark function, Chain ->Args({...}) to add argument sets.
+/// </summary>
+#define PCG_BENCHMARK(function) \
+	static Benchmark* PCG_BENCHMARK_CONCAT(s_pBenchmark, __LINE__) = BenchmarkRunner::Get().Register(#function, function)
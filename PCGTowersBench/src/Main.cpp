@@ -0,0 +1,19 @@
+#include "Benchmark.h"
+
+/// <summary>
+/// Micro benchmarks for the generators and the hot loops of the game.
+/// Run from the PCGTowers directory so the generators can find their assets, e.g:
+/// 
+///		PCGTowersBench --benchmark_out=bench.json --benchmark_filter=MapGenerator
+/// 
+/// The JSON output follows the Google Benchmark format, So runs of different commits can be compared with its tools/compare.py.
+/// </summary>
+int main(int argc, char** argv)
+{
+	BenchmarkRunner& runner = BenchmarkRunner::Get();
+
+	if (!runner.ParseArguments(argc - 1, argv + 1))
+		return 1;
+
+	return runner.Run();
+}
@@ -0,0 +1,357 @@
+#include "Benchmark.h"
+
+#include <Config.h>
+
+#include <Game/Generators/MapGenerator.h>
+#include <Game/Generators/PathHierarchy.h>
+#include <Game/TowerDefense/TDTilemap.h>
+#include <Game/TowerDefense/MazePlanner.h>
+
+#include <cstdio>
+
+static constexpr unsigned int g_kBenchSeed = 1337;
+
+/// <summary>
+/// Exposes the internals of the map generator to the benchmarks.
+/// </summary>
+class BenchMapGenerator : public MapGenerator
+{
+public:
+
+	using MapGenerator::GeneratePath;
+	using MapGenerator::GrowRivers;
+	using MapGenerator::m_pathHierarchy;
+	using MapGenerator::m_pathSearchCount;
+};
+
+/// <summary>
+/// Generator shared by all map benchmarks, Init loads the biome lookup from the working directory.
+/// </summary>
+static BenchMapGenerator& GetMapGenerator()
+{
+	static BenchMapGenerator s_generator;
+	static bool s_isInitialized = false;
+
+	if (!s_isInitialized)
+	{
+		if (!s_generator.Init())
+			std::fprintf(stderr, "Failed to load biome_data.png, Run the benchmarks from the PCGTowers directory.\n");
+
+		s_isInitialized = true;
+	}
+
+	return s_generator;
+}
+
+static void InitTilemap(TDTilemap& tilemap, int64_t mapSize)
+{
+	tilemap.Init({ (unsigned int)mapSize, (unsigned int)mapSize }, { g_kTileSize, g_kTileSize });
+}
+
+static void CopyTilemap(const TDTilemap& from, TDTilemap& to)
+{
+	const dragon::Vector2u kMapSize = from.GetSize();
+	const size_t kTileCount = (size_t)kMapSize.x * (size_t)kMapSize.y;
+
+	for (size_t i = 0; i < kTileCount; ++i)
+	{
+		to.SetTileAtIndex(i, from.GetTileAtIndex(i));
+		to.GetTileDataAtIndex(i) = from.GetTileDataAtIndex(i);
+	}
+}
+
+static void MapGenerator_Generate(BenchmarkState& state)
+{
+	const int64_t kMapSize = state.GetArg(0);
+
+	BenchMapGenerator& generator = GetMapGenerator();
+
+	TDTilemap tilemap;
+	InitTilemap(tilemap, kMapSize);
+
+	unsigned int seed = g_kBenchSeed;
+	while (state.KeepRunning())
+	{
+		generator.Generate(tilemap, seed++);
+		DoNotOptimize(tilemap.GetTileAtIndex(0));
+	}
+
+	state.SetItemsProcessed((int64_t)state.GetIterations() * kMapSize * kMapSize);
+}
+PCG_BENCHMARK(MapGenerator_Generate)->ArgNames({ "mapSize" })->Args({ 32 })->Args({ (int64_t)g_kMapSize })->Args({ 64 })->Args({ 128 })->Args({ 256 });
+
+static void MapGenerator_GrowRivers(BenchmarkState& state)
+{
+	const int64_t kMapSize = state.GetArg(0);
+
+	BenchMapGenerator& generator = GetMapGenerator();
+
+	TDTilemap source;
+	InitTilemap(source, kMapSize);
+	generator.Generate(source, g_kBenchSeed);
+
+	TDTilemap tilemap;
+	InitTilemap(tilemap, kMapSize);
+
+	while (state.KeepRunning())
+	{
+		// Rivers keep growing, So every iteration starts from the same map.
+		state.PauseTiming();
+		CopyTilemap(source, tilemap);
+		state.ResumeTiming();
+
+		generator.GrowRivers(tilemap);
+		DoNotOptimize(tilemap.GetTileAtIndex(0));
+	}
+
+	state.SetItemsProcessed((int64_t)state.GetIterations() * kMapSize * kMapSize);
+}
+PCG_BENCHMARK(MapGenerator_GrowRivers)->ArgNames({ "mapSize" })->Args({ 32 })->Args({ (int64_t)g_kMapSize })->Args({ 64 })->Args({ 128 })->Args({ 256 });
+
+static void MapGenerator_GrowRiversRegion(BenchmarkState& state)
+{
+	const int64_t kMapSize = state.GetArg(0);
+
+	BenchMapGenerator& generator = GetMapGenerator();
+
+	TDTilemap source;
+	InitTilemap(source, kMapSize);
+	generator.Generate(source, g_kBenchSeed);
+
+	// A 5x5 patch in the middle of the map, The size a path repair usually touches.
+	const int kCenter = (int)kMapSize / 2;
+	const TileRect kRegion = TileRect::FromTile(dragon::Vector2(kCenter, kCenter)).Expanded(2);
+
+	TDTilemap tilemap;
+	InitTilemap(tilemap, kMapSize);
+
+	size_t changedArea = 0;
+	while (state.KeepRunning())
+	{
+		state.PauseTiming();
+		CopyTilemap(source, tilemap);
+		state.ResumeTiming();
+
+		TileRect changed = generator.GrowRivers(tilemap, kRegion);
+		changedArea = changed.GetArea();
+		DoNotOptimize(tilemap.GetTileAtIndex(0));
+	}
+
+	state.SetCounter("changedArea", (double)changedArea);
+}
+PCG_BENCHMARK(MapGenerator_GrowRiversRegion)->ArgNames({ "mapSize" })->Args({ 32 })->Args({ (int64_t)g_kMapSize })->Args({ 64 })->Args({ 128 })->Args({ 256 });
+
+static void MapGenerator_GeneratePath(BenchmarkState& state)
+{
+	const int64_t kMapSize = state.GetArg(0);
+
+	BenchMapGenerator& generator = GetMapGenerator();
+
+	TDTilemap tilemap;
+	InitTilemap(tilemap, kMapSize);
+	generator.Generate(tilemap, g_kBenchSeed);
+
+	// Corner to center, The longest path a spawner can have to a centered base.
+	int from = tilemap.IndexFromPosition(dragon::Vector2(0, 0));
+	int to = tilemap.IndexFromPosition(dragon::Vector2((int)kMapSize / 2, (int)kMapSize / 2));
+
+	size_t pathLength = 0;
+	while (state.KeepRunning())
+	{
+		// Keep searching the tiles, The hierarchy has benchmarks of its own.
+		generator.m_pathSearchCount = 0;
+
+		TilePath path = generator.GeneratePath(tilemap, from, to);
+		pathLength = path.size();
+		DoNotOptimize(path.data());
+	}
+
+	state.SetCounter("pathLength", (double)pathLength);
+}
+PCG_BENCHMARK(MapGenerator_GeneratePath)->ArgNames({ "mapSize" })->Args({ 32 })->Args({ (int64_t)g_kMapSize })->Args({ 64 })->Args({ 128 });
+
+static void MapGenerator_GenerateWithPaths(BenchmarkState& state)
+{
+	const int64_t kMapSize = state.GetArg(0);
+	const bool kUseHierarchy = state.GetArg(1) != 0;
+	const int kLast = (int)kMapSize - 1;
+
+	BenchMapGenerator& generator = GetMapGenerator();
+
+	TDTilemap tilemap;
+	InitTilemap(tilemap, kMapSize);
+
+	// Same spawners and base as MazePlanner_PlaceTurret, The paths a round on this map carves.
+	dragon::Vector2 base((int)kMapSize / 2, (int)kMapSize / 2);
+	eastl::vector<dragon::Vector2> spawners =
+	{
+		dragon::Vector2(0, 0),
+		dragon::Vector2(kLast, 0),
+		dragon::Vector2(0, kLast),
+		dragon::Vector2(kLast, kLast),
+		dragon::Vector2((int)kMapSize / 2, 0),
+	};
+
+	size_t pathLength = 0;
+	while (state.KeepRunning())
+	{
+		generator.Generate(tilemap, g_kBenchSeed);
+
+		// What Generate used to do for large maps, Every path then goes through the hierarchy.
+		if (kUseHierarchy)
+			generator.m_pathHierarchy.Build(tilemap);
+
+		pathLength = 0;
+		for (const dragon::Vector2& spawner : spawners)
+			pathLength += generator.CarvePath(tilemap, spawner, base).size();
+
+		DoNotOptimize(pathLength);
+	}
+
+	state.SetCounter("pathLength", (double)pathLength);
+	state.SetCounter("builtSectors", (double)generator.m_pathHierarchy.GetBuiltSectorCount());
+}
+PCG_BENCHMARK(MapGenerator_GenerateWithPaths)->ArgNames({ "mapSize", "hierarchy" })->ArgsProduct({ { 128, 256, 512, 1024 }, { 0, 1 } });
+
+static void PathHierarchy_Build(BenchmarkState& state)
+{
+	const int64_t kMapSize = state.GetArg(0);
+
+	TDTilemap tilemap;
+	InitTilemap(tilemap, kMapSize);
+	GetMapGenerator().Generate(tilemap, g_kBenchSeed);
+
+	PathHierarchy hierarchy;
+	while (state.KeepRunning())
+	{
+		hierarchy.Build(tilemap);
+		DoNotOptimize(hierarchy.GetEdgeCount());
+	}
+
+	// Build only finds the entrances, The sectors are searched by FindPath.
+
+	state.SetCounter("nodes", (double)hierarchy.GetNodeCount());
+	state.SetCounter("edges", (double)hierarchy.GetEdgeCount());
+}
+PCG_BENCHMARK(PathHierarchy_Build)->ArgNames({ "mapSize" })->Args({ 128 })->Args({ 256 })->Args({ 512 })->Args({ 1024 });
+
+static void PathHierarchy_FindPath(BenchmarkState& state)
+{
+	const int64_t kMapSize = state.GetArg(0);
+
+	TDTilemap tilemap;
+	InitTilemap(tilemap, kMapSize);
+	GetMapGenerator().Generate(tilemap, g_kBenchSeed);
+
+	PathHierarchy hierarchy;
+	hierarchy.Build(tilemap);
+
+	// Same path as MapGenerator_GeneratePath.
+	int from = tilemap.IndexFromPosition(dragon::Vector2(0, 0));
+	int to = tilemap.IndexFromPosition(dragon::Vector2((int)kMapSize / 2, (int)kMapSize / 2));
+
+	size_t pathLength = 0;
+	while (state.KeepRunning())
+	{
+		TilePath path = hierarchy.FindPath(from, to);
+		pathLength = path.size();
+		DoNotOptimize(path.data());
+	}
+
+	state.SetCounter("pathLength", (double)pathLength);
+	state.SetCounter("expansions", (double)hierarchy.GetExpansions());
+	state.SetCounter("builtSectors", (double)hierarchy.GetBuiltSectorCount());
+}
+PCG_BENCHMARK(PathHierarchy_FindPath)->ArgNames({ "mapSize" })->Args({ 128 })->Args({ 256 })->Args({ 512 })->Args({ 1024 });
+
+static void MazePlanner_PlaceTurret(BenchmarkState& state)
+{
+	const int64_t kMapSize = state.GetArg(0);
+	const int kLast = (int)kMapSize - 1;
+
+	BenchMapGenerator& generator = GetMapGenerator();
+
+	TDTilemap tilemap;
+	InitTilemap(tilemap, kMapSize);
+	generator.Generate(tilemap, g_kBenchSeed);
+
+	// Centered base, Spawners in the corners and halfway along the top.
+	int goal = tilemap.IndexFromPosition(dragon::Vector2((int)kMapSize / 2, (int)kMapSize / 2));
+	eastl::vector<int> starts =
+	{
+		tilemap.IndexFromPosition(dragon::Vector2(0, 0)),
+		tilemap.IndexFromPosition(dragon::Vector2(kLast, 0)),
+		tilemap.IndexFromPosition(dragon::Vector2(0, kLast)),
+		tilemap.IndexFromPosition(dragon::Vector2(kLast, kLast)),
+		tilemap.IndexFromPosition(dragon::Vector2((int)kMapSize / 2, 0)),
+	};
+
+	MazePlanner planner;
+	planner.Init(tilemap, goal, starts);
+	planner.ComputePaths();
+
+	// Block the first path halfway, Then open it up again. Both repairs are timed.
+	TilePath path = planner.GetTilePath(starts[0]);
+	int turretTile = path[path.size() / 2];
+
+	size_t expansions = 0;
+	while (state.KeepRunning())
+	{
+		planner.SetExtraCost(turretTile, g_kMazingTurretCost);
+		planner.ComputePaths();
+		expansions = planner.GetExpansions();
+
+		planner.SetExtraCost(turretTile, 0.0f);
+		planner.ComputePaths();
+		expansions += planner.GetExpansions();
+
+		DoNotOptimize(expansions);
+	}
+
+	state.SetCounter("expansions", (double)expansions);
+}
+PCG_BENCHMARK(MazePlanner_PlaceTurret)->ArgNames({ "mapSize" })->Args({ (int64_t)g_kMapSize })->Args({ 64 })->Args({ 128 })->Args({ 256 });
+
+static void MapGenerator_SelectBasePosition(BenchmarkState& state)
+{
+	const int64_t kMapSize = state.GetArg(0);
+
+	BenchMapGenerator& generator = GetMapGenerator();
+
+	TDTilemap tilemap;
+	InitTilemap(tilemap, kMapSize);
+	generator.Generate(tilemap, g_kBenchSeed);
+
+	dragon::Vector2 position;
+	while (state.KeepRunning())
+	{
+		position = generator.SelectBasePosition(tilemap);
+		DoNotOptimize(position);
+	}
+}
+PCG_BENCHMARK(MapGenerator_SelectBasePosition)->ArgNames({ "mapSize" })->Args({ 32 })->Args({ (int64_t)g_kMapSize })->Args({ 128 });
+
+static void MapGenerator_SelectSpawnerLocations(BenchmarkState& state)
+{
+	const int64_t kMapSize = state.GetArg(0);
+	const int64_t kSpawnerCount = state.GetArg(1);
+
+	BenchMapGenerator& generator = GetMapGenerator();
+
+	TDTilemap tilemap;
+	InitTilemap(tilemap, kMapSize);
+	generator.Generate(tilemap, g_kBenchSeed);
+
+	dragon::Vector2 base((int)kMapSize / 2, (int)kMapSize / 2);
+
+	MapGenerator::PossiblePositions positions;
+	while (state.KeepRunning())
+	{
+		generator.SelectSpawnerLocations(tilemap, base, (size_t)kSpawnerCount, positions);
+		DoNotOptimize(positions.data());
+	}
+
+	state.SetItemsProcessed((int64_t)state.GetIterations() * kMapSize * kMapSize);
+	state.SetCounter("positions", (double)positions.size());
+}
+PCG_BENCHMARK(MapGenerator_SelectSpawnerLocations)->ArgNames({ "mapSize", "spawners" })->ArgsProduct({ { 32, (int64_t)g_kMapSize, 64, 128, 256, 1024 }, { 1, 5 } });
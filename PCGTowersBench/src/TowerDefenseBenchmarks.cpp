@@ -0,0 +1,284 @@
+#include "Benchmark.h"
+
+#include <Config.h>
+
+#include <Game/TowerDefense/World.h>
+#include <Game/TowerDefense/Turret.h>
+#include <Game/TowerDefense/Enemy.h>
+#include <Game/TowerDefense/Spawner.h>
+#include <Game/Rounds/Round.h>
+#include <Game/Snapshot/SnapshotFormat.h>
+#include <Game/Training/VectorEnvironment.h>
+#include <Game/Replay/WorldRasterizer.h>
+#include <Game/Bots/GreedyBot.h>
+
+#include <Dragon/Generic/Random.h>
+
+static constexpr unsigned int g_kBenchSeed = 1337;
+
+/// <summary>
+/// Enemies that survive anything the turrets throw at them, So the amount of enemies stays constant.
+/// </summary>
+static constexpr float g_kImmortalHealth = 1e30f;
+
+static void Turret_FindTarget(BenchmarkState& state)
+{
+	const int64_t kMapSize = state.GetArg(0);
+	const int64_t kEnemyCount = state.GetArg(1);
+	const TargetingMode kMode = (TargetingMode)state.GetArg(2);
+
+	const float kWorldSize = (float)kMapSize * g_kTileSize;
+
+	dragon::Random random(g_kBenchSeed);
+
+	// A path winding over every fourth row of the map, Through the tile centroids like the generated paths.
+	Path path;
+	for (int64_t y = 0; y < kMapSize; y += 4)
+	{
+		for (int64_t i = 0; i < kMapSize; ++i)
+		{
+			int64_t x = (y / 4) % 2 == 0 ? i : kMapSize - 1 - i;
+			path.emplace_back((float)x * g_kTileSize + (g_kTileSize / 2.0f), (float)y * g_kTileSize + (g_kTileSize / 2.0f));
+		}
+	}
+
+	// Every enemy stands still at a random place along the path.
+	EnemyRegistry registry;
+	eastl::vector<Enemy*> enemies;
+	enemies.reserve((size_t)kEnemyCount);
+
+	for (int64_t i = 0; i < kEnemyCount; ++i)
+	{
+		uint32_t nextTile = 1 + (uint32_t)(random.RandomUniform() * (float)(path.size() - 2));
+		dragon::Vector2f from = path[nextTile - 1];
+		dragon::Vector2f to = path[nextTile];
+		float t = random.RandomUniform();
+
+		EnemyRecord record = {};
+		record.m_x = from.x + (to.x - from.x) * t;
+		record.m_y = from.y + (to.y - from.y) * t;
+		record.m_health = g_kImmortalHealth;
+		record.m_maxHealth = g_kImmortalHealth;
+		record.m_nextTile = nextTile;
+
+		Enemy* pEnemy = new Enemy();
+		pEnemy->Load(record, &path);
+		registry.Register(pEnemy);
+		enemies.push_back(pEnemy);
+	}
+
+	PathTracker tracker;
+	tracker.AddPath(path);
+	tracker.Update(enemies);
+
+	EnemySnapshot snapshot;
+	snapshot.Build(enemies);
+
+	Turret turret;
+	turret.SetPosition({ kWorldSize / 2.0f, kWorldSize / 2.0f });
+	turret.SetRange(100.0f);
+	turret.SetTargetingMode(kMode);
+
+	PathCoverage coverage;
+	tracker.ComputeCoverage(turret.GetPosition(), turret.GetRange(), coverage);
+	turret.SetCoverage(eastl::move(coverage));
+
+	TargetingStats stats;
+	bool hasTarget = false;
+	while (state.KeepRunning())
+	{
+		turret.ClearTarget();
+		turret.FindTarget(tracker, snapshot, g_kFixedTimeStep, &stats);
+		hasTarget = turret.HasTarget();
+		DoNotOptimize(hasTarget);
+	}
+
+	state.SetItemsProcessed((int64_t)state.GetIterations() * kEnemyCount);
+	state.SetCounter("intervals", (double)turret.GetCoverage().size());
+	state.SetCounter("distanceTests", state.GetIterations() > 0 ? (double)stats.m_distanceTests / (double)state.GetIterations() : 0.0);
+
+	for (Enemy* pEnemy : enemies)
+		delete pEnemy;
+}
+PCG_BENCHMARK(Turret_FindTarget)->ArgNames({ "mapSize", "enemies", "mode" })->ArgsProduct({ { (int64_t)g_kMapSize, 128 }, { 16, 256, 4096 }, { (int64_t)TargetingMode::kClosest, (int64_t)TargetingMode::kFirst } });
+
+static void World_Update(BenchmarkState& state)
+{
+	const int64_t kEnemyCount = state.GetArg(0);
+	const int64_t kTurretCount = state.GetArg(1);
+	const int64_t kThreadCount = state.GetArg(2);
+
+	World world;
+	world.Init(true);
+	world.SetTurretThreadCount((unsigned int)kThreadCount);
+	world.GenerateWorld(g_kBenchSeed);
+
+	const Round* pRound = world.GetCurrentRound();
+	const Round::Spawners& spawners = pRound->GetSpawners();
+
+	// Spread the enemies over the paths of all spawners.
+	for (int64_t i = 0; i < kEnemyCount; ++i)
+	{
+		const Spawner& spawner = spawners[(size_t)i % spawners.size()];
+
+		Enemy* pEnemy = new Enemy();
+		Enemy::Stats stats;
+		stats.m_speed = 1.0f + (float)(i % 8);
+		stats.m_maxHealth = g_kImmortalHealth;
+		pEnemy->SetStats(stats);
+		pEnemy->SetPath(&spawner.GetPath());
+		world.AddEnemy(pEnemy);
+	}
+
+	// Buy turrets on the first placeable tiles.
+	world.ApplyAction(PlayerAction(PlayerActionType::kGiveGold, 0));
+	const uint32_t kTileCount = (uint32_t)(g_kMapSize * g_kMapSize);
+	for (uint32_t tile = 0; tile < kTileCount && (int64_t)world.GetTurretCount() < kTurretCount; ++tile)
+	{
+		if (world.GetPlayerGold() < g_kTurretCost)
+			world.ApplyAction(PlayerAction(PlayerActionType::kGiveGold, 0));
+
+		world.ApplyAction(PlayerAction(PlayerActionType::kBuyTurret, tile));
+	}
+
+	while (state.KeepRunning())
+	{
+		world.Update(g_kFixedTimeStep);
+	}
+
+	state.SetItemsProcessed((int64_t)state.GetIterations());
+	state.SetCounter("spawners", (double)spawners.size());
+	state.SetCounter("turrets", (double)world.GetTurretCount());
+
+	// Enemies that reach the base are removed, Long runs end up with fewer than they started with.
+	state.SetCounter("liveEnemies", world.GetMetrics().Get(Metric::kEnemies));
+	state.SetCounter("awakeTurrets", world.GetMetrics().Get(Metric::kAwakeTurrets));
+	state.SetCounter("sleepingTurrets", world.GetMetrics().Get(Metric::kSleepingTurrets));
+}
+PCG_BENCHMARK(World_Update)->ArgNames({ "enemies", "turrets", "threads" })->ArgsProduct({ { 0, 64, 512, 2048 }, { 0, 16, 64 }, { 1 } })->Args({ 2048, 1024, 1 })->Args({ 2048, 1024, 0 });
+
+static void VectorEnvironment_Step(BenchmarkState& state)
+{
+	const size_t kEnvironmentCount = (size_t)state.GetArg(0);
+	const size_t kThreadCount = (size_t)state.GetArg(1);
+	const size_t kTileCount = VectorEnvironment::kTileCount;
+
+	eastl::vector<uint8_t> tiles(kEnvironmentCount * VectorEnvironment::kTileChannelCount * kTileCount);
+	eastl::vector<float> enemies(kEnvironmentCount * kTileCount);
+	eastl::vector<float> scalars(kEnvironmentCount * VectorEnvironment::kScalarChannelCount);
+	eastl::vector<float> rewards(kEnvironmentCount);
+	eastl::vector<uint8_t> dones(kEnvironmentCount);
+
+	EnvironmentBuffers buffers;
+	buffers.m_pTiles = tiles.data();
+	buffers.m_pEnemies = enemies.data();
+	buffers.m_pScalars = scalars.data();
+	buffers.m_pRewards = rewards.data();
+	buffers.m_pDones = dones.data();
+
+	VectorEnvironment environment;
+	environment.Init(kEnvironmentCount, buffers, kThreadCount);
+
+	eastl::vector<uint32_t> seeds(kEnvironmentCount);
+	for (size_t i = 0; i < kEnvironmentCount; ++i)
+		seeds[i] = g_kBenchSeed + (uint32_t)i;
+	environment.Reset(seeds.data());
+
+	// Every environment keeps trying to build on the next tile, Most of those fail once the gold runs out.
+	eastl::vector<EnvironmentAction> actions(kEnvironmentCount);
+	uint32_t step = 0;
+	size_t resets = 0;
+
+	while (state.KeepRunning())
+	{
+		for (size_t i = 0; i < kEnvironmentCount; ++i)
+			actions[i] = EnvironmentAction(EnvironmentActionType::kBuy, (uint32_t)((step * 7 + i * 13) % kTileCount));
+
+		environment.Step(actions.data());
+		++step;
+
+		state.PauseTiming();
+		for (size_t i = 0; i < kEnvironmentCount; ++i)
+		{
+			if (dones[i])
+			{
+				environment.Reset(i, seeds[i] + step);
+				++resets;
+			}
+		}
+		state.ResumeTiming();
+	}
+
+	state.SetItemsProcessed((int64_t)state.GetIterations() * (int64_t)kEnvironmentCount);
+	state.SetCounter("resets", (double)resets);
+}
+PCG_BENCHMARK(VectorEnvironment_Step)->ArgNames({ "environments", "threads" })->ArgsProduct({ { 1, 64, 512 }, { 1 } })->Args({ 512, 0 });
+
+static void WorldRasterizer_Rasterize(BenchmarkState& state)
+{
+	const int64_t kEnemyCount = state.GetArg(0);
+	const uint32_t kScale = (uint32_t)state.GetArg(1);
+
+	World world;
+	world.Init(true);
+	world.GenerateWorld(g_kBenchSeed);
+
+	const Round::Spawners& spawners = world.GetCurrentRound()->GetSpawners();
+	for (int64_t i = 0; i < kEnemyCount; ++i)
+	{
+		Enemy* pEnemy = new Enemy();
+		Enemy::Stats stats;
+		stats.m_speed = 1.0f + (float)(i % 8);
+		stats.m_maxHealth = g_kImmortalHealth;
+		pEnemy->SetStats(stats);
+		pEnemy->SetPath(&spawners[(size_t)i % spawners.size()].GetPath());
+		world.AddEnemy(pEnemy);
+	}
+
+	// Spread the enemies out along their paths.
+	for (int tick = 0; tick < 120; ++tick)
+		world.Tick();
+
+	world.ApplyAction(PlayerAction(PlayerActionType::kGiveGold, 0));
+	for (uint32_t tile = 0; tile < (uint32_t)(g_kMapSize * g_kMapSize); tile += 7)
+		world.ApplyAction(PlayerAction(PlayerActionType::kBuyTurret, tile));
+
+	WorldRasterizer rasterizer;
+	rasterizer.SetScale(kScale);
+
+	while (state.KeepRunning())
+	{
+		rasterizer.Rasterize(world);
+	}
+
+	state.SetItemsProcessed((int64_t)state.GetIterations());
+	state.SetCounter("cells", (double)rasterizer.GetCellCount());
+	state.SetCounter("turrets", (double)world.GetTurretCount());
+}
+PCG_BENCHMARK(WorldRasterizer_Rasterize)->ArgNames({ "enemies", "scale" })->ArgsProduct({ { 0, 512 }, { 1, 3 } });
+
+static void World_TickWithBot(BenchmarkState& state)
+{
+	const int64_t kWarmupSeconds = state.GetArg(0);
+
+	World world;
+	world.Init(true);
+	world.SetBot(eastl::unique_ptr<PlayerBot>(new GreedyBot()));
+	world.GenerateWorld(g_kBenchSeed);
+
+	// Let the bot build up its defence first, The same seed always ends up with the same board.
+	const uint32_t kWarmupTicks = (uint32_t)((float)kWarmupSeconds / g_kFixedTimeStep);
+	for (uint32_t tick = 0; tick < kWarmupTicks; ++tick)
+		world.Tick();
+
+	while (state.KeepRunning())
+	{
+		world.Tick();
+	}
+
+	state.SetItemsProcessed((int64_t)state.GetIterations());
+	state.SetCounter("turrets", (double)world.GetTurretCount());
+	state.SetCounter("rounds", (double)world.GetRoundCount());
+	state.SetCounter("liveEnemies", world.GetMetrics().Get(Metric::kEnemies));
+}
+PCG_BENCHMARK(World_TickWithBot)->ArgNames({ "warmupSeconds" })->ArgsProduct({ { 0, 60, 300 } });
@@ -0,0 +1,65 @@
+#include "Benchmark.h"
+
+#include <Game/Generators/WaveGenerator.h>
+#include <Game/Generators/CounterRandom.h>
+#include <Game/TowerDefense/Spawner.h>
+#include <Game/WeightedGrammarSystem.h>
+
+static constexpr unsigned int g_kBenchSeed = 1337;
+
+static void WeightedGrammarSystem_RunGrammar(BenchmarkState& state)
+{
+	const int64_t kSpawnerCount = state.GetArg(0);
+
+	WaveGenerator generator;
+	generator.InitDefaults();
+
+	WeightedGrammarSystem& grammar = generator.GetGrammarSystem();
+
+	size_t nodes = 0;
+	while (state.KeepRunning())
+	{
+		// One grammar per spawner, Seeded the same way the wave generator does.
+		for (int64_t i = 0; i < kSpawnerCount; ++i)
+		{
+			grammar.SetSeed(CounterRandom::Draw(g_kBenchSeed, RandomStream::kGrammar, (unsigned int)i));
+			WeightedGrammarSystem::RuleNode* pRoot = grammar.RunGrammar('S');
+			nodes = pRoot->m_children.size();
+			DoNotOptimize(pRoot);
+		}
+	}
+
+	state.SetItemsProcessed((int64_t)state.GetIterations() * kSpawnerCount);
+	state.SetCounter("rootChildren", (double)nodes);
+}
+PCG_BENCHMARK(WeightedGrammarSystem_RunGrammar)->ArgNames({ "spawners" })->Args({ 1 })->Args({ 5 })->Args({ 32 });
+
+static void WaveGenerator_GenerateWaves(BenchmarkState& state)
+{
+	const int64_t kSpawnerCount = state.GetArg(0);
+
+	WaveGenerator generator;
+	generator.InitDefaults();
+
+	eastl::vector<Spawner> spawners;
+	spawners.reserve((size_t)kSpawnerCount);
+	for (int64_t i = 0; i < kSpawnerCount; ++i)
+		spawners.emplace_back(nullptr, dragon::Vector2(0, 0), Spawner::Path());
+
+	unsigned int wave = 0;
+	size_t groups = 0;
+	while (state.KeepRunning())
+	{
+		state.PauseTiming();
+		for (Spawner& spawner : spawners)
+			spawner.ClearEnemyGroups();
+		state.ResumeTiming();
+
+		generator.GenerateWaves(spawners, g_kBenchSeed, wave++);
+		groups = spawners[0].GetGroups().size();
+	}
+
+	state.SetItemsProcessed((int64_t)state.GetIterations() * kSpawnerCount);
+	state.SetCounter("groupsPerSpawner", (double)groups);
+}
+PCG_BENCHMARK(WaveGenerator_GenerateWaves)->ArgNames({ "spawners" })->Args({ 1 })->Args({ 5 })->Args({ 32 })->Args({ 256 });
@@ -2,10 +2,20 @@ include "../../tools/dragoncore.lua"
 
 print("[PCGTowers] Building PCGTowers Project Files!")
 
+newoption
+{
+    trigger = "profiling",
+    description = "Compiles the profiling zones into release builds (Always on in debug)."
+}
+
 workspace "PCGTowers"
 
     startproject "PCGTowers"
     dragon_workspace_defaults()
+
+    filter "options:profiling"
+        defines { "PCG_PROFILING" }
+    filter {}
     
 project "PCGTowers"
 
@@ -27,3 +37,36 @@ project "PCGTowers"
 
     include_dragoncore("../../")
     links { "DragonCore" }
+
+-- Micro benchmarks, Builds the game sources (minus its entry point) together with the benchmarks.
+project "PCGTowersBench"
+
+    dragon_project_defaults()
+
+    location "%{prj.name}"
+    kind "ConsoleApp"
+
+    -- The generators load their assets relative to the working directory.
+    debugdir "PCGTowers"
+
+    files 
+    {
+        "PCGTowers/src/**.h",
+        "PCGTowers/src/**.cpp",
+        "%{prj.name}/src/**.h",
+        "%{prj.name}/src/**.cpp"
+    }
+
+    removefiles
+    {
+        "PCGTowers/src/Main.cpp"
+    }
+
+    includedirs 
+    { 
+        "PCGTowers/src",
+        "%{prj.name}/src",
+    }
+
+    include_dragoncore("../../")
+    links { "DragonCore" }